@@ -0,0 +1,262 @@
+/*
+   Copyright (c) 2015-2018 Maikel Diaz <ariguanabosoft@gmail.com>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+
+// Rotates and skews a large image through kpPixmapFX, the way the rotate
+// and skew commands do, and through a QPainter with the same matrix, the
+// way kpPixmapFX did before it sampled the source itself.  Then scales it
+// through kpPixmapFX and through QImage::scaled().  Prints how long each
+// takes and how many pixels they disagree on.
+
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QMatrix>
+#include <QPainter>
+#include <QStringList>
+
+#include <kpColor.h>
+#include <kpPixmapFX.h>
+
+
+// Returns an image with every pixel different from its neighbours, so
+// that dropped or shifted pixels show up when comparing.
+static QImage PatternImage (int width, int height)
+{
+    QImage image (width, height, QImage::Format_ARGB32_Premultiplied);
+
+    quint32 seed = 1;
+    for (int y = 0; y < height; y++)
+    {
+        QRgb *line = reinterpret_cast <QRgb *> (image.scanLine (y));
+        for (int x = 0; x < width; x++)
+        {
+            seed = seed * 1103515245 + 12345;
+            line [x] = qPremultiply (seed);
+        }
+    }
+
+    return image;
+}
+
+//---------------------------------------------------------------------
+
+// An attempt to reverse tiny rounding errors introduced by
+// QImage::trueMatrix(), as kpPixmapFX used to.
+static double TrueMatrixFixInts (double x)
+{
+    if (fabs (x - qRound (x)) < 0.000001)
+        return qRound (x);
+    else
+        return x;
+}
+
+//---------------------------------------------------------------------
+
+static QMatrix TrueMatrix (const QMatrix &matrix, int width, int height)
+{
+    const QMatrix truMat = QImage::trueMatrix (matrix, width, height);
+
+    return QMatrix (
+        ::TrueMatrixFixInts (truMat.m11 ()),
+        ::TrueMatrixFixInts (truMat.m12 ()),
+        ::TrueMatrixFixInts (truMat.m21 ()),
+        ::TrueMatrixFixInts (truMat.m22 ()),
+        ::TrueMatrixFixInts (truMat.dx ()),
+        ::TrueMatrixFixInts (truMat.dy ()));
+}
+
+//---------------------------------------------------------------------
+
+// The way kpPixmapFX used to transform <image>: drawing it through a
+// QPainter with <matrix>.
+static QImage DrawTransformedImage (const QImage &image, const QMatrix &matrix,
+        const kpColor &backgroundColor)
+{
+    const QRect newRect = matrix.mapRect (image.rect ());
+
+    QImage newImage (newRect.width (), newRect.height (),
+                     QImage::Format_ARGB32_Premultiplied);
+
+    QPainter p (&newImage);
+    {
+        // Make sure transparent pixels are drawn into the destination image.
+        p.setCompositionMode (QPainter::CompositionMode_Source);
+
+        if (backgroundColor.isValid ())
+            p.fillRect (newImage.rect (), backgroundColor.toQColor ());
+
+        p.setMatrix (::TrueMatrix (matrix, image.width (), image.height ()));
+        p.drawImage (QPoint (0, 0), image);
+    }
+    p.end ();
+
+    return newImage;
+}
+
+//---------------------------------------------------------------------
+
+// Returns how many pixels <a> and <b> differ in, or -1 if they are not the
+// same size.
+static qint64 DifferingPixels (const QImage &a, const QImage &b)
+{
+    if (a.size () != b.size ())
+        return -1;
+
+    qint64 ret = 0;
+    for (int y = 0; y < a.height (); y++)
+    {
+        const QRgb *lineA = reinterpret_cast <const QRgb *> (a.constScanLine (y));
+        const QRgb *lineB = reinterpret_cast <const QRgb *> (b.constScanLine (y));
+        for (int x = 0; x < a.width (); x++)
+        {
+            if (lineA [x] != lineB [x])
+                ret++;
+        }
+    }
+
+    return ret;
+}
+
+//---------------------------------------------------------------------
+
+// Times <iterations> runs of both ways of rotating (<hangle> and <vangle>
+// both 0) or skewing <image> and prints the results.
+static void Compare (const char *name, const QImage &image,
+        double angle, double hangle, double vangle, int iterations)
+{
+    const bool rotate = (hangle == 0 && vangle == 0);
+    const QMatrix matrix = rotate ?
+        kpPixmapFX::rotateMatrix (image, angle) :
+        kpPixmapFX::skewMatrix (image, hangle, vangle);
+    const kpColor backgroundColor = kpColor::White;
+
+    QImage nativeImage, painterImage;
+
+    QElapsedTimer timer;
+    timer.start ();
+    for (int i = 0; i < iterations; i++)
+    {
+        nativeImage = rotate ?
+            kpPixmapFX::rotate (image, angle, backgroundColor) :
+            kpPixmapFX::skew (image, hangle, vangle, backgroundColor);
+    }
+    const qint64 nativeMsec = timer.restart ();
+
+    for (int i = 0; i < iterations; i++)
+        painterImage = ::DrawTransformedImage (image, matrix, backgroundColor);
+    const qint64 painterMsec = timer.elapsed ();
+
+    printf ("%-14s kpPixmapFX: %8.2f ms  QPainter: %8.2f ms  "
+            "differing pixels: %lld\n",
+            name,
+            double (nativeMsec) / iterations,
+            double (painterMsec) / iterations,
+            (long long) ::DifferingPixels (nativeImage, painterImage));
+}
+
+//---------------------------------------------------------------------
+
+// Times <iterations> runs of scaling <image> to <width>x<height> with
+// <filter>, and with the closest QImage::scaled() mode, and prints the
+// results.
+static void CompareScale (const char *name, const QImage &image,
+        int width, int height, kpPixmapFX::ScaleFilter filter,
+        int iterations)
+{
+    const Qt::TransformationMode mode =
+        (filter == kpPixmapFX::NearestFilter) ? Qt::FastTransformation :
+                                                Qt::SmoothTransformation;
+
+    QImage nativeImage, qtImage;
+
+    QElapsedTimer timer;
+    timer.start ();
+    for (int i = 0; i < iterations; i++)
+        nativeImage = kpPixmapFX::scale (image, width, height, filter);
+    const qint64 nativeMsec = timer.restart ();
+
+    for (int i = 0; i < iterations; i++)
+        qtImage = image.scaled (width, height, Qt::IgnoreAspectRatio, mode);
+    const qint64 qtMsec = timer.elapsed ();
+
+    printf ("%-14s kpPixmapFX: %8.2f ms  QImage:   %8.2f ms  "
+            "differing pixels: %lld\n",
+            name,
+            double (nativeMsec) / iterations,
+            double (qtMsec) / iterations,
+            (long long) ::DifferingPixels (nativeImage, qtImage));
+}
+
+
+int main (int argc, char *argv [])
+{
+    QCoreApplication app (argc, argv);
+
+    const QStringList args = app.arguments ();
+    const int width = (args.size () > 2) ? args [1].toInt () : 4000;
+    const int height = (args.size () > 2) ? args [2].toInt () : 3000;
+    const int iterations = (args.size () > 3) ? args [3].toInt () : 5;
+
+    if (width <= 0 || height <= 0 || iterations <= 0)
+    {
+        fprintf (stderr, "usage: transforms [width height [iterations]]\n");
+        return EXIT_FAILURE;
+    }
+
+    const QImage image = ::PatternImage (width, height);
+
+    printf ("image %dx%d, %d iterations\n", width, height, iterations);
+
+    ::Compare ("rotate 30", image, 30, 0, 0, iterations);
+    ::Compare ("rotate 45", image, 45, 0, 0, iterations);
+    ::Compare ("rotate 90", image, 90, 0, 0, iterations);
+    ::Compare ("skew 45,0", image, 0, 45, 0, iterations);
+    ::Compare ("skew 20,10", image, 0, 20, 10, iterations);
+
+    const int halfWidth = qMax (1, width / 2), halfHeight = qMax (1, height / 2);
+    const int tenthWidth = qMax (1, width / 10), tenthHeight = qMax (1, height / 10);
+
+    ::CompareScale ("nearest 2x", image, width * 2, height * 2,
+                    kpPixmapFX::NearestFilter, iterations);
+    ::CompareScale ("bilinear 2x", image, width * 2, height * 2,
+                    kpPixmapFX::BilinearFilter, iterations);
+    ::CompareScale ("bilinear 1/2", image, halfWidth, halfHeight,
+                    kpPixmapFX::BilinearFilter, iterations);
+    ::CompareScale ("box 1/10", image, tenthWidth, tenthHeight,
+                    kpPixmapFX::BoxFilter, iterations);
+    ::CompareScale ("lanczos3 1/2", image, halfWidth, halfHeight,
+                    kpPixmapFX::Lanczos3Filter, iterations);
+
+    return EXIT_SUCCESS;
+}
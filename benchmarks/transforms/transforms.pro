@@ -0,0 +1,33 @@
+#-------------------------------------------------
+#
+# Times rotating and skewing a large image through kpPixmapFX, against
+# drawing it through a QPainter with the same matrix, the way
+# kpPixmapFX used to, and scaling it through kpPixmapFX, against
+# QImage::scaled().
+#
+#     qmake && make && ./transforms [width height [iterations]]
+#
+#-------------------------------------------------
+
+QT       += core gui concurrent
+
+TARGET = transforms
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+
+KP_ROOT = $$PWD/../..
+
+INCLUDEPATH += $$KP_ROOT \
+    $$KP_ROOT/commands \
+    $$KP_ROOT/generic \
+    $$KP_ROOT/imagelib \
+    $$KP_ROOT/layers/selections \
+    $$KP_ROOT/pixmapfx
+
+SOURCES += main.cpp \
+    $$KP_ROOT/generic/kpRowBands.cpp \
+    $$KP_ROOT/imagelib/kpColor.cpp \
+    $$KP_ROOT/imagelib/kpColor_Constants.cpp \
+    $$KP_ROOT/pixmapfx/kpPixmapFX_Scale.cpp \
+    $$KP_ROOT/pixmapfx/kpPixmapFX_Transforms.cpp
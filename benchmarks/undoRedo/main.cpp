@@ -0,0 +1,148 @@
+/*
+   Copyright (c) 2015-2018 Maikel Diaz <ariguanabosoft@gmail.com>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+// Undoes and redoes a command that changed a large region of a document,
+// the way the undo images of commands are put back, and prints how long
+// that takes through kpPixmapFX and through QPainter.
+
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QPainter>
+#include <QStringList>
+
+#include <kpPixmapFX.h>
+
+
+// Returns an image with every pixel different from its neighbours, so
+// nothing can be skipped.
+static QImage PatternImage (int width, int height, quint32 seed)
+{
+    QImage image (width, height, QImage::Format_ARGB32_Premultiplied);
+
+    for (int y = 0; y < height; y++)
+    {
+        QRgb *line = reinterpret_cast <QRgb *> (image.scanLine (y));
+        for (int x = 0; x < width; x++)
+        {
+            seed = seed * 1103515245 + 12345;
+            line [x] = qPremultiply (seed);
+        }
+    }
+
+    return image;
+}
+
+// Puts back <before> and <after> in turn, <iterations> times each, the
+// way undo and redo would.  Returns the milliseconds taken.
+static qint64 UndoRedo (QImage *doc, const QRect &rect,
+        const QImage &before, const QImage &after,
+        int iterations, bool usePainter)
+{
+    QElapsedTimer timer;
+    timer.start ();
+
+    for (int i = 0; i < iterations * 2; i++)
+    {
+        const QImage &image = (i % 2 == 0) ? before : after;
+
+        if (usePainter)
+        {
+            QPainter painter (doc);
+            painter.setCompositionMode (QPainter::CompositionMode_Source);
+            painter.drawImage (rect.topLeft (), image);
+        }
+        else
+        {
+            kpPixmapFX::setPixmapAt (doc, rect, image);
+        }
+    }
+
+    return timer.elapsed ();
+}
+
+
+int main (int argc, char *argv [])
+{
+    QCoreApplication app (argc, argv);
+
+    const QStringList args = app.arguments ();
+    const int width = (args.size () > 2) ? args [1].toInt () : 6000;
+    const int height = (args.size () > 2) ? args [2].toInt () : 4000;
+    const int iterations = (args.size () > 3) ? args [3].toInt () : 20;
+
+    if (width <= 0 || height <= 0 || iterations <= 0)
+    {
+        fprintf (stderr, "usage: undoRedo [width height [iterations]]\n");
+        return EXIT_FAILURE;
+    }
+
+    // A command that changed most of the document e.g. a big selection
+    // being deleted or an effect on it.
+    const QRect rect (width / 8, height / 8, width * 3 / 4, height * 3 / 4);
+
+    const QImage original = ::PatternImage (width, height, 1);
+
+    QElapsedTimer timer;
+    timer.start ();
+    const QImage before = kpPixmapFX::getPixmapAt (original, rect);
+    const qint64 getMsec = timer.elapsed ();
+
+    const QImage after = ::PatternImage (rect.width (), rect.height (), 2);
+
+    QImage nativeDoc = original;
+    const qint64 nativeMsec = ::UndoRedo (&nativeDoc, rect, before, after,
+                                          iterations, false/*kpPixmapFX*/);
+
+    QImage painterDoc = original;
+    const qint64 painterMsec = ::UndoRedo (&painterDoc, rect, before, after,
+                                           iterations, true/*QPainter*/);
+
+    const double megabytes =
+        double (rect.width ()) * rect.height () * 4 / (1024 * 1024);
+
+    printf ("document %dx%d, region %dx%d (%.1f MB), %d undo/redo pairs\n",
+            width, height, rect.width (), rect.height (), megabytes,
+            iterations);
+    printf ("getPixmapAt:       %lld ms\n", (long long) getMsec);
+    printf ("setPixmapAt:       %.2f ms per undo or redo\n",
+            double (nativeMsec) / (iterations * 2));
+    printf ("QPainter (Source): %.2f ms per undo or redo\n",
+            double (painterMsec) / (iterations * 2));
+
+    if (nativeDoc != painterDoc)
+    {
+        fprintf (stderr, "results differ\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
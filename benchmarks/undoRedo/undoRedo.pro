@@ -0,0 +1,28 @@
+#-------------------------------------------------
+#
+# Times undoing and redoing a large region of a document through
+# kpPixmapFX::getPixmapAt() and kpPixmapFX::setPixmapAt(), against
+# drawing the same region with a QPainter.
+#
+#     qmake && make && ./undoRedo [width height [iterations]]
+#
+#-------------------------------------------------
+
+QT       += core gui concurrent
+
+TARGET = undoRedo
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+
+KP_ROOT = $$PWD/../..
+
+INCLUDEPATH += $$KP_ROOT/generic \
+    $$KP_ROOT/imagelib \
+    $$KP_ROOT/pixmapfx
+
+SOURCES += main.cpp \
+    $$KP_ROOT/generic/kpRowBands.cpp \
+    $$KP_ROOT/imagelib/kpColor.cpp \
+    $$KP_ROOT/imagelib/kpColor_Constants.cpp \
+    $$KP_ROOT/pixmapfx/kpPixmapFX_GetSetPixmapParts.cpp
@@ -74,6 +74,15 @@ kpCommandSize::SizeType kpEffectClearCommand::size () const
     return ImageSize (m_oldImagePtr);
 }
 
+// public virtual [base kpCommand]
+QList <kpImage *> kpEffectClearCommand::storedImages ()
+{
+    QList <kpImage *> images;
+    if (m_oldImagePtr)
+        images.append (m_oldImagePtr);
+    return images;
+}
+
 
 // public virtual [base kpCommand]
 void kpEffectClearCommand::execute ()
@@ -51,6 +51,8 @@ public:
     virtual void execute ();
     virtual void unexecute ();
 
+    virtual QList <kpImage *> storedImages ();
+
 private:
     bool m_actOnSelection;
 
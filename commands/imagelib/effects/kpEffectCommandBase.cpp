@@ -37,21 +37,28 @@
 #include <kpDefs.h>
 #include <kpDocument.h>
 #include <kpSetOverrideCursorSaver.h>
+#include <kpUndoImage.h>
 
 
 struct kpEffectCommandBasePrivate
 {
+    kpEffectCommandBasePrivate (const kpCommand *command,
+                                kpCommandEnvironment *environ)
+        : oldImage (command, environ)
+    {
+    }
+
     QString name;
     bool actOnSelection;
 
-    kpImage oldImage;
+    kpUndoImage oldImage;
 };
 
 kpEffectCommandBase::kpEffectCommandBase (const QString &name,
         bool actOnSelection,
         kpCommandEnvironment *environ)
     : kpCommand (environ),
-      d (new kpEffectCommandBasePrivate ())
+      d (new kpEffectCommandBasePrivate (this, environ))
 {
     d->name = name;
     d->actOnSelection = actOnSelection;
@@ -76,7 +83,13 @@ QString kpEffectCommandBase::name () const
 // public virtual [base kpCommand]
 kpCommandSize::SizeType kpEffectCommandBase::size () const
 {
-    return ImageSize (d->oldImage);
+    return d->oldImage.size ();
+}
+
+// public virtual [base kpCommand]
+QList <kpImage *> kpEffectCommandBase::storedImages ()
+{
+    return QList <kpImage *> () << d->oldImage.storedImage ();
 }
 
 
@@ -91,15 +104,16 @@ void kpEffectCommandBase::execute ()
 
     const kpImage oldImage = doc->image (d->actOnSelection);
 
-    if (!isInvertible ())
-    {
-        d->oldImage = oldImage;
-    }
-
-
     kpImage newImage = /*pure virtual*/applyEffect (oldImage);
 
     doc->setImage (d->actOnSelection, newImage);
+
+    if (!isInvertible ())
+    {
+        // Many effects only change some of the pixels, so this usually ends
+        // up as a much smaller delta against <newImage>.
+        d->oldImage.set (oldImage, newImage);
+    }
 }
 
 // public virtual [base kpCommand]
@@ -115,7 +129,9 @@ void kpEffectCommandBase::unexecute ()
 
     if (!isInvertible ())
     {
-        newImage = d->oldImage;
+        newImage = d->oldImage.oldImage (doc->image (d->actOnSelection));
+        if (newImage.isNull ())
+            return;
     }
     else
     {
@@ -125,6 +141,6 @@ void kpEffectCommandBase::unexecute ()
     doc->setImage (d->actOnSelection, newImage);
 
 
-    d->oldImage = kpImage ();
+    d->oldImage.clear ();
 }
 
@@ -51,6 +51,8 @@ public:
     virtual void execute ();
     virtual void unexecute ();
 
+    virtual QList <kpImage *> storedImages ();
+
 public:
     // Return true if applyEffect(applyEffect(image)) == image
     // to avoid storing the old image, saving memory.
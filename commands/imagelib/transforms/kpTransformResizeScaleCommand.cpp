@@ -74,6 +74,7 @@ kpTransformResizeScaleCommand::kpTransformResizeScaleCommand (bool actOnSelectio
     : kpCommand (environ),
       m_actOnSelection (actOnSelection),
       m_type (type),
+      m_smoothScaleFilter (kpPixmapFX::BilinearFilter),
       m_backgroundColor (environ->backgroundColor ()),
       m_oldSelectionPtr (0)
 {
@@ -145,6 +146,14 @@ kpCommandSize::SizeType kpTransformResizeScaleCommand::size () const
            SelectionSize (m_oldSelectionPtr);
 }
 
+// public virtual [base kpCommand]
+QList <kpImage *> kpTransformResizeScaleCommand::storedImages ()
+{
+    return QList <kpImage *> () << &m_oldImage
+                                << &m_oldRightImage
+                                << &m_oldBottomImage;
+}
+
 
 // public
 int kpTransformResizeScaleCommand::newWidth () const
@@ -190,6 +199,19 @@ void kpTransformResizeScaleCommand::resize (int width, int height)
 }
 
 
+// public
+kpPixmapFX::ScaleFilter kpTransformResizeScaleCommand::smoothScaleFilter () const
+{
+    return m_smoothScaleFilter;
+}
+
+// public
+void kpTransformResizeScaleCommand::setSmoothScaleFilter (kpPixmapFX::ScaleFilter filter)
+{
+    m_smoothScaleFilter = filter;
+}
+
+
 // public
 bool kpTransformResizeScaleCommand::scaleSelectionWithImage () const
 {
@@ -327,8 +349,9 @@ void kpTransformResizeScaleCommand::execute ()
         if (!m_isLosslessScale)
             m_oldImage = oldImage;
 
+        // (a lossless scale duplicates every pixel a whole number of times)
         kpImage newImage = kpPixmapFX::scale (oldImage, m_newWidth, m_newHeight,
-                                               m_type == SmoothScale);
+            m_type == SmoothScale ? m_smoothScaleFilter : kpPixmapFX::NearestFilter);
 
 
         if (!m_oldSelectionPtr && document ()->selection ())
@@ -447,8 +470,13 @@ void kpTransformResizeScaleCommand::unexecute ()
         if (!m_isLosslessScale)
             oldImage = m_oldImage;
         else
+        {
+            // Picking one pixel out of each block that execute() duplicated
+            // restores the old image exactly.
             oldImage = kpPixmapFX::scale (doc->image (m_actOnSelection),
-                                          m_oldWidth, m_oldHeight);
+                                          m_oldWidth, m_oldHeight,
+                                          kpPixmapFX::NearestFilter);
+        }
 
 
         if (m_actOnSelection)
@@ -39,6 +39,7 @@
 #include <kpColor.h>
 #include <kpCommand.h>
 #include <kpImage.h>
+#include <kpPixmapFX.h>
 
 
 class QSize;
@@ -76,6 +77,12 @@ public:
     QSize newSize () const;
     virtual void resize (int width, int height);
 
+public:
+    // The filter that SmoothScale blends pixels with
+    // (default: kpPixmapFX::BilinearFilter).
+    kpPixmapFX::ScaleFilter smoothScaleFilter () const;
+    void setSmoothScaleFilter (kpPixmapFX::ScaleFilter filter);
+
 public:
     bool scaleSelectionWithImage () const;
 
@@ -86,10 +93,13 @@ public:
     virtual void execute ();
     virtual void unexecute ();
 
+    virtual QList <kpImage *> storedImages ();
+
 protected:
     bool m_actOnSelection;
     int m_newWidth, m_newHeight;
     Type m_type;
+    kpPixmapFX::ScaleFilter m_smoothScaleFilter;
     bool m_isLosslessScale;
     bool m_scaleSelectionWithImage;
     kpColor m_backgroundColor;
@@ -88,6 +88,12 @@ kpCommandSize::SizeType kpTransformRotateCommand::size () const
            SelectionSize (m_oldSelectionPtr);
 }
 
+// public virtual [base kpCommand]
+QList <kpImage *> kpTransformRotateCommand::storedImages ()
+{
+    return QList <kpImage *> () << &m_oldImage;
+}
+
 
 // public virtual [base kpCommand]
 void kpTransformRotateCommand::execute ()
@@ -53,6 +53,8 @@ public:
     virtual void execute ();
     virtual void unexecute ();
 
+    virtual QList <kpImage *> storedImages ();
+
 private:
     bool m_actOnSelection;
     double m_angle;
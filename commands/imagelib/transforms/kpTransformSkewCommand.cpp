@@ -91,6 +91,12 @@ kpCommandSize::SizeType kpTransformSkewCommand::size () const
            SelectionSize (m_oldSelectionPtr);
 }
 
+// public virtual [base kpCommand]
+QList <kpImage *> kpTransformSkewCommand::storedImages ()
+{
+    return QList <kpImage *> () << &m_oldImage;
+}
+
 
 // public virtual [base kpCommand]
 void kpTransformSkewCommand::execute ()
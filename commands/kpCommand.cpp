@@ -45,6 +45,13 @@ kpCommand::~kpCommand ()
 }
 
 
+// public virtual
+QList <kpImage *> kpCommand::storedImages ()
+{
+    return QList <kpImage *> ();
+}
+
+
 kpCommandEnvironment *kpCommand::environ () const
 {
     return m_environ;
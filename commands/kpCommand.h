@@ -30,7 +30,10 @@
 #define kpCommand_H
 
 
+#include <qlist.h>
+
 #include <kpCommandSize.h>
+#include <kpImage.h>
 #undef environ  // macro on win32
 
 
@@ -71,6 +74,18 @@ public:
     virtual void execute () = 0;
     virtual void unexecute () = 0;
 
+    // Returns the images that you keep only to be able to execute() or
+    // unexecute() again e.g. the document image before an effect.
+    //
+    // While you are not the next command to undo or redo, the command
+    // history may compress these images, or even move them to disk, leaving
+    // null images in their place.  They are always put back before
+    // execute() or unexecute() is called.  So don't touch them in between.
+    //
+    // The default implementation returns no images, so that everything is
+    // kept in memory as is.
+    virtual QList <kpImage *> storedImages ();
+
 protected:
     kpCommandEnvironment *environ () const;
 
@@ -36,6 +36,7 @@
 #include <climits>
 
 #include <qdatetime.h>
+#include <qhash.h>
 #include <qlinkedlist.h>
 
 #include <qapplication.h>
@@ -48,33 +49,152 @@
 
 #include <kpCommand.h>
 #include <kpCommandEnvironment.h>
+#include <kpCommandImageStore.h>
 #include <kpDefs.h>
 #include <kpDocument.h>
 #include <kpMainWindow.h>
 #include <kpTool.h>
 
 
+// What a command in the history was last counted as using.
+struct kpCountedCommand
+{
+    kpCommand *command;
+
+    // Memory used other than by the images below.
+    kpCommandSize::SizeType otherMemorySize;
+    // What trimming the history of this command would free, roughly: when
+    // commands share an image, it is all put down to the first one counted.
+    kpCommandSize::SizeType memorySize;
+    kpCommandSize::SizeType diskSize;
+
+    // QImage::cacheKey()s of the images it was counted with.
+    QList <qint64> imageKeys;
+};
+
+// An image held by counted commands.  Implicitly shared copies of an image
+// have the same QImage::cacheKey().
+struct kpCountedImage
+{
+    int refCount;
+    kpCommandSize::SizeType size;
+};
+
+struct kpCommandHistoryBasePrivate
+{
+    kpCommandImageStore *imageStore;
+
+    QHash <const kpCommand *, kpCountedCommand> countedCommands;
+    QHash <qint64, kpCountedImage> countedImages;
+
+    // Running totals, with each image only counted once.
+    kpCommandSize::SizeType memorySize, diskSize;
+};
+
+
+static void UncountCommand (kpCommandHistoryBasePrivate *d,
+                            const kpCommand *command)
+{
+    if (!d->countedCommands.contains (command))
+        return;
+
+    const kpCountedCommand counted = d->countedCommands.take (command);
+
+    d->memorySize -= counted.otherMemorySize;
+    d->diskSize -= counted.diskSize;
+
+    foreach (qint64 key, counted.imageKeys)
+    {
+        kpCountedImage &image = d->countedImages [key];
+        if (--image.refCount == 0)
+        {
+            d->memorySize -= image.size;
+            d->countedImages.remove (key);
+        }
+    }
+}
+
+// (Re)counts the memory and disk space used by <command>, as of now.
+static void CountCommand (kpCommandHistoryBasePrivate *d, kpCommand *command)
+{
+    ::UncountCommand (d, command);
+
+    kpCountedCommand counted;
+    counted.command = command;
+    counted.otherMemorySize = d->imageStore->memorySize (command);
+    counted.diskSize = d->imageStore->diskSize (command);
+
+    kpCommandSize::SizeType ownImagesSize = 0;
+
+    if (d->imageStore->countsImages (command))
+    {
+        foreach (const kpImage *image, command->storedImages ())
+        {
+            if (image->isNull ())
+                continue;
+
+            const kpCommandSize::SizeType size = kpCommandSize::ImageSize (*image);
+            counted.otherMemorySize -= size;
+
+            const qint64 key = image->cacheKey ();
+            if (!d->countedImages.contains (key))
+            {
+                kpCountedImage countedImage;
+                countedImage.refCount = 0;
+                countedImage.size = size;
+                d->countedImages.insert (key, countedImage);
+
+                d->memorySize += size;
+                ownImagesSize += size;
+            }
+
+            d->countedImages [key].refCount++;
+            counted.imageKeys.append (key);
+        }
+
+        // (size() might estimate images differently)
+        counted.otherMemorySize = qMax (kpCommandSize::SizeType (0),
+                                        counted.otherMemorySize);
+    }
+
+    counted.memorySize = counted.otherMemorySize + ownImagesSize;
+
+    d->countedCommands.insert (command, counted);
+
+    d->memorySize += counted.otherMemorySize;
+    d->diskSize += counted.diskSize;
+}
+
+
 //template <typename T>
-static void ClearPointerList (QLinkedList <kpCommand *> *listPtr)
+static void ClearPointerList (QLinkedList <kpCommand *> *listPtr,
+                              kpCommandHistoryBasePrivate *d)
 {
     if (!listPtr)
         return;
 
+    foreach (kpCommand *command, *listPtr)
+    {
+        ::UncountCommand (d, command);
+        d->imageStore->forget (command);
+    }
+
     qDeleteAll (listPtr->begin (), listPtr->end ());
 
     listPtr->clear ();
 }
 
 
-struct kpCommandHistoryBasePrivate
-{
-};
-
-
 kpCommandHistoryBase::kpCommandHistoryBase (bool doReadConfig,
                                             KActionCollection *ac)
     : d (new kpCommandHistoryBasePrivate ())
 {
+    d->imageStore = new kpCommandImageStore (this);
+    connect (d->imageStore, SIGNAL (sizeChanged (const kpCommand *)),
+             this, SLOT (slotImageStoreSizeChanged (const kpCommand *)));
+
+    d->memorySize = d->diskSize = 0;
+
     m_actionUndo = new QAction (QIcon (":/edit-undo"), undoActionText (), this);
     ac->addAction ("edit_undo", m_actionUndo);
     m_actionUndo->setShortcuts (QKeySequence::Undo);
@@ -114,6 +234,11 @@ kpCommandHistoryBase::kpCommandHistoryBase (bool doReadConfig,
     m_undoMinLimit = 10;
     m_undoMaxLimit = 500;
     m_undoMaxLimitSizeLimit = 16 * 1048576;
+    m_undoMaxLimitDiskLimit = 1024 * 1048576;
+
+    // Leave room in the memory limit for the commands whose images are not
+    // stored.
+    d->imageStore->setMemoryBudget (m_undoMaxLimitSizeLimit / 2);
 
 
     m_documentRestoredPosition = 0;
@@ -125,8 +250,8 @@ kpCommandHistoryBase::kpCommandHistoryBase (bool doReadConfig,
 
 kpCommandHistoryBase::~kpCommandHistoryBase ()
 {
-    ::ClearPointerList (&m_undoCommandList);
-    ::ClearPointerList (&m_redoCommandList);
+    ::ClearPointerList (&m_undoCommandList, d);
+    ::ClearPointerList (&m_redoCommandList, d);
 
     //m_actionUndo->menu()->disconnect(this);
     //m_actionRedo->menu()->disconnect(this);
@@ -241,6 +366,39 @@ void kpCommandHistoryBase::setUndoMaxLimitSizeLimit (kpCommandSize::SizeType siz
         return;
 
     m_undoMaxLimitSizeLimit = sizeLimit;
+    d->imageStore->setMemoryBudget (m_undoMaxLimitSizeLimit / 2);
+    trimCommandListsUpdateActions ();
+}
+
+
+// public
+kpCommandSize::SizeType kpCommandHistoryBase::undoMaxLimitDiskLimit () const
+{
+    return m_undoMaxLimitDiskLimit;
+}
+
+// public
+void kpCommandHistoryBase::setUndoMaxLimitDiskLimit (kpCommandSize::SizeType diskLimit)
+{
+#if DEBUG_KP_COMMAND_HISTORY
+    kDebug () << "kpCommandHistoryBase::setUndoMaxLimitDiskLimit("
+               << diskLimit << ")"
+               << endl;
+#endif
+
+    if (diskLimit < 0 ||
+        diskLimit > (kpCommandSize::SizeType (64) * 1073741824)/*"ought to be enough for anybody"*/)
+    {
+        qCritical () << "kpCommandHistoryBase::setUndoMaxLimitDiskLimit("
+                   << diskLimit << ")"
+                   << endl;
+        return;
+    }
+
+    if (diskLimit == m_undoMaxLimitDiskLimit)
+        return;
+
+    m_undoMaxLimitDiskLimit = diskLimit;
     trimCommandListsUpdateActions ();
 }
 
@@ -293,7 +451,9 @@ void kpCommandHistoryBase::addCommand (kpCommand *command, bool execute)
         command->execute ();
 
     m_undoCommandList.push_front (command);
-    ::ClearPointerList (&m_redoCommandList);
+    ::ClearPointerList (&m_redoCommandList, d);
+
+    ::CountCommand (d, command);
 
 #if DEBUG_KP_COMMAND_HISTORY
     kDebug () << "\tdocumentRestoredPosition=" << m_documentRestoredPosition
@@ -321,12 +481,14 @@ void kpCommandHistoryBase::clear ()
     kDebug () << "kpCommandHistoryBase::clear()";
 #endif
 
-    ::ClearPointerList (&m_undoCommandList);
-    ::ClearPointerList (&m_redoCommandList);
+    ::ClearPointerList (&m_undoCommandList, d);
+    ::ClearPointerList (&m_redoCommandList, d);
 
     m_documentRestoredPosition = 0;
 
     updateActions ();
+
+    emit memoryUsageChanged ();
 }
 
 //---------------------------------------------------------------------
@@ -342,7 +504,19 @@ void kpCommandHistoryBase::undoInternal ()
     if (!undoCommand)
         return;
 
+    if (!d->imageStore->restore (undoCommand))
+    {
+        // Can't go back any further.
+        ::ClearPointerList (&m_undoCommandList, d);
+
+        // The saved document might have been in the commands just lost.
+        if (m_documentRestoredPosition < 0)
+            m_documentRestoredPosition = INT_MAX;
+        return;
+    }
+
     undoCommand->unexecute ();
+    ::CountCommand (d, undoCommand);
 
 
     m_undoCommandList.erase (m_undoCommandList.begin ());
@@ -378,7 +552,19 @@ void kpCommandHistoryBase::redoInternal ()
     if (!redoCommand)
         return;
 
+    if (!d->imageStore->restore (redoCommand))
+    {
+        // Can't go forward any further.
+        ::ClearPointerList (&m_redoCommandList, d);
+
+        // The saved document might have been in the commands just lost.
+        if (m_documentRestoredPosition > 0)
+            m_documentRestoredPosition = INT_MAX;
+        return;
+    }
+
     redoCommand->execute ();
+    ::CountCommand (d, redoCommand);
 
 
     m_redoCommandList.erase (m_redoCommandList.begin ());
@@ -412,6 +598,10 @@ void kpCommandHistoryBase::undo ()
 
     undoInternal ();
     trimCommandListsUpdateActions ();
+
+    // The user is going back in history, so get the undo after next ready.
+    if (m_undoCommandList.size () >= 2)
+        d->imageStore->prefetch (*(++m_undoCommandList.begin ()));
 }
 
 //---------------------------------------------------------------------
@@ -425,6 +615,9 @@ void kpCommandHistoryBase::redo ()
 
     redoInternal ();
     trimCommandListsUpdateActions ();
+
+    if (m_redoCommandList.size () >= 2)
+        d->imageStore->prefetch (*(++m_redoCommandList.begin ()));
 }
 
 //---------------------------------------------------------------------
@@ -518,7 +711,10 @@ void kpCommandHistoryBase::trimCommandListsUpdateActions ()
 #endif
 
     trimCommandLists ();
+    storeCommandImages ();
     updateActions ();
+
+    emit memoryUsageChanged ();
 }
 
 // protected
@@ -561,16 +757,24 @@ void kpCommandHistoryBase::trimCommandList (QLinkedList <kpCommand *> *commandLi
     int upto = 0;
 
     kpCommandSize::SizeType sizeSoFar = 0;
+    kpCommandSize::SizeType diskSizeSoFar = 0;
 
     while (it != commandList->end ())
     {
         bool advanceIt = true;
 
-        if (sizeSoFar <= m_undoMaxLimitSizeLimit)
+        // The next command's images must be in memory anyway, so they don't
+        // count against the limit.  Older commands only count by what
+        // remains in memory after storing their images.
+        const kpCountedCommand counted = d->countedCommands.value (*it);
+
+        if (upto > 0 && sizeSoFar <= m_undoMaxLimitSizeLimit)
         {
-            sizeSoFar += (*it)->size ();
+            sizeSoFar += counted.memorySize;
         }
 
+        diskSizeSoFar += counted.diskSize;
+
     #if DEBUG_KP_COMMAND_HISTORY && 0
         kDebug () << "\t\t" << upto << ":"
                    << " name='" << (*it)->name ()
@@ -582,13 +786,16 @@ void kpCommandHistoryBase::trimCommandList (QLinkedList <kpCommand *> *commandLi
         if (upto >= m_undoMinLimit)
         {
             if (upto >= m_undoMaxLimit ||
-                sizeSoFar > m_undoMaxLimitSizeLimit)
+                sizeSoFar > m_undoMaxLimitSizeLimit ||
+                diskSizeSoFar > m_undoMaxLimitDiskLimit)
             {
             #if DEBUG_KP_COMMAND_HISTORY && 0
                 kDebug () << "\t\t\tkill";
             #endif
+                ::UncountCommand (d, *it);
+                d->imageStore->forget (*it);
                 delete (*it);
-                it = m_undoCommandList.erase (it);
+                it = commandList->erase (it);
                 advanceIt = false;
             }
         }
@@ -636,6 +843,37 @@ void kpCommandHistoryBase::trimCommandLists ()
 }
 
 
+// Keeps the images of the next commands to undo and redo in them, and
+// stores those of the others.
+static void StoreCommandImages (const QLinkedList <kpCommand *> &commandList,
+                                kpCommandImageStore *imageStore)
+{
+    int upto = 0;
+
+    foreach (kpCommand *command, commandList)
+    {
+        if (upto++ == 0)
+        {
+            // (if this fails, undoInternal()/redoInternal() find out)
+            imageStore->restore (command);
+        }
+        else
+            imageStore->store (command);
+    }
+}
+
+// protected
+void kpCommandHistoryBase::storeCommandImages ()
+{
+#if DEBUG_KP_COMMAND_HISTORY
+    kDebug () << "kpCommandHistoryBase::storeCommandImages()";
+#endif
+
+    ::StoreCommandImages (m_undoCommandList, d->imageStore);
+    ::StoreCommandImages (m_redoCommandList, d->imageStore);
+}
+
+
 static void populatePopupMenu (QMenu *popupMenu,
                                const QString &undoOrRedo,
                                const QLinkedList <kpCommand *> &commandList)
@@ -754,8 +992,11 @@ void kpCommandHistoryBase::setNextUndoCommand (kpCommand *command)
         return;
 
 
+    ::UncountCommand (d, *m_undoCommandList.begin ());
+    d->imageStore->forget (*m_undoCommandList.begin ());
     delete *m_undoCommandList.begin ();
     *m_undoCommandList.begin () = command;
+    ::CountCommand (d, command);
 
 
     trimCommandListsUpdateActions ();
@@ -772,3 +1013,46 @@ void kpCommandHistoryBase::documentSaved ()
     m_documentRestoredPosition = 0;
 }
 
+
+// public
+kpCommandSize::SizeType kpCommandHistoryBase::memorySize () const
+{
+    return d->memorySize;
+}
+
+// public
+kpCommandSize::SizeType kpCommandHistoryBase::diskSize () const
+{
+    return d->diskSize;
+}
+
+
+// public
+void kpCommandHistoryBase::commandSizeChanged (const kpCommand *command)
+{
+    if (d->countedCommands.contains (command))
+    {
+        ::CountCommand (d, d->countedCommands [command].command);
+    }
+    else
+    {
+        // Can't tell which command <command> is part of, if any.
+        foreach (const kpCountedCommand &counted, d->countedCommands.values ())
+            ::CountCommand (d, counted.command);
+    }
+
+    emit memoryUsageChanged ();
+}
+
+
+// private slot
+void kpCommandHistoryBase::slotImageStoreSizeChanged (const kpCommand *command)
+{
+    // Still in the history?
+    if (!d->countedCommands.contains (command))
+        return;
+
+    ::CountCommand (d, d->countedCommands [command].command);
+
+    emit memoryUsageChanged ();
+}
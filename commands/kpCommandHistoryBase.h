@@ -57,6 +57,8 @@ class kpViewManager;
 // could also be useful for other apps:
 // - nextUndoCommand()/nextRedoCommand()
 // - undo/redo history limited by both number and size
+// - images of commands, that are not about to be undone or redone, kept
+//   compressed and, beyond a memory budget, on disk (kpCommandImageStore)
 //
 // Features not required by KolourPaint (e.g. commandExecuted()) are not
 // implemented and undo limit == redo limit.  So compared to
@@ -84,6 +86,10 @@ public:
     kpCommandSize::SizeType undoMaxLimitSizeLimit () const;
     void setUndoMaxLimitSizeLimit (kpCommandSize::SizeType sizeLimit);
 
+    // How much of a temporary file the images of older commands may take.
+    kpCommandSize::SizeType undoMaxLimitDiskLimit () const;
+    void setUndoMaxLimitDiskLimit (kpCommandSize::SizeType diskLimit);
+
 public:
     // Read and write above config
     void readConfig ();
@@ -116,6 +122,7 @@ protected:
     void trimCommandListsUpdateActions ();
     void trimCommandList (QLinkedList <kpCommand *> *commandList);
     void trimCommandLists ();
+    void storeCommandImages ();
     void updateActions ();
 
 public:
@@ -127,9 +134,27 @@ public:
 public slots:
     virtual void documentSaved ();
 
+public:
+    // Memory and disk space used by all the commands, with image data
+    // shared between commands only counted once.  Kept up to date as
+    // commands come and go, or have their images stored.
+    kpCommandSize::SizeType memorySize () const;
+    kpCommandSize::SizeType diskSize () const;
+
+    // Call when the size() of <command> has changed since it was added.
+    // <command> may also be part of a command in the history (e.g. of a
+    // kpMacroCommand) or not be in the history yet.
+    void commandSizeChanged (const kpCommand *command);
+
+private slots:
+    void slotImageStoreSizeChanged (const kpCommand *command);
+
 signals:
     void documentRestored ();
 
+    // memorySize() or diskSize() might have changed.
+    void memoryUsageChanged ();
+
 protected:
 
     QAction *m_actionUndo, *m_actionRedo;
@@ -143,6 +168,7 @@ protected:
 
     int m_undoMinLimit, m_undoMaxLimit;
     kpCommandSize::SizeType m_undoMaxLimitSizeLimit;
+    kpCommandSize::SizeType m_undoMaxLimitDiskLimit;
 
     // What you have to do to get back to the document's unmodified state:
     // * -x: must Undo x times
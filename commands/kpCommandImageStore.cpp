@@ -0,0 +1,793 @@
+/*
+   Copyright (c) 2015-2018 Maikel Diaz <ariguanabosoft@gmail.com>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#define DEBUG_KP_COMMAND_IMAGE_STORE 0
+
+
+#include <kpCommandImageStore.h>
+
+#include <climits>
+
+#include <qbytearray.h>
+#include <qdir.h>
+#include <qfile.h>
+#include <QFutureWatcher>
+#include <qhash.h>
+#include <qlist.h>
+#include <qmap.h>
+#include <qtemporaryfile.h>
+#include <QtConcurrentRun>
+
+#include <qdebug.h>
+
+#include <kpCommand.h>
+
+
+// A stored image of a command.
+struct kpStoredImage
+{
+    // Where the image lives in the command.
+    kpImage *image;
+
+    QSize size;
+    QImage::Format format;
+    int bytesPerLine;
+
+    // Of the image that the data below was made from, or restored to.
+    qint64 cacheKey;
+
+    // The compressed image, while in memory...
+    QByteArray data;
+
+    // ... or where it is in the temporary file (offset -1 if not).
+    qint64 fileOffset;
+    int fileLength;
+};
+
+struct kpStoredCommand
+{
+    kpStoredCommand ()
+        : state (Hot),
+          compressWatcher (0),
+          prefetchWatcher (0)
+    {
+    }
+
+    enum State
+    {
+        // The images are in the command.
+        Hot,
+        // The images are in the command and being compressed.
+        Compressing,
+        // The images are only here.
+        Stored
+    } state;
+
+    QList <kpStoredImage> images;
+
+    QFutureWatcher <QList <QByteArray> > *compressWatcher;
+    QFutureWatcher <QList <kpImage> > *prefetchWatcher;
+};
+
+struct kpCommandImageStorePrivate
+{
+    kpCommandSize::SizeType memoryBudget;
+
+    QHash <const kpCommand *, kpStoredCommand *> commands;
+
+    // Commands with compressed images in memory, least recently
+    // stored first.
+    QList <const kpCommand *> memoryOrder;
+
+    kpCommandSize::SizeType memorySize, diskSize;
+
+    QTemporaryFile *file;
+    qint64 fileEnd;
+
+    // Ranges of the file, before fileEnd, that are no longer used: offset
+    // -> length.  Adjacent ranges are always merged.
+    QMap <qint64, qint64> freeRanges;
+};
+
+//---------------------------------------------------------------------
+
+// Compresses <images> -- which are implicitly shared copies of the
+// command's images -- on a worker thread.  An empty QByteArray means that
+// the image could not be compressed.
+static QList <QByteArray> CompressImages (const QList <kpImage> &images)
+{
+    QList <QByteArray> ret;
+
+    foreach (const kpImage &image, images)
+    {
+        const qint64 numBytes = qint64 (image.bytesPerLine ()) * image.height ();
+
+        // (qCompress() takes an int)
+        if (numBytes > INT_MAX)
+        {
+            ret.append (QByteArray ());
+            continue;
+        }
+
+        // Fastest compression: undo history is about speed, not ratio, and
+        // flat areas -- which most images have plenty of -- compress well
+        // anyway.
+        ret.append (qCompress (image.constBits (), int (numBytes), 1));
+    }
+
+    return ret;
+}
+
+//---------------------------------------------------------------------
+
+static void DeleteByteArray (void *byteArray)
+{
+    delete static_cast <QByteArray *> (byteArray);
+}
+
+//---------------------------------------------------------------------
+
+// Returns <stored> read back (if necessary) from <fileName> and
+// decompressed.  Called on both worker threads and the main thread.
+static kpImage LoadStoredImage (const kpStoredImage &stored,
+                                const QString &fileName)
+{
+    QByteArray data = stored.data;
+
+    if (stored.fileOffset >= 0)
+    {
+        // (own QFile, as this may run at the same time as spill() writes to
+        //  the file, on another thread)
+        QFile file (fileName);
+        if (!file.open (QIODevice::ReadOnly) || !file.seek (stored.fileOffset))
+            return kpImage ();
+
+        data = file.read (stored.fileLength);
+        if (data.size () != stored.fileLength)
+            return kpImage ();
+    }
+
+    QByteArray *bytes = new QByteArray (qUncompress (data));
+    if (qint64 (bytes->size ()) !=
+            qint64 (stored.bytesPerLine) * stored.size.height ())
+    {
+        delete bytes;
+        return kpImage ();
+    }
+
+    // Use the decompressed bytes as they are, instead of copying them into
+    // a new image.
+    return kpImage (reinterpret_cast <uchar *> (bytes->data ()),
+                    stored.size.width (), stored.size.height (),
+                    stored.bytesPerLine, stored.format,
+                    ::DeleteByteArray, bytes);
+}
+
+//---------------------------------------------------------------------
+
+static QList <kpImage> LoadStoredImages (const QList <kpStoredImage> &images,
+                                         const QString &fileName)
+{
+    QList <kpImage> ret;
+
+    foreach (const kpStoredImage &stored, images)
+        ret.append (::LoadStoredImage (stored, fileName));
+
+    return ret;
+}
+
+//---------------------------------------------------------------------
+
+kpCommandImageStore::kpCommandImageStore (QObject *parent)
+    : QObject (parent),
+      d (new kpCommandImageStorePrivate ())
+{
+    d->memoryBudget = 8 * 1048576;
+
+    d->memorySize = d->diskSize = 0;
+
+    d->file = 0;
+    d->fileEnd = 0;
+}
+
+//---------------------------------------------------------------------
+
+kpCommandImageStore::~kpCommandImageStore ()
+{
+    clear ();
+
+    delete d;
+}
+
+//---------------------------------------------------------------------
+
+// public
+kpCommandSize::SizeType kpCommandImageStore::memoryBudget () const
+{
+    return d->memoryBudget;
+}
+
+//---------------------------------------------------------------------
+
+// public
+void kpCommandImageStore::setMemoryBudget (kpCommandSize::SizeType budget)
+{
+    d->memoryBudget = budget;
+
+    spill ();
+}
+
+//---------------------------------------------------------------------
+
+// public
+kpCommandSize::SizeType kpCommandImageStore::memorySize (
+        const kpCommand *command) const
+{
+    const kpStoredCommand *stored = d->commands.value (command);
+
+    kpCommandSize::SizeType ret = 0;
+
+    // (once stored, size() no longer includes the released images;  while
+    //  being compressed, they are about to be released so don't count them)
+    if (!stored || stored->state != kpStoredCommand::Compressing)
+        ret += command->size ();
+
+    if (!stored)
+        return ret;
+
+    foreach (const kpStoredImage &image, stored->images)
+    {
+        ret += image.data.size ();
+
+        if (stored->prefetchWatcher)
+        {
+            ret += kpCommandSize::SizeType (image.bytesPerLine) *
+                   image.size.height ();
+        }
+    }
+
+    return ret;
+}
+
+//---------------------------------------------------------------------
+
+// public
+kpCommandSize::SizeType kpCommandImageStore::diskSize (
+        const kpCommand *command) const
+{
+    const kpStoredCommand *stored = d->commands.value (command);
+    if (!stored)
+        return 0;
+
+    kpCommandSize::SizeType ret = 0;
+
+    foreach (const kpStoredImage &image, stored->images)
+    {
+        if (image.fileOffset >= 0)
+            ret += image.fileLength;
+    }
+
+    return ret;
+}
+
+//---------------------------------------------------------------------
+
+// public
+kpCommandSize::SizeType kpCommandImageStore::memorySize () const
+{
+    return d->memorySize;
+}
+
+//---------------------------------------------------------------------
+
+// public
+kpCommandSize::SizeType kpCommandImageStore::diskSize () const
+{
+    return d->diskSize;
+}
+
+//---------------------------------------------------------------------
+
+// public
+bool kpCommandImageStore::isStored (const kpCommand *command) const
+{
+    const kpStoredCommand *stored = d->commands.value (command);
+
+    return (stored && stored->state == kpStoredCommand::Stored);
+}
+
+//---------------------------------------------------------------------
+
+// public
+bool kpCommandImageStore::countsImages (const kpCommand *command) const
+{
+    const kpStoredCommand *stored = d->commands.value (command);
+
+    return (!stored || stored->state == kpStoredCommand::Hot);
+}
+
+//---------------------------------------------------------------------
+
+// Returns where to write <length> bytes in the file: the first free range
+// that is big enough, else the end of the file.
+static qint64 AllocateFileRange (kpCommandImageStorePrivate *d, qint64 length)
+{
+    for (QMap <qint64, qint64>::iterator it = d->freeRanges.begin ();
+         it != d->freeRanges.end ();
+         ++it)
+    {
+        if (it.value () < length)
+            continue;
+
+        const qint64 offset = it.key ();
+        const qint64 rest = it.value () - length;
+
+        d->freeRanges.erase (it);
+        if (rest > 0)
+            d->freeRanges.insert (offset + length, rest);
+
+        return offset;
+    }
+
+    const qint64 offset = d->fileEnd;
+    d->fileEnd += length;
+    return offset;
+}
+
+//---------------------------------------------------------------------
+
+// Makes <length> bytes at <offset> of the file available to
+// AllocateFileRange() again, shrinking the file if they were at its end.
+static void FreeFileRange (kpCommandImageStorePrivate *d,
+        qint64 offset, qint64 length)
+{
+    // Merge with the free ranges just after...
+    QMap <qint64, qint64>::iterator next = d->freeRanges.find (offset + length);
+    if (next != d->freeRanges.end ())
+    {
+        length += next.value ();
+        d->freeRanges.erase (next);
+    }
+
+    // ... and just before.
+    QMap <qint64, qint64>::iterator after = d->freeRanges.lowerBound (offset);
+    if (after != d->freeRanges.begin ())
+    {
+        QMap <qint64, qint64>::iterator prev = after - 1;
+        if (prev.key () + prev.value () == offset)
+        {
+            offset = prev.key ();
+            length += prev.value ();
+            d->freeRanges.erase (prev);
+        }
+    }
+
+    if (offset + length == d->fileEnd)
+    {
+        // (a prefetch() job of a forgotten command may still be reading
+        //  here but its result is dropped anyway)
+        d->fileEnd = offset;
+        if (d->file)
+            d->file->resize (d->fileEnd);
+    }
+    else
+        d->freeRanges.insert (offset, length);
+}
+
+//---------------------------------------------------------------------
+
+// Frees the compressed data and file space of <stored>'s images.
+static void DiscardStoredData (kpCommandImageStorePrivate *d,
+        kpStoredCommand *stored)
+{
+    for (QList <kpStoredImage>::iterator it = stored->images.begin ();
+         it != stored->images.end ();
+         ++it)
+    {
+        d->memorySize -= it->data.size ();
+        it->data.clear ();
+
+        if (it->fileOffset >= 0)
+        {
+            d->diskSize -= it->fileLength;
+            ::FreeFileRange (d, it->fileOffset, it->fileLength);
+        }
+        it->fileOffset = -1;
+        it->fileLength = 0;
+    }
+}
+
+//---------------------------------------------------------------------
+
+// public
+void kpCommandImageStore::store (kpCommand *command)
+{
+    kpStoredCommand *stored = d->commands.value (command);
+    if (stored && stored->state != kpStoredCommand::Hot)
+        return;
+
+    const QList <kpImage *> imagePtrs = command->storedImages ();
+
+    // Images put back by restore() and not changed since?  Just release
+    // them again as we still have their data.
+    if (stored && !stored->images.isEmpty ())
+    {
+        bool unchanged = true;
+        foreach (const kpStoredImage &image, stored->images)
+        {
+            if (!imagePtrs.contains (image.image) ||
+                image.image->cacheKey () != image.cacheKey)
+            {
+                unchanged = false;
+                break;
+            }
+        }
+
+        if (unchanged)
+        {
+        #if DEBUG_KP_COMMAND_IMAGE_STORE
+            kDebug () << "kpCommandImageStore::store(" << command->name ()
+                      << ") unchanged since restore()";
+        #endif
+            foreach (const kpStoredImage &image, stored->images)
+                *image.image = kpImage ();
+
+            stored->state = kpStoredCommand::Stored;
+            emit sizeChanged (command);
+            return;
+        }
+
+        ::DiscardStoredData (d, stored);
+        d->memoryOrder.removeAll (command);
+    }
+
+
+    QList <kpStoredImage> images;
+    QList <kpImage> imageCopies;
+
+    foreach (kpImage *imagePtr, imagePtrs)
+    {
+        // Nothing to gain?  Or, with a color table, not just bytes?
+        if (imagePtr->isNull () || imagePtr->colorCount () > 0)
+            continue;
+
+        kpStoredImage image;
+        image.image = imagePtr;
+        image.size = imagePtr->size ();
+        image.format = imagePtr->format ();
+        image.bytesPerLine = imagePtr->bytesPerLine ();
+        image.cacheKey = imagePtr->cacheKey ();
+        image.fileOffset = -1;
+        image.fileLength = 0;
+
+        images.append (image);
+        imageCopies.append (*imagePtr);
+    }
+
+    if (images.isEmpty ())
+    {
+        if (stored)
+        {
+            forget (command);
+            emit sizeChanged (command);
+        }
+        return;
+    }
+
+
+    if (!stored)
+    {
+        stored = new kpStoredCommand ();
+        d->commands.insert (command, stored);
+    }
+
+#if DEBUG_KP_COMMAND_IMAGE_STORE
+    kDebug () << "kpCommandImageStore::store(" << command->name ()
+              << ") compressing" << images.size () << "images";
+#endif
+
+    stored->images = images;
+    stored->state = kpStoredCommand::Compressing;
+
+    stored->compressWatcher = new QFutureWatcher <QList <QByteArray> > (this);
+    connect (stored->compressWatcher, SIGNAL (finished ()),
+             this, SLOT (slotCompressed ()));
+    stored->compressWatcher->setFuture (
+        QtConcurrent::run (::CompressImages, imageCopies));
+
+    emit sizeChanged (command);
+}
+
+//---------------------------------------------------------------------
+
+// private slot
+void kpCommandImageStore::slotCompressed ()
+{
+    QFutureWatcher <QList <QByteArray> > *watcher =
+        static_cast <QFutureWatcher <QList <QByteArray> > *> (sender ());
+    watcher->deleteLater ();
+
+    kpStoredCommand *stored = 0;
+    const kpCommand *command = 0;
+    for (QHash <const kpCommand *, kpStoredCommand *>::const_iterator it =
+            d->commands.constBegin ();
+         it != d->commands.constEnd ();
+         ++it)
+    {
+        if ((*it)->compressWatcher == watcher)
+        {
+            command = it.key ();
+            stored = *it;
+            break;
+        }
+    }
+
+    // Cancelled by restore() or forget()?
+    if (!stored)
+        return;
+
+    stored->compressWatcher = 0;
+
+    const QList <QByteArray> data = watcher->result ();
+    bool ok = (data.size () == stored->images.size ());
+    for (int i = 0; ok && i < data.size (); i++)
+    {
+        ok = (!data [i].isEmpty () &&
+              stored->images [i].image->cacheKey () == stored->images [i].cacheKey);
+    }
+
+    if (!ok)
+    {
+    #if DEBUG_KP_COMMAND_IMAGE_STORE
+        kDebug () << "kpCommandImageStore::slotCompressed() could not compress";
+    #endif
+        // Keep the images in the command then.
+        stored->images.clear ();
+        stored->state = kpStoredCommand::Hot;
+        emit sizeChanged (command);
+        return;
+    }
+
+    for (int i = 0; i < data.size (); i++)
+    {
+        kpStoredImage &image = stored->images [i];
+
+        image.data = data [i];
+        d->memorySize += image.data.size ();
+
+        *image.image = kpImage ();
+    }
+
+    stored->state = kpStoredCommand::Stored;
+    d->memoryOrder.append (command);
+
+#if DEBUG_KP_COMMAND_IMAGE_STORE
+    kDebug () << "kpCommandImageStore::slotCompressed() memorySize="
+              << d->memorySize << "diskSize=" << d->diskSize;
+#endif
+
+    emit sizeChanged (command);
+
+    spill ();
+}
+
+//---------------------------------------------------------------------
+
+// private
+void kpCommandImageStore::spill ()
+{
+    while (d->memorySize > d->memoryBudget && !d->memoryOrder.isEmpty ())
+    {
+        if (!d->file)
+        {
+            d->file = new QTemporaryFile (
+                QDir::tempPath () + QLatin1String ("/ikpaint-undo-XXXXXX"),
+                this);
+            if (!d->file->open ())
+            {
+                qCritical () << "kpCommandImageStore::spill() could not create"
+                             << d->file->fileName ();
+                delete d->file;
+                d->file = 0;
+                return;
+            }
+
+            d->fileEnd = 0;
+            d->freeRanges.clear ();
+        }
+
+        const kpCommand *command = d->memoryOrder.first ();
+        kpStoredCommand *stored = d->commands.value (command);
+        Q_ASSERT (stored);
+
+        for (QList <kpStoredImage>::iterator it = stored->images.begin ();
+             it != stored->images.end ();
+             ++it)
+        {
+            if (it->data.isEmpty ())
+                continue;
+
+            const qint64 offset = ::AllocateFileRange (d, it->data.size ());
+
+            if (!d->file->seek (offset) ||
+                d->file->write (it->data) != it->data.size () ||
+                !d->file->flush ())
+            {
+                qCritical () << "kpCommandImageStore::spill() could not write to"
+                             << d->file->fileName ();
+                ::FreeFileRange (d, offset, it->data.size ());
+                emit sizeChanged (command);
+                return;
+            }
+
+            it->fileOffset = offset;
+            it->fileLength = it->data.size ();
+            d->diskSize += it->fileLength;
+
+            d->memorySize -= it->data.size ();
+            it->data.clear ();
+        }
+
+        d->memoryOrder.removeFirst ();
+        emit sizeChanged (command);
+    }
+}
+
+//---------------------------------------------------------------------
+
+// public
+void kpCommandImageStore::prefetch (kpCommand *command)
+{
+    kpStoredCommand *stored = d->commands.value (command);
+    if (!stored || stored->state != kpStoredCommand::Stored ||
+        stored->prefetchWatcher)
+    {
+        return;
+    }
+
+#if DEBUG_KP_COMMAND_IMAGE_STORE
+    kDebug () << "kpCommandImageStore::prefetch(" << command->name () << ")";
+#endif
+
+    stored->prefetchWatcher = new QFutureWatcher <QList <kpImage> > (this);
+    stored->prefetchWatcher->setFuture (
+        QtConcurrent::run (::LoadStoredImages, stored->images,
+                           d->file ? d->file->fileName () : QString ()));
+
+    emit sizeChanged (command);
+}
+
+//---------------------------------------------------------------------
+
+// public
+bool kpCommandImageStore::restore (kpCommand *command)
+{
+    kpStoredCommand *stored = d->commands.value (command);
+    if (!stored || stored->state == kpStoredCommand::Hot)
+        return true;
+
+    if (stored->state == kpStoredCommand::Compressing)
+    {
+        // The images have not been released yet.  Just drop the result.
+        delete stored->compressWatcher;
+        stored->compressWatcher = 0;
+
+        stored->images.clear ();
+        stored->state = kpStoredCommand::Hot;
+        emit sizeChanged (command);
+        return true;
+    }
+
+
+    QList <kpImage> images;
+
+    if (stored->prefetchWatcher)
+    {
+        stored->prefetchWatcher->waitForFinished ();
+        images = stored->prefetchWatcher->result ();
+
+        delete stored->prefetchWatcher;
+        stored->prefetchWatcher = 0;
+    }
+    else
+    {
+        images = ::LoadStoredImages (stored->images,
+            d->file ? d->file->fileName () : QString ());
+    }
+
+#if DEBUG_KP_COMMAND_IMAGE_STORE
+    kDebug () << "kpCommandImageStore::restore(" << command->name () << ")";
+#endif
+
+    bool ok = (images.size () == stored->images.size ());
+    for (int i = 0; ok && i < images.size (); i++)
+        ok = !images [i].isNull ();
+
+    if (!ok)
+    {
+        qCritical () << "kpCommandImageStore::restore(" << command->name ()
+                     << ") could not read back images";
+        emit sizeChanged (command);
+        return false;
+    }
+
+    for (int i = 0; i < images.size (); i++)
+    {
+        kpStoredImage &image = stored->images [i];
+
+        *image.image = images [i];
+        image.cacheKey = images [i].cacheKey ();
+    }
+
+    // (the compressed data is kept, in case the images are stored again
+    //  unchanged)
+    stored->state = kpStoredCommand::Hot;
+    emit sizeChanged (command);
+    return true;
+}
+
+//---------------------------------------------------------------------
+
+// public
+void kpCommandImageStore::forget (kpCommand *command)
+{
+    kpStoredCommand *stored = d->commands.take (command);
+    if (!stored)
+        return;
+
+    ::DiscardStoredData (d, stored);
+    d->memoryOrder.removeAll (command);
+
+    // (jobs still running keep their own copies of what they need)
+    delete stored->compressWatcher;
+    delete stored->prefetchWatcher;
+    delete stored;
+}
+
+//---------------------------------------------------------------------
+
+// public
+void kpCommandImageStore::clear ()
+{
+    foreach (kpStoredCommand *stored, d->commands)
+    {
+        delete stored->compressWatcher;
+        delete stored->prefetchWatcher;
+        delete stored;
+    }
+    d->commands.clear ();
+    d->memoryOrder.clear ();
+
+    d->memorySize = d->diskSize = 0;
+
+    delete d->file;
+    d->file = 0;
+    d->fileEnd = 0;
+    d->freeRanges.clear ();
+}
+
+//---------------------------------------------------------------------
@@ -0,0 +1,121 @@
+/*
+   Copyright (c) 2015-2018 Maikel Diaz <ariguanabosoft@gmail.com>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef kpCommandImageStore_H
+#define kpCommandImageStore_H
+
+
+#include <qobject.h>
+
+#include <kpCommandSize.h>
+
+
+class kpCommand;
+
+
+//
+// Keeps the kpCommand::storedImages() of commands, that are not about to
+// be undone or redone, out of the way:
+//
+// 1. store() compresses them on a worker thread and then releases the
+//    images in the command.
+// 2. Once the compressed images take more than memoryBudget(), those of
+//    the least recently stored commands are moved to a temporary file.
+// 3. prefetch() reads and decompresses them on a worker thread, so that
+//    they are ready by the time restore() has to put them back.
+//
+// kpCommandHistoryBase uses this so that documents with huge images can
+// still have a deep undo history.
+//
+class kpCommandImageStore : public QObject
+{
+Q_OBJECT
+
+public:
+    kpCommandImageStore (QObject *parent = 0);
+    virtual ~kpCommandImageStore ();
+
+public:
+    // The most compressed image data to keep in memory, before moving
+    // some to disk.
+    kpCommandSize::SizeType memoryBudget () const;
+    void setMemoryBudget (kpCommandSize::SizeType budget);
+
+    // Returns the memory used by <command>: its size() while its images are
+    // in it, else the size of its compressed (and any prefetched) images.
+    kpCommandSize::SizeType memorySize (const kpCommand *command) const;
+    // Returns how much of the temporary file is used by <command>.
+    kpCommandSize::SizeType diskSize (const kpCommand *command) const;
+
+    // Totals, over all commands, of compressed data in memory and on disk.
+    kpCommandSize::SizeType memorySize () const;
+    kpCommandSize::SizeType diskSize () const;
+
+    // Returns whether <command>'s images have been taken out of it.
+    bool isStored (const kpCommand *command) const;
+
+    // Returns whether memorySize(<command>) includes the images that are
+    // in <command> i.e. they are not about to be released.
+    bool countsImages (const kpCommand *command) const;
+
+public:
+    // Starts compressing <command>'s stored images.  They are released
+    // once that is done, unless restore() or forget() is called first.
+    void store (kpCommand *command);
+
+    // Starts getting <command>'s images ready for restore(), if they
+    // have been stored.
+    void prefetch (kpCommand *command);
+
+    // Puts back <command>'s images, waiting for any prefetch().
+    //
+    // Returns false if they could not be read back, leaving <command>
+    // without its images (so every later call fails too).  It must not be
+    // executed or unexecuted anymore.
+    bool restore (kpCommand *command);
+
+    // Call before deleting <command>, or all commands.
+    void forget (kpCommand *command);
+    void clear ();
+
+signals:
+    // Emitted when memorySize() or diskSize() of <command> changes.  Not
+    // emitted by forget() and clear(), as the command is about to go.
+    void sizeChanged (const kpCommand *command);
+
+private slots:
+    void slotCompressed ();
+
+private:
+    // Moves compressed images to disk until the memory budget is met.
+    void spill ();
+
+    struct kpCommandImageStorePrivate * const d;
+};
+
+
+#endif  // kpCommandImageStore_H
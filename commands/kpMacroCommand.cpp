@@ -88,6 +88,19 @@ kpCommandSize::SizeType kpMacroCommand::size () const
 
 //---------------------------------------------------------------------
 
+// public virtual [base kpCommand]
+QList <kpImage *> kpMacroCommand::storedImages ()
+{
+    QList <kpImage *> images;
+
+    foreach (kpCommand *cmd, m_commandList)
+        images += cmd->storedImages ();
+
+    return images;
+}
+
+//---------------------------------------------------------------------
+
 // public virtual [base kpCommand]
 void kpMacroCommand::execute ()
 {
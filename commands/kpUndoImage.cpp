@@ -0,0 +1,177 @@
+/*
+   Copyright (c) 2015-2018 Maikel Diaz <ariguanabosoft@gmail.com>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#define DEBUG_KP_UNDO_IMAGE 0
+
+
+#include <kpUndoImage.h>
+
+#include <QFutureWatcher>
+#include <QtConcurrentRun>
+
+#include <qdebug.h>
+
+#include <kpCommandEnvironment.h>
+
+
+static kpImageDelta ComputeDelta (const kpImage &oldImage,
+                                  const kpImage &newImage)
+{
+    return kpImageDelta (oldImage, newImage);
+}
+
+//---------------------------------------------------------------------
+
+kpUndoImage::kpUndoImage (const kpCommand *command,
+                          kpCommandEnvironment *environ,
+                          QObject *parent)
+    : QObject (parent),
+      m_command (command),
+      m_environ (environ),
+      m_deltaWatcher (0)
+{
+}
+
+//---------------------------------------------------------------------
+
+kpUndoImage::~kpUndoImage ()
+{
+    // (a running job keeps its own copies of the images)
+    delete m_deltaWatcher;
+}
+
+//---------------------------------------------------------------------
+
+// public
+bool kpUndoImage::isNull () const
+{
+    return (m_oldImage.isNull () && m_delta.isNull ());
+}
+
+//---------------------------------------------------------------------
+
+// public
+kpCommandSize::SizeType kpUndoImage::size () const
+{
+    return kpCommandSize::ImageSize (m_oldImage) + m_delta.size ();
+}
+
+//---------------------------------------------------------------------
+
+// public
+void kpUndoImage::set (const kpImage &oldImage, const kpImage &newImage)
+{
+    clear ();
+
+    m_oldImage = oldImage;
+
+    if (oldImage.size () != newImage.size () ||
+        oldImage.format () != newImage.format () ||
+        oldImage.depth () != 32)
+    {
+        return;
+    }
+
+    m_deltaWatcher = new QFutureWatcher <kpImageDelta> (this);
+    connect (m_deltaWatcher, SIGNAL (finished ()),
+             this, SLOT (slotDeltaComputed ()));
+    m_deltaWatcher->setFuture (
+        QtConcurrent::run (::ComputeDelta, oldImage, newImage));
+}
+
+//---------------------------------------------------------------------
+
+// public
+void kpUndoImage::clear ()
+{
+    delete m_deltaWatcher;
+    m_deltaWatcher = 0;
+
+    m_oldImage = kpImage ();
+    m_delta = kpImageDelta ();
+}
+
+//---------------------------------------------------------------------
+
+// public
+kpImage kpUndoImage::oldImage (const kpImage &newImage) const
+{
+    if (!m_oldImage.isNull ())
+        return m_oldImage;
+
+    const kpImage ret = m_delta.oldImage (newImage);
+    if (ret.isNull ())
+    {
+        qCritical () << "kpUndoImage::oldImage() could not rebuild from delta:"
+                     << " newImage.size=" << newImage.size ()
+                     << " delta.isNull=" << m_delta.isNull ();
+    }
+
+    return ret;
+}
+
+//---------------------------------------------------------------------
+
+// public
+kpImage *kpUndoImage::storedImage ()
+{
+    return &m_oldImage;
+}
+
+//---------------------------------------------------------------------
+
+// private slot
+void kpUndoImage::slotDeltaComputed ()
+{
+    const kpImageDelta delta = m_deltaWatcher->result ();
+
+    m_deltaWatcher->deleteLater ();
+    m_deltaWatcher = 0;
+
+    const kpCommandSize::SizeType imageSize =
+        kpCommandSize::ImageSize (m_oldImage);
+
+#if DEBUG_KP_UNDO_IMAGE
+    kDebug () << "kpUndoImage::slotDeltaComputed() imageSize=" << imageSize
+              << " delta.size=" << delta.size ()
+              << " changedRect=" << delta.changedRect ();
+#endif
+
+    // Images that changed all over are better kept as they are -- or,
+    // if the command history has already compressed and released the old
+    // image, as the history has it.
+    if (delta.isNull () || m_oldImage.isNull () || delta.size () >= imageSize)
+        return;
+
+    m_delta = delta;
+    m_oldImage = kpImage ();
+
+    // Keep the history's memory usage and limits accurate.
+    m_environ->commandSizeChanged (m_command);
+}
+
+//---------------------------------------------------------------------
@@ -0,0 +1,94 @@
+/*
+   Copyright (c) 2015-2018 Maikel Diaz <ariguanabosoft@gmail.com>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef kpUndoImage_H
+#define kpUndoImage_H
+
+
+#include <qobject.h>
+
+#include <kpCommandSize.h>
+#include <kpImage.h>
+#include <kpImageDelta.h>
+
+
+template <typename T> class QFutureWatcher;
+
+class kpCommand;
+class kpCommandEnvironment;
+
+
+//
+// The image that a command has to put back on unexecute() e.g. the
+// document image from before an effect.
+//
+// Once set(), a kpImageDelta of the old image against the new image is
+// worked out on a worker thread.  If smaller, it then replaces the old
+// image -- so that the memory taken tracks the amount of the image that
+// the command actually changed.  The command history is then told that
+// the size() of <command> has changed.
+//
+class kpUndoImage : public QObject
+{
+Q_OBJECT
+
+public:
+    kpUndoImage (const kpCommand *command, kpCommandEnvironment *environ,
+                 QObject *parent = 0);
+    virtual ~kpUndoImage ();
+
+    bool isNull () const;
+
+    kpCommandSize::SizeType size () const;
+
+    // Keeps <oldImage>, to be put back over <newImage>.
+    void set (const kpImage &oldImage, const kpImage &newImage);
+    void clear ();
+
+    // Returns the image given to set() as <oldImage>.  <newImage> must be
+    // the same as the one given to set().
+    kpImage oldImage (const kpImage &newImage) const;
+
+    // For kpCommand::storedImages(): the old image, unless it has been
+    // replaced by the delta.
+    kpImage *storedImage ();
+
+private slots:
+    void slotDeltaComputed ();
+
+private:
+    const kpCommand *m_command;
+    kpCommandEnvironment *m_environ;
+
+    kpImage m_oldImage;
+    kpImageDelta m_delta;
+
+    QFutureWatcher <kpImageDelta> *m_deltaWatcher;
+};
+
+
+#endif  // kpUndoImage_H
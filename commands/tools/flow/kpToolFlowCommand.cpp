@@ -68,6 +68,12 @@ kpCommandSize::SizeType kpToolFlowCommand::size () const
     return ImageSize (d->image);
 }
 
+// public virtual [base kpCommand]
+QList <kpImage *> kpToolFlowCommand::storedImages ()
+{
+    return QList <kpImage *> () << &d->image;
+}
+
 
 // public virtual [base kpCommand]
 void kpToolFlowCommand::execute ()
@@ -86,13 +92,7 @@ void kpToolFlowCommand::unexecute ()
 void kpToolFlowCommand::swapOldAndNew ()
 {
     if (d->boundingRect.isValid ())
-    {
-        const kpImage oldImage = document ()->getImageAt (d->boundingRect);
-
-        document ()->setImageAt (d->image, d->boundingRect.topLeft ());
-
-        d->image = oldImage;
-    }
+        document ()->swapImageAt (&d->image, d->boundingRect.topLeft ());
 }
 
 // public
@@ -48,6 +48,8 @@ public:
     virtual void execute ();
     virtual void unexecute ();
 
+    virtual QList <kpImage *> storedImages ();
+
     // interface for kpToolFlowBase
     void updateBoundingRect (const QPoint &point);
     void updateBoundingRect (const QRect &rect);
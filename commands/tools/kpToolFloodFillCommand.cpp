@@ -44,12 +44,19 @@
 #include <kpDocument.h>
 #include <kpImage.h>
 #include <kpPixmapFX.h>
+#include <kpUndoImage.h>
 
 //---------------------------------------------------------------------
 
 struct kpToolFloodFillCommandPrivate
 {
-    kpImage oldImage;
+    kpToolFloodFillCommandPrivate (const kpCommand *command,
+                                   kpCommandEnvironment *environ)
+        : oldImage (command, environ)
+    {
+    }
+
+    kpUndoImage oldImage;
     bool fillEntireImage;
 };
 
@@ -61,7 +68,7 @@ kpToolFloodFillCommand::kpToolFloodFillCommand (int x, int y,
 
     : kpCommand (environ),
       kpFloodFill (document ()->imagePointer (), x, y, color, processedColorSimilarity),
-      d (new kpToolFloodFillCommandPrivate ())
+      d (new kpToolFloodFillCommandPrivate (this, environ))
 {
     d->fillEntireImage = false;
 }
@@ -86,7 +93,15 @@ QString kpToolFloodFillCommand::name () const
 // public virtual [base kpCommand]
 kpCommandSize::SizeType kpToolFloodFillCommand::size () const
 {
-    return kpFloodFill::size () + ImageSize (d->oldImage);
+    return kpFloodFill::size () + d->oldImage.size ();
+}
+
+//---------------------------------------------------------------------
+
+// public virtual [base kpCommand]
+QList <kpImage *> kpToolFloodFillCommand::storedImages ()
+{
+    return QList <kpImage *> () << d->oldImage.storedImage ();
 }
 
 //---------------------------------------------------------------------
@@ -122,10 +137,13 @@ void kpToolFloodFillCommand::execute ()
         {
             QApplication::setOverrideCursor (Qt::WaitCursor);
             {
-                d->oldImage = doc->getImageAt (rect);
+                const kpImage oldImage = doc->getImageAt (rect);
 
                 kpFloodFill::fill ();
                 doc->slotContentsChanged (rect);
+
+                // Only the filled pixels differ.
+                d->oldImage.set (oldImage, doc->getImageAt (rect));
             }
             QApplication::restoreOverrideCursor ();
         }
@@ -161,9 +179,13 @@ void kpToolFloodFillCommand::unexecute ()
         QRect rect = kpFloodFill::boundingRect ();
         if (rect.isValid ())
         {
-            doc->setImageAt (d->oldImage, rect.topLeft ());
+            const kpImage oldImage = d->oldImage.oldImage (doc->getImageAt (rect));
+            if (oldImage.isNull ())
+                return;
+
+            doc->setImageAt (oldImage, rect.topLeft ());
 
-            d->oldImage = kpImage ();
+            d->oldImage.clear ();
 
             doc->slotContentsChanged (rect);
         }
@@ -60,6 +60,8 @@ public:
     virtual void execute ();
     virtual void unexecute ();
 
+    virtual QList <kpImage *> storedImages ();
+
 private:
     kpToolFloodFillCommandPrivate * const d;
 };
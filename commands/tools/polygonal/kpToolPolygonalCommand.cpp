@@ -109,6 +109,12 @@ kpCommandSize::SizeType kpToolPolygonalCommand::size () const
            ImageSize (d->oldImage);
 }
 
+// public virtual [base kpCommand]
+QList <kpImage *> kpToolPolygonalCommand::storedImages ()
+{
+    return QList <kpImage *> () << &d->oldImage;
+}
+
 // public virtual [base kpCommand]
 void kpToolPolygonalCommand::execute ()
 {
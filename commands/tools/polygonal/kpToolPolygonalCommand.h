@@ -59,6 +59,8 @@ public:
     virtual void execute ();
     virtual void unexecute ();
 
+    virtual QList <kpImage *> storedImages ();
+
 private:
     struct kpToolPolygonalCommandPrivate * const d;
     kpToolPolygonalCommand &operator= (const kpToolPolygonalCommand &) const;
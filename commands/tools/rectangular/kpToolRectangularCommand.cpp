@@ -100,6 +100,12 @@ kpCommandSize::SizeType kpToolRectangularCommand::size () const
     return ImageSize (d->oldImage);
 }
 
+// public virtual [base kpCommand]
+QList <kpImage *> kpToolRectangularCommand::storedImages ()
+{
+    return QList <kpImage *> () << &d->oldImage;
+}
+
 
 // public virtual [base kpCommand]
 void kpToolRectangularCommand::execute ()
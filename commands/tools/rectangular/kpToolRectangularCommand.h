@@ -53,6 +53,8 @@ public:
     virtual void execute ();
     virtual void unexecute ();
 
+    virtual QList <kpImage *> storedImages ();
+
 private:
     struct kpToolRectangularCommandPrivate * const d;
     kpToolRectangularCommand &operator= (const kpToolRectangularCommand &) const;
@@ -85,6 +85,14 @@ kpCommandSize::SizeType kpToolSelectionDestroyCommand::size () const
 
 //---------------------------------------------------------------------
 
+// public virtual [base kpCommand]
+QList <kpImage *> kpToolSelectionDestroyCommand::storedImages ()
+{
+    return QList <kpImage *> () << &m_oldDocImage;
+}
+
+//---------------------------------------------------------------------
+
 // public virtual [base kpCommand]
 void kpToolSelectionDestroyCommand::execute ()
 {
@@ -49,6 +49,8 @@ public:
     virtual void execute ();
     virtual void unexecute ();
 
+    virtual QList <kpImage *> storedImages ();
+
 private:
     bool m_pushOntoDocument;
     kpImage m_oldDocImage;
@@ -57,6 +57,11 @@
 #include <kpViewManager.h>
 
 
+// Side length of the tiles that copyOntoDocument() saves the document
+// under.  64 * 64 * 4 bytes = 16K.
+static const int OldDocumentTileSize = 64;
+
+
 kpToolSelectionMoveCommand::kpToolSelectionMoveCommand (const QString &name,
         kpCommandEnvironment *environ)
     : kpNamedCommand (name, environ)
@@ -90,8 +95,29 @@ kpAbstractSelection *kpToolSelectionMoveCommand::originalSelectionClone () const
 // public virtual [base kpComand]
 kpCommandSize::SizeType kpToolSelectionMoveCommand::size () const
 {
-    return ImageSize (m_oldDocumentImage) +
-           PolygonSize (m_copyOntoDocumentPoints);
+    SizeType s = PolygonSize (m_copyOntoDocumentPoints);
+
+    foreach (const kpImage &tile, m_oldDocumentTiles)
+        s += ImageSize (tile);
+
+    return s;
+}
+
+// public virtual [base kpCommand]
+QList <kpImage *> kpToolSelectionMoveCommand::storedImages ()
+{
+    QList <kpImage *> images;
+
+    // (QList holds images by pointer, so these stay valid as tiles are
+    //  appended)
+    for (QList <kpImage>::iterator it = m_oldDocumentTiles.begin ();
+         it != m_oldDocumentTiles.end ();
+         ++it)
+    {
+        images.append (&(*it));
+    }
+
+    return images;
 }
 
 
@@ -146,8 +172,8 @@ void kpToolSelectionMoveCommand::unexecute ()
 
     vm->setQueueUpdates ();
 
-    if (!m_oldDocumentImage.isNull ())
-        doc->setImageAt (m_oldDocumentImage, m_documentBoundingRect.topLeft ());
+    for (int i = 0; i < m_oldDocumentTiles.size (); i++)
+        doc->setImageAt (m_oldDocumentTiles [i], m_oldDocumentTilePositions [i]);
 #if DEBUG_KP_TOOL_SELECTION && 1
     kDebug () << "\tmove to startPoint=" << m_startPoint;
 #endif
@@ -206,15 +232,34 @@ void kpToolSelectionMoveCommand::copyOntoDocument ()
     // to be consistent with the requirement on other selection operations.
     Q_ASSERT (sel && sel->hasContent ());
 
-    if (m_oldDocumentImage.isNull ())
-        m_oldDocumentImage = doc->image ();
-
     QRect selBoundingRect = sel->boundingRect ();
-    #if QT_VERSION >= 0x050000
-    m_documentBoundingRect.united (selBoundingRect);
-    #else
-    m_documentBoundingRect.unite (selBoundingRect);
-    #endif
+
+    // Save the tiles about to be stamped on for the first time.
+    const QRect stampRect = selBoundingRect & doc->rect ();
+    if (!stampRect.isEmpty ())
+    {
+        const int T = OldDocumentTileSize;
+        for (int tileY = stampRect.top () / T;
+             tileY <= stampRect.bottom () / T;
+             tileY++)
+        {
+            for (int tileX = stampRect.left () / T;
+                 tileX <= stampRect.right () / T;
+                 tileX++)
+            {
+                const qint64 key = (qint64 (tileY) << 32) | quint32 (tileX);
+                if (m_oldDocumentTileKeys.contains (key))
+                    continue;
+
+                const QRect tileRect =
+                    QRect (tileX * T, tileY * T, T, T) & doc->rect ();
+
+                m_oldDocumentTiles.append (doc->getImageAt (tileRect));
+                m_oldDocumentTilePositions.append (tileRect.topLeft ());
+                m_oldDocumentTileKeys.insert (key);
+            }
+        }
+    }
 
     doc->selectionCopyOntoDocument ();
 
@@ -227,10 +272,7 @@ void kpToolSelectionMoveCommand::copyOntoDocument ()
 // public
 void kpToolSelectionMoveCommand::finalize ()
 {
-    if (!m_oldDocumentImage.isNull () && !m_documentBoundingRect.isNull ())
-    {
-        m_oldDocumentImage = kpTool::neededPixmap (m_oldDocumentImage,
-                                                    m_documentBoundingRect);
-    }
+    // No more stamps.
+    m_oldDocumentTileKeys.clear ();
 }
 
@@ -30,9 +30,11 @@
 #define kpToolSelectionMoveCommand_H
 
 
+#include <QList>
 #include <QPoint>
 #include <QPolygon>
 #include <QRect>
+#include <QSet>
 
 #include <kpImage.h>
 #include <kpNamedCommand.h>
@@ -54,6 +56,8 @@ public:
     virtual void execute ();
     virtual void unexecute ();
 
+    virtual QList <kpImage *> storedImages ();
+
     void moveTo (const QPoint &point, bool moveLater = false);
     void moveTo (int x, int y, bool moveLater = false);
     void copyOntoDocument ();
@@ -62,10 +66,13 @@ public:
 private:
     QPoint m_startPoint, m_endPoint;
 
-    kpImage m_oldDocumentImage;
-
-    // area of document affected (not the bounding rect of the sel)
-    QRect m_documentBoundingRect;
+    // The original document pixels of each OldDocumentTileSize tile that
+    // copyOntoDocument() has stamped on, and where they go back.  A long
+    // trail of stamps only keeps the area it actually covers, instead of a
+    // copy of the whole document.
+    QList <kpImage> m_oldDocumentTiles;
+    QList <QPoint> m_oldDocumentTilePositions;
+    QSet <qint64> m_oldDocumentTileKeys;
 
     QPolygon m_copyOntoDocumentPoints;
 };
@@ -42,6 +42,8 @@
 #include <qpixmap.h>
 #include <qpolygon.h>
 #include <qtimer.h>
+#include <QAtomicInt>
+#include <QtConcurrentRun>
 
 #include <qdebug.h>
 #include <qlocale.h>
@@ -65,7 +67,9 @@ kpToolSelectionResizeScaleCommand::kpToolSelectionResizeScaleCommand (
                          i18n ("Text: Resize Box") :
                          i18n ("Selection: Smooth Scale"),
                       environ),
-      m_smoothScaleTimer (new QTimer (this))
+      m_smoothScaleTimer (new QTimer (this)),
+      m_needsSmoothScale (false),
+      m_smoothScaleWatcher (new QFutureWatcher <kpImage> (this))
 {
     m_originalSelectionPtr = selection ()->clone ();
 
@@ -75,11 +79,16 @@ kpToolSelectionResizeScaleCommand::kpToolSelectionResizeScaleCommand (
 
     m_smoothScaleTimer->setSingleShot (true);
     connect (m_smoothScaleTimer, SIGNAL (timeout ()),
-             this, SLOT (resizeScaleAndMove ()));
+             this, SLOT (startSmoothScale ()));
+
+    connect (m_smoothScaleWatcher, SIGNAL (finished ()),
+             this, SLOT (slotSmoothScaleFinished ()));
 }
 
 kpToolSelectionResizeScaleCommand::~kpToolSelectionResizeScaleCommand ()
 {
+    cancelSmoothScale ();
+
     delete m_originalSelectionPtr;
 }
 
@@ -166,6 +175,62 @@ void kpToolSelectionResizeScaleCommand::killSmoothScaleTimer ()
     m_smoothScaleTimer->stop ();
 }
 
+// protected
+void kpToolSelectionResizeScaleCommand::cancelSmoothScale ()
+{
+    if (m_smoothScaleCancelled)
+        m_smoothScaleCancelled->storeRelease (1);
+}
+
+// protected
+bool kpToolSelectionResizeScaleCommand::isSmoothScaleCancelled () const
+{
+    return (m_smoothScaleCancelled && m_smoothScaleCancelled->loadAcquire ());
+}
+
+
+// protected
+kpImage kpToolSelectionResizeScaleCommand::previewImage (int width, int height)
+{
+    Q_ASSERT (dynamic_cast <kpAbstractImageSelection *> (m_originalSelectionPtr));
+    kpAbstractImageSelection *imageSel =
+        static_cast <kpAbstractImageSelection *> (m_originalSelectionPtr);
+
+    kpImage source = imageSel->baseImage ();
+
+    // Enlarging - just duplicate pixels.
+    if (width >= source.width () && height >= source.height ())
+        return kpPixmapFX::scale (source, width, height, kpPixmapFX::NearestFilter);
+
+    // Go down the pyramid while the next level is still big enough,
+    // building it on first use.
+    for (int level = 0;
+         source.width () / 2 >= width && source.height () / 2 >= height;
+         level++)
+    {
+        if (level == m_scalePyramid.count ())
+        {
+            m_scalePyramid.append (kpPixmapFX::scale (source,
+                source.width () / 2, source.height () / 2,
+                kpPixmapFX::BoxFilter));
+        }
+
+        source = m_scalePyramid [level];
+    }
+
+    // (less than halving so only a few source pixels per preview pixel)
+    return kpPixmapFX::scale (source, width, height, kpPixmapFX::BilinearFilter);
+}
+
+
+// Also run on a worker thread, which gives up once <cancelled> is set.
+static kpImage SmoothScaleImage (const kpImage &image, int width, int height,
+        QSharedPointer <QAtomicInt> cancelled = QSharedPointer <QAtomicInt> ())
+{
+    return kpPixmapFX::scale (image, width, height, kpPixmapFX::BilinearFilter,
+                              cancelled.data ());
+}
+
 
 // protected
 void kpToolSelectionResizeScaleCommand::resizeScaleAndMove (bool delayed)
@@ -177,6 +242,13 @@ void kpToolSelectionResizeScaleCommand::resizeScaleAndMove (bool delayed)
 
     killSmoothScaleTimer ();
 
+    // A smooth scale to another size is of no use anymore.
+    if (m_smoothScaleWatcher->isRunning () &&
+        m_smoothScaleWatcherSize != QSize (m_newWidth, m_newHeight))
+    {
+        cancelSmoothScale ();
+    }
+
     kpAbstractSelection *newSelPtr = 0;
 
     if (textSelection ())
@@ -198,14 +270,17 @@ void kpToolSelectionResizeScaleCommand::resizeScaleAndMove (bool delayed)
                    imageSel->y (),
                    m_newWidth,
                    m_newHeight),
-            kpPixmapFX::scale (imageSel->baseImage (),
-                               m_newWidth, m_newHeight,
-                               !delayed/*if not delayed, smooth*/),
+            delayed ?
+                previewImage (m_newWidth, m_newHeight) :
+                ::SmoothScaleImage (imageSel->baseImage (),
+                                    m_newWidth, m_newHeight),
             imageSel->transparency ());
 
+        m_needsSmoothScale = delayed;
+
         if (delayed)
         {
-            // Call self (once) with delayed==false in 200ms
+            // Start the smooth scale once the size has settled for 200ms.
             m_smoothScaleTimer->start (200/*ms*/);
         }
     }
@@ -227,6 +302,70 @@ void kpToolSelectionResizeScaleCommand::resizeScaleAndMove ()
     resizeScaleAndMove (false/*no delay*/);
 }
 
+// protected slot
+void kpToolSelectionResizeScaleCommand::startSmoothScale ()
+{
+    if (!m_needsSmoothScale)
+        return;
+
+    // Already scaling to this size?
+    if (m_smoothScaleWatcher->isRunning () && !isSmoothScaleCancelled () &&
+        m_smoothScaleWatcherSize == QSize (m_newWidth, m_newHeight))
+    {
+        return;
+    }
+
+    // Leave any stale one to give up in the background and stop watching it.
+    cancelSmoothScale ();
+
+#if DEBUG_KP_TOOL_SELECTION
+    kDebug () << "kpToolSelectionResizeScaleCommand::startSmoothScale()"
+              << m_newWidth << "x" << m_newHeight;
+#endif
+
+    Q_ASSERT (dynamic_cast <kpAbstractImageSelection *> (m_originalSelectionPtr));
+    kpAbstractImageSelection *imageSel =
+        static_cast <kpAbstractImageSelection *> (m_originalSelectionPtr);
+
+    m_smoothScaleWatcherSize = QSize (m_newWidth, m_newHeight);
+    m_smoothScaleCancelled = QSharedPointer <QAtomicInt> (new QAtomicInt (0));
+    m_smoothScaleWatcher->setFuture (
+        QtConcurrent::run (::SmoothScaleImage, imageSel->baseImage (),
+                           m_newWidth, m_newHeight, m_smoothScaleCancelled));
+}
+
+// protected slot
+void kpToolSelectionResizeScaleCommand::slotSmoothScaleFinished ()
+{
+    // Finalized or undone in the meantime?
+    if (!m_needsSmoothScale)
+        return;
+
+    if (m_smoothScaleWatcherSize != QSize (m_newWidth, m_newHeight) ||
+        isSmoothScaleCancelled ())
+    {
+        // Stale - resized again since.  Unless another drag is still
+        // settling, scale to the current size.
+        if (!m_smoothScaleTimer->isActive ())
+            startSmoothScale ();
+        return;
+    }
+
+    Q_ASSERT (dynamic_cast <kpAbstractImageSelection *> (m_originalSelectionPtr));
+    kpAbstractImageSelection *imageSel =
+        static_cast <kpAbstractImageSelection *> (m_originalSelectionPtr);
+
+    kpRectangularImageSelection newSel (
+        QRect (m_newTopLeft.x (), m_newTopLeft.y (),
+               m_newWidth, m_newHeight),
+        m_smoothScaleWatcher->result (),
+        imageSel->transparency ());
+
+    m_needsSmoothScale = false;
+
+    document ()->setSelection (newSel);
+}
+
 
 // public
 void kpToolSelectionResizeScaleCommand::finalize ()
@@ -238,13 +377,26 @@ void kpToolSelectionResizeScaleCommand::finalize ()
                << endl;
 #endif
 
-    // Make sure the selection contains the final image and the timer won't
-    // fire afterwards.
-    if (m_smoothScaleTimer->isActive ())
+    // Make sure the selection contains the final image, scaled from the
+    // full resolution original, and that neither the timer nor the worker
+    // will change it afterwards.
+    killSmoothScaleTimer ();
+
+    if (m_needsSmoothScale &&
+        m_smoothScaleWatcher->isRunning () && !isSmoothScaleCancelled () &&
+        m_smoothScaleWatcherSize == QSize (m_newWidth, m_newHeight))
     {
-        resizeScaleAndMove ();
-        Q_ASSERT (!m_smoothScaleTimer->isActive ());
+        m_smoothScaleWatcher->waitForFinished ();
+        slotSmoothScaleFinished ();
     }
+
+    if (m_needsSmoothScale)
+        resizeScaleAndMove ();
+
+    Q_ASSERT (!m_needsSmoothScale);
+
+    // Only needed while dragging.
+    m_scalePyramid.clear ();
 }
 
 
@@ -268,6 +420,8 @@ void kpToolSelectionResizeScaleCommand::unexecute ()
     QApplication::setOverrideCursor (Qt::WaitCursor);
 
     killSmoothScaleTimer ();
+    cancelSmoothScale ();
+    m_needsSmoothScale = false;
 
     document ()->setSelection (*m_originalSelectionPtr);
 
@@ -30,12 +30,18 @@
 #define kpToolSelectionResizeScaleCommand_H
 
 
+#include <QFutureWatcher>
+#include <QList>
 #include <QObject>
 #include <QPoint>
+#include <QSharedPointer>
+#include <QSize>
 
+#include <kpImage.h>
 #include <kpNamedCommand.h>
 
 
+class QAtomicInt;
 class QTimer;
 
 class kpAbstractSelection;
@@ -79,14 +85,29 @@ public:
 protected:
     void killSmoothScaleTimer ();
 
-    // If <delayed>, does a fast, low-quality scale and then calls itself
-    // with <delayed> unset for a smooth scale, a short time later.
+    // Makes the smooth scale on the worker thread, if any, give up.
+    void cancelSmoothScale ();
+    bool isSmoothScaleCancelled () const;
+
+    // Returns a quick preview of the original image scaled to
+    // <width>x<height>, made from the smallest level of the scale pyramid
+    // that is still big enough, so the cost is proportional to the size of
+    // the preview rather than to the size of the original image.
+    kpImage previewImage (int width, int height);
+
+    // If <delayed>, does a fast, low-quality scale and then, a short time
+    // later, a smooth scale from the full resolution original on a worker
+    // thread, which is swapped in when done.  Changing the size again
+    // cancels that smooth scale.
     // If acting on a text box, <delayed> is ignored.
     void resizeScaleAndMove (bool delayed);
 
 protected slots:
     void resizeScaleAndMove (/*delayed = false*/);
 
+    void startSmoothScale ();
+    void slotSmoothScaleFinished ();
+
 public:
     void finalize ();
 
@@ -101,6 +122,19 @@ protected:
     int m_newWidth, m_newHeight;
 
     QTimer *m_smoothScaleTimer;
+
+    // Successive halvings of the original image.
+    QList <kpImage> m_scalePyramid;
+
+    // Whether the selection only holds a preview, awaiting the smooth scale.
+    bool m_needsSmoothScale;
+
+    QFutureWatcher <kpImage> *m_smoothScaleWatcher;
+    QSize m_smoothScaleWatcherSize;
+    // Set to cancel the smooth scale that <m_smoothScaleWatcher> watches.
+    // Each one gets its own, since a cancelled one might still be running
+    // when the next one starts.
+    QSharedPointer <QAtomicInt> m_smoothScaleCancelled;
 };
 
 
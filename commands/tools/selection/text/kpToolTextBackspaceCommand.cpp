@@ -57,14 +57,16 @@ kpToolTextBackspaceCommand::~kpToolTextBackspaceCommand ()
 // public
 void kpToolTextBackspaceCommand::addBackspace ()
 {
-    QList <QString> textLines = textSelection ()->textLines ();
+    kpTextSelection *textSel = textSelection ();
 
     if (m_col > 0)
     {
-        m_deletedText.prepend (textLines [m_row][m_col - 1]);
+        const QString textLine = textSel->textLine (m_row);
+
+        m_deletedText.prepend (textLine [m_col - 1]);
 
-        textLines [m_row] = textLines [m_row].left (m_col - 1) +
-                            textLines [m_row].mid (m_col);
+        textSel->setTextLine (m_row,
+            textLine.left (m_col - 1) + textLine.mid (m_col));
         m_col--;
     }
     else
@@ -72,21 +74,21 @@ void kpToolTextBackspaceCommand::addBackspace ()
         if (m_row > 0)
         {
             int newCursorRow = m_row - 1;
-            int newCursorCol = textLines [newCursorRow].length ();
+            const QString newCursorLine = textSel->textLine (newCursorRow);
+            int newCursorCol = newCursorLine.length ();
 
             m_deletedText.prepend ('\n');
 
-            textLines [newCursorRow] += textLines [m_row];
+            textSel->setTextLine (newCursorRow,
+                newCursorLine + textSel->textLine (m_row));
 
-            textLines.erase (textLines.begin () + m_row);
+            textSel->removeTextLine (m_row);
 
             m_row = newCursorRow;
             m_col = newCursorCol;
         }
     }
 
-    textSelection ()->setTextLines (textLines);
-
     viewManager ()->setTextCursorPosition (m_row, m_col);
 
     m_numBackspaces++;
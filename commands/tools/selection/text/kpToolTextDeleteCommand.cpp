@@ -57,28 +57,28 @@ kpToolTextDeleteCommand::~kpToolTextDeleteCommand ()
 // public
 void kpToolTextDeleteCommand::addDelete ()
 {
-    QList <QString> textLines = textSelection ()->textLines ();
+    kpTextSelection *textSel = textSelection ();
+    const QString textLine = textSel->textLine (m_row);
 
-    if (m_col < (int) textLines [m_row].length ())
+    if (m_col < (int) textLine.length ())
     {
-        m_deletedText.prepend (textLines [m_row][m_col]);
+        m_deletedText.prepend (textLine [m_col]);
 
-        textLines [m_row] = textLines [m_row].left (m_col) +
-                            textLines [m_row].mid (m_col + 1);
+        textSel->setTextLine (m_row,
+            textLine.left (m_col) + textLine.mid (m_col + 1));
     }
     else
     {
-        if (m_row < (int) textLines.size () - 1)
+        if (m_row < textSel->textLineCount () - 1)
         {
             m_deletedText.prepend ('\n');
 
-            textLines [m_row] += textLines [m_row + 1];
-            textLines.erase (textLines.begin () + m_row + 1);
+            textSel->setTextLine (m_row,
+                textLine + textSel->textLine (m_row + 1));
+            textSel->removeTextLine (m_row + 1);
         }
     }
 
-    textSelection ()->setTextLines (textLines);
-
     viewManager ()->setTextCursorPosition (m_row, m_col);
 
     m_numDeletes++;
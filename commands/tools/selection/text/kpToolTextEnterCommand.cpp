@@ -57,14 +57,11 @@ kpToolTextEnterCommand::~kpToolTextEnterCommand ()
 // public
 void kpToolTextEnterCommand::addEnter ()
 {
-    QList <QString> textLines = textSelection ()->textLines ();
-
-    const QString rightHalf = textLines [m_row].mid (m_col);
+    kpTextSelection *textSel = textSelection ();
+    const QString textLine = textSel->textLine (m_row);
 
-    textLines [m_row].truncate (m_col);
-    textLines.insert (textLines.begin () + m_row + 1, rightHalf);
-
-    textSelection ()->setTextLines (textLines);
+    textSel->setTextLine (m_row, textLine.left (m_col));
+    textSel->insertTextLine (m_row + 1, textLine.mid (m_col));
 
     m_row++;
     m_col = 0;
@@ -55,11 +55,10 @@ void kpToolTextInsertCommand::addText (const QString &moreText)
     if (moreText.isEmpty ())
         return;
 
-    QList <QString> textLines = textSelection ()->textLines ();
-    const QString leftHalf = textLines [m_row].left (m_col);
-    const QString rightHalf = textLines [m_row].mid (m_col);
-    textLines [m_row] = leftHalf + moreText + rightHalf;
-    textSelection ()->setTextLines (textLines);
+    const QString textLine = textSelection ()->textLine (m_row);
+    const QString leftHalf = textLine.left (m_col);
+    const QString rightHalf = textLine.mid (m_col);
+    textSelection ()->setTextLine (m_row, leftHalf + moreText + rightHalf);
 
     m_newText += moreText;
     m_col += moreText.length ();
@@ -94,11 +93,10 @@ void kpToolTextInsertCommand::unexecute ()
 {
     viewManager ()->setTextCursorPosition (m_row, m_col);
 
-    QList <QString> textLines = textSelection ()->textLines ();
-    const QString leftHalf = textLines [m_row].left (m_col - m_newText.length ());
-    const QString rightHalf = textLines [m_row].mid (m_col);
-    textLines [m_row] = leftHalf + rightHalf;
-    textSelection ()->setTextLines (textLines);
+    const QString textLine = textSelection ()->textLine (m_row);
+    const QString leftHalf = textLine.left (m_col - m_newText.length ());
+    const QString rightHalf = textLine.mid (m_col);
+    textSelection ()->setTextLine (m_row, leftHalf + rightHalf);
 
     m_col -= m_newText.length ();
 
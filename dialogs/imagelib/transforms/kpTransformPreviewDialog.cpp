@@ -270,6 +270,80 @@ int kpTransformPreviewDialog::scaleDimension (int dimension, double scale, int m
 }
 
 
+// private
+void kpTransformPreviewDialog::updatePreviewSourceImage ()
+{
+    kpDocument *doc = document ();
+    Q_ASSERT (doc && !doc->image ().isNull ());
+
+    // The largest preview we can currently be asked for.
+    const QSize labelSize = m_previewPixmapLabel->size ().expandedTo (QSize (1, 1));
+
+    if (!m_previewSourceImage.isNull ())
+    {
+        // Already the full-size image?
+        if (m_previewSourceImage.width () >= m_oldWidth &&
+            m_previewSourceImage.height () >= m_oldHeight)
+        {
+            return;
+        }
+
+        // Still big enough to shrink from?  The preview keeps the aspect
+        // ratio (see updateShrunkenDocumentPixmap()) so it usually fills the
+        // label in one dimension only.
+        const double keepsAspectScale = aspectScale (labelSize.width (),
+                                                     labelSize.height (),
+                                                     m_oldWidth,
+                                                     m_oldHeight);
+        if (m_previewSourceImage.width () >=
+                scaleDimension (m_oldWidth, keepsAspectScale, 1, labelSize.width ()) &&
+            m_previewSourceImage.height () >=
+                scaleDimension (m_oldHeight, keepsAspectScale, 1, labelSize.height ()))
+        {
+            return;
+        }
+    }
+
+#if DEBUG_KP_TRANSFORM_PREVIEW_DIALOG
+    kDebug () << "\tupdating previewSourceImage for labelSize=" << labelSize;
+#endif
+
+    kpImage image;
+
+    if (m_actOnSelection)
+    {
+        kpAbstractImageSelection *sel = doc->imageSelection ()->clone ();
+        if (!sel->hasContent ())
+            sel->setBaseImage (doc->getSelectedBaseImage ());
+
+        image = sel->transparentImage ();
+        delete sel;
+    }
+    else
+    {
+        image = doc->image ();
+    }
+
+    // Leave room for the label to grow to twice its size before we need
+    // to come back here.
+    const double keepsAspectScale = aspectScale (labelSize.width () * 2,
+                                                 labelSize.height () * 2,
+                                                 m_oldWidth,
+                                                 m_oldHeight);
+    if (keepsAspectScale >= 1)
+    {
+        // Small enough to transform the real thing.
+        m_previewSourceImage = image;
+    }
+    else
+    {
+        m_previewSourceImage = kpPixmapFX::scale (image,
+            scaleDimension (m_oldWidth, keepsAspectScale, 1, m_oldWidth),
+            scaleDimension (m_oldHeight, keepsAspectScale, 1, m_oldHeight),
+            kpPixmapFX::BoxFilter);
+    }
+}
+
 // private
 void kpTransformPreviewDialog::updateShrunkenDocumentPixmap ()
 {
@@ -288,9 +362,6 @@ void kpTransformPreviewDialog::updateShrunkenDocumentPixmap ()
         return;
 
 
-    kpDocument *doc = document ();
-    Q_ASSERT (doc && !doc->image ().isNull ());
-
     if (m_shrunkenDocumentPixmap.isNull () ||
         m_previewPixmapLabel->size () != m_previewPixmapLabelSizeWhenUpdatedPixmap)
     {
@@ -298,6 +369,8 @@ void kpTransformPreviewDialog::updateShrunkenDocumentPixmap ()
         kDebug () << "\tupdating shrunkenDocPixmap";
     #endif
 
+        updatePreviewSourceImage ();
+
         // TODO: Why the need to keep aspect ratio here?
         //       Isn't scaling the skewed result maintaining aspect enough?
         double keepsAspectScale = aspectScale (m_previewPixmapLabel->width (),
@@ -305,36 +378,23 @@ void kpTransformPreviewDialog::updateShrunkenDocumentPixmap ()
                                                m_oldWidth,
                                                m_oldHeight);
 
-        kpImage image;
-
-        if (m_actOnSelection)
-        {
-            kpAbstractImageSelection *sel = doc->imageSelection ()->clone ();
-            if (!sel->hasContent ())
-                sel->setBaseImage (doc->getSelectedBaseImage ());
-
-            image = sel->transparentImage ();
-            delete sel;
-        }
-        else
-        {
-            image = doc->image ();
-        }
-
+        const int shrunkenWidth = scaleDimension (m_oldWidth,
+                                                  keepsAspectScale,
+                                                  1, m_previewPixmapLabel->width ());
+        const int shrunkenHeight = scaleDimension (m_oldHeight,
+                                                   keepsAspectScale,
+                                                   1, m_previewPixmapLabel->height ());
+
+        // Average when shrinking, so that the preview is not a random
+        // sample of the document's pixels, but keep pixels sharp when a
+        // small image is enlarged.
+        const bool enlarging =
+            (shrunkenWidth > m_previewSourceImage.width () ||
+             shrunkenHeight > m_previewSourceImage.height ());
         m_shrunkenDocumentPixmap = kpPixmapFX::scale (
-            image,
-            scaleDimension (m_oldWidth,
-                            keepsAspectScale,
-                            1, m_previewPixmapLabel->width ()),
-            scaleDimension (m_oldHeight,
-                            keepsAspectScale,
-                            1, m_previewPixmapLabel->height ()));
-    #if 0
-        m_shrunkenDocumentPixmap = kpPixmapFX::scale (
-            m_actOnSelection ? doc->getSelectedPixmap () : *doc->pixmap (),
-            m_previewPixmapLabel->width (),
-            m_previewPixmapLabel->height ());
-    #endif
+            m_previewSourceImage,
+            shrunkenWidth, shrunkenHeight,
+            enlarging ? kpPixmapFX::NearestFilter : kpPixmapFX::BoxFilter);
 
         m_previewPixmapLabelSizeWhenUpdatedPixmap = m_previewPixmapLabel->size ();
     }
@@ -385,8 +445,10 @@ void kpTransformPreviewDialog::updatePreview ()
                                            1,  // min
                                            m_previewPixmapLabel->height ());  // max
 
-        // TODO: Some effects work directly on QImage; so could cache the
-        //       QImage so that transformPixmap() is faster
+        // The transform is applied to the already shrunken document with
+        // the final preview size as its target, so the subclass composes
+        // the scale down into its transform and samples each preview pixel
+        // once -- the document size does not matter here.
         QImage transformedShrunkenDocumentPixmap =
             transformPixmap (m_shrunkenDocumentPixmap, targetWidth, targetHeight);
 
@@ -89,6 +89,10 @@ protected:
     }
 
     virtual QSize newDimensions () const = 0;
+
+    // Returns <pixmap>, a shrunken copy of the document, transformed and
+    // scaled to <targetWidth>x<targetHeight>.  Do both in one pass where
+    // possible, as this is called for every change of a value.
     virtual QImage transformPixmap (const QImage &pixmap,
                                     int targetWidth, int targetHeight) const = 0;
 
@@ -110,6 +114,7 @@ public:
     static int scaleDimension (int dimension, double scale, int min, int max);
 
 private:
+    void updatePreviewSourceImage ();
     void updateShrunkenDocumentPixmap ();
 
 protected slots:
@@ -134,6 +139,10 @@ protected:
     QGroupBox *m_previewGroupBox;
     kpResizeSignallingLabel *m_previewPixmapLabel;
     QSize m_previewPixmapLabelSizeWhenUpdatedPixmap;
+    // The document (or selection) downscaled once to a little more than the
+    // preview label needs, so that resizing the dialog does not go back to
+    // the full-size image.
+    QImage m_previewSourceImage;
     QImage m_shrunkenDocumentPixmap;
 
     QGridLayout *m_gridLayout;
@@ -65,6 +65,7 @@
 
 #define kpSettingResizeScaleLastKeepAspect "Resize Scale - Last Keep Aspect"
 #define kpSettingResizeScaleScaleType "Resize Scale - ScaleType"
+#define kpSettingResizeScaleSmoothScaleFilter "Resize Scale - Smooth Scale Filter"
 
 //---------------------------------------------------------------------
 
@@ -114,8 +115,14 @@ kpTransformResizeScaleDialog::kpTransformResizeScaleDialog (
     m_lastType = static_cast<kpTransformResizeScaleCommand::Type>
                    (cfg.value(kpSettingResizeScaleScaleType,
                                   static_cast<int>(kpTransformResizeScaleCommand::Resize)).toInt());
+    const int filterIndex = m_smoothScaleFilterCombo->findData (
+        cfg.value(kpSettingResizeScaleSmoothScaleFilter,
+                  static_cast<int>(kpPixmapFX::BilinearFilter)).toInt());
+    if (filterIndex >= 0)
+        m_smoothScaleFilterCombo->setCurrentIndex (filterIndex);
 
     slotActOnChanged ();
+    slotTypeChanged ();
 
    // m_newWidthInput->setEditFocus ();
 
@@ -234,7 +241,9 @@ QGroupBox *kpTransformResizeScaleDialog::createOperationGroupBox (QWidget *baseW
 
                   "<li><b>Smooth Scale</b>: This is the same as"
                   " <i>Scale</i> except that it blends neighboring"
-                  " pixels to produce a smoother looking picture.</li>"
+                  " pixels to produce a smoother looking picture."
+                  " <i>Area Average</i> is best for large reductions and"
+                  " <i>Lanczos</i> gives the sharpest results.</li>"
               "</ul>"
               "</qt>"));
 
@@ -267,6 +276,20 @@ QGroupBox *kpTransformResizeScaleDialog::createOperationGroupBox (QWidget *baseW
     operationLayout->addWidget (m_scaleButton, 0, 1, Qt::AlignCenter);
     operationLayout->addWidget (m_smoothScaleButton, 0, 2, Qt::AlignCenter);
 
+    QLabel *filterLabel = new QLabel (i18n ("Smooth scale &filter:"), operationGroupBox);
+    m_smoothScaleFilterCombo = new QComboBox (operationGroupBox);
+    m_smoothScaleFilterCombo->addItem (i18n ("Area Average"),
+        static_cast<int>(kpPixmapFX::BoxFilter));
+    m_smoothScaleFilterCombo->addItem (i18n ("Bilinear"),
+        static_cast<int>(kpPixmapFX::BilinearFilter));
+    m_smoothScaleFilterCombo->addItem (i18n ("Lanczos"),
+        static_cast<int>(kpPixmapFX::Lanczos3Filter));
+    m_smoothScaleFilterCombo->setCurrentIndex (1);
+    filterLabel->setBuddy (m_smoothScaleFilterCombo);
+
+    operationLayout->addWidget (filterLabel, 1, 0, Qt::AlignRight);
+    operationLayout->addWidget (m_smoothScaleFilterCombo, 1, 1, 1, 2);
+
     connect (m_resizeButton, SIGNAL (toggled (bool)),
              this, SLOT (slotTypeChanged ()));
     connect (m_scaleButton, SIGNAL (toggled (bool)),
@@ -515,6 +538,9 @@ void kpTransformResizeScaleDialog::slotActOnChanged ()
 void kpTransformResizeScaleDialog::slotTypeChanged ()
 {
     m_lastType = type ();
+
+    m_smoothScaleFilterCombo->setEnabled (
+        m_lastType == kpTransformResizeScaleCommand::SmoothScale);
 }
 
 //---------------------------------------------------------------------
@@ -667,6 +693,15 @@ kpTransformResizeScaleCommand::Type kpTransformResizeScaleDialog::type () const
 //---------------------------------------------------------------------
 // public
 
+kpPixmapFX::ScaleFilter kpTransformResizeScaleDialog::smoothScaleFilter () const
+{
+    return static_cast<kpPixmapFX::ScaleFilter>
+        (m_smoothScaleFilterCombo->itemData (m_smoothScaleFilterCombo->currentIndex ()).toInt());
+}
+
+//---------------------------------------------------------------------
+// public
+
 bool kpTransformResizeScaleDialog::isNoOp () const
 {
     return (imageWidth () == originalWidth () &&
@@ -820,6 +855,7 @@ void kpTransformResizeScaleDialog::accept ()
     cfg.beginGroup(kpSettingsGroupGeneral);
     cfg.setValue(kpSettingResizeScaleLastKeepAspect, m_keepAspectRatioCheckBox->isChecked());
     cfg.setValue(kpSettingResizeScaleScaleType, static_cast<int>(m_lastType));
+    cfg.setValue(kpSettingResizeScaleSmoothScaleFilter, static_cast<int>(smoothScaleFilter ()));
     cfg.endGroup();
 }
 
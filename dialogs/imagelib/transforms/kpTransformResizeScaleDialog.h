@@ -71,6 +71,7 @@ Q_OBJECT
     int imageHeight () const;
     bool actOnSelection () const;
     kpTransformResizeScaleCommand::Type type () const;
+    kpPixmapFX::ScaleFilter smoothScaleFilter () const;
 
     bool isNoOp () const;
 
@@ -114,6 +115,7 @@ Q_OBJECT
     QToolButton *m_resizeButton,
                 *m_scaleButton,
                 *m_smoothScaleButton;
+    QComboBox *m_smoothScaleFilterCombo;
 
     QSpinBox *m_originalWidthInput, *m_originalHeightInput,
                  *m_newWidthInput, *m_newHeightInput;
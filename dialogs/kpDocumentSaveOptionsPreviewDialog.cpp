@@ -116,15 +116,27 @@ QSize kpDocumentSaveOptionsPreviewDialog::preferredMinimumSize () const
 // public slot
 void kpDocumentSaveOptionsPreviewDialog::setFilePixmapAndSize (const QImage &pixmap,
                                                                qint64 fileSize)
+{
+    setFilePreviewAndSize (pixmap, pixmap.size (), fileSize, false/*exact*/);
+}
+
+// public slot
+void kpDocumentSaveOptionsPreviewDialog::setFilePreviewAndSize (const QImage &preview,
+                                                                const QSize &fileImageSize,
+                                                                qint64 fileSize,
+                                                                bool isEstimate)
 {
     delete m_filePixmap;
-    m_filePixmap = new QImage (pixmap);
+    m_filePixmap = new QImage (preview);
 
     updatePixmapPreview ();
 
     m_fileSize = fileSize;
 
-    const kpCommandSize::SizeType pixmapSize = kpCommandSize::PixmapSize (pixmap);
+    // (compare against the uncompressed document image, not the preview)
+    const kpCommandSize::SizeType pixmapSize =
+        kpCommandSize::PixmapSize (fileImageSize.width (), fileImageSize.height (),
+                                   32);
     // (int cast is safe as long as the file size is not more than 20 million
     //  -- i.e. INT_MAX / 100 -- times the pixmap size)
     const int percent = pixmapSize ?
@@ -132,16 +144,21 @@ void kpDocumentSaveOptionsPreviewDialog::setFilePixmapAndSize (const QImage &pix
                                   (int) ((kpCommandSize::SizeType) fileSize * 100 / pixmapSize)) :
                             0;
 #if DEBUG_KP_DOCUMENT_SAVE_OPTIONS_WIDGET
-    kDebug () << "kpDocumentSaveOptionsPreviewDialog::setFilePixmapAndSize()"
+    kDebug () << "kpDocumentSaveOptionsPreviewDialog::setFilePreviewAndSize()"
                << " pixmapSize=" << pixmapSize
                << " fileSize=" << fileSize
+               << " isEstimate=" << isEstimate
                << " raw fileSize/pixmapSize%="
                << (pixmapSize ? (kpCommandSize::SizeType) fileSize * 100 / pixmapSize : 0)
                << endl;
 #endif
 
-    m_fileSizeLabel->setText (QObject::tr("1 byte (approx. %2%)", "%1 bytes (approx. %2%)")
-    								.arg(m_fileSize).arg(percent));
+    const QString sizeText = (m_fileSize == 1) ?
+        i18n ("1 byte") :
+        i18n ("%1 bytes", QLocale ().toString (m_fileSize));
+    m_fileSizeLabel->setText (isEstimate ?
+        i18n ("About %1 (approx. %2%)", sizeText, QString::number (percent)) :
+        i18n ("%1 (approx. %2%)", sizeText, QString::number (percent)));
 }
 
 // public slot
@@ -64,6 +64,15 @@ signals:
 
 public slots:
     void setFilePixmapAndSize (const QImage &filePixmap, qint64 fileSize);
+
+    // Shows <preview> (which may be smaller than the file's image) and the
+    // size of a file holding an image of <fileImageSize>.  If <isEstimate>,
+    // <fileSize> is only an approximation and will be followed by a call
+    // with the exact size.
+    void setFilePreviewAndSize (const QImage &preview,
+                                const QSize &fileImageSize,
+                                qint64 fileSize,
+                                bool isEstimate);
     void updatePixmapPreview ();
 
 protected:
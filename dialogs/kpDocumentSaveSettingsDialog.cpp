@@ -0,0 +1,544 @@
+/*
+   Copyright (c) 2015-2018 Maikel Diaz <ariguanabosoft@gmail.com>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#define DEBUG_KP_DOCUMENT_SAVE_SETTINGS_DIALOG 0
+
+
+#include <kpDocumentSaveSettingsDialog.h>
+
+#include <qatomic.h>
+#include <qbuffer.h>
+#include <qcombobox.h>
+#include <QFutureWatcher>
+#include <qgridlayout.h>
+#include <qlabel.h>
+#include <qpushbutton.h>
+#include <qsharedpointer.h>
+#include <qslider.h>
+#include <qspinbox.h>
+#include <QtConcurrentRun>
+
+#include <qdebug.h>
+
+#include <tools.h>
+
+#include <kpDocumentSaveOptionsPreviewDialog.h>
+#include <kpPixmapFX.h>
+
+
+// The largest part of the image that is encoded for the quick estimate.
+static const int EstimateCropSize = 1024;
+
+// The largest preview that is encoded and shown in the preview dialog.
+static const int PreviewSize = 512;
+
+
+struct kpColorDepthChoice
+{
+    const char *text;
+    int depth;
+    bool dither;
+};
+
+static const kpColorDepthChoice ColorDepthChoices [] =
+{
+    {QT_TR_NOOP ("Keep Current"), 0, false},
+    {QT_TR_NOOP ("Monochrome"), 1, false},
+    {QT_TR_NOOP ("Monochrome (Dithered)"), 1, true},
+    {QT_TR_NOOP ("256 Color"), 8, false},
+    {QT_TR_NOOP ("256 Color (Dithered)"), 8, true},
+    {QT_TR_NOOP ("24-bit Color"), 32, false}
+};
+
+static const int NumColorDepthChoices =
+    int (sizeof (ColorDepthChoices) / sizeof (ColorDepthChoices [0]));
+
+
+//---------------------------------------------------------------------
+
+struct kpSaveSettingsEncodeJob
+{
+    kpImage image;
+    // <image> scaled down to at most PreviewSize, or null if the job
+    // should make it.
+    kpImage previewSource;
+    QString saveExt;
+    kpDocumentSaveSettings saveSettings;
+    bool isEstimate;
+
+    int generation;
+    QSharedPointer <QAtomicInt> latestGeneration;
+};
+
+struct kpSaveSettingsEncodeResult
+{
+    kpSaveSettingsEncodeResult ()
+        : generation (-1),
+          isEstimate (false),
+          ok (false),
+          fileSize (0)
+    {
+    }
+
+    int generation;
+    // False if the estimate turned out to be exact.
+    bool isEstimate;
+    bool ok;
+    qint64 fileSize;
+
+    // Only set by estimates.
+    kpImage previewSource;
+    kpImage preview;
+};
+
+//---------------------------------------------------------------------
+
+// Returns whether the user has changed the settings since <job> started.
+static bool IsStale (const kpSaveSettingsEncodeJob &job)
+{
+    return (job.latestGeneration->loadAcquire () != job.generation);
+}
+
+//---------------------------------------------------------------------
+
+// Refuses further writes once its encode is stale, which makes the image
+// writer give up part way through instead of finishing a useless encode.
+class kpStaleAbortingBuffer : public QBuffer
+{
+public:
+    kpStaleAbortingBuffer (const kpSaveSettingsEncodeJob &job)
+        : m_job (job)
+    {
+    }
+
+protected:
+    // protected virtual [base QBuffer]
+    virtual qint64 writeData (const char *data, qint64 len)
+    {
+        if (::IsStale (m_job))
+            return -1;
+
+        return QBuffer::writeData (data, len);
+    }
+
+private:
+    const kpSaveSettingsEncodeJob &m_job;
+};
+
+//---------------------------------------------------------------------
+
+// Returns <image> encoded as it would be saved, or an empty array if the
+// encode failed or was abandoned.
+static QByteArray Encode (const kpSaveSettingsEncodeJob &job,
+                          const kpImage &image)
+{
+    if (::IsStale (job))
+        return QByteArray ();
+
+    const QImage imageToSave = job.saveSettings.imageToSave (image);
+    if (::IsStale (job))
+        return QByteArray ();
+
+    kpStaleAbortingBuffer buffer (job);
+    buffer.open (QIODevice::WriteOnly);
+    if (!imageToSave.save (&buffer, job.saveExt.toLatin1 (),
+                           job.saveSettings.writerQuality (job.saveExt)))
+    {
+        return QByteArray ();
+    }
+
+    return buffer.data ();
+}
+
+//---------------------------------------------------------------------
+
+// Runs on a worker thread.
+static kpSaveSettingsEncodeResult RunEncodeJob (const kpSaveSettingsEncodeJob &job)
+{
+    kpSaveSettingsEncodeResult result;
+    result.generation = job.generation;
+    result.isEstimate = job.isEstimate;
+
+    if (!job.isEstimate)
+    {
+        const QByteArray data = ::Encode (job, job.image);
+        result.ok = !data.isEmpty ();
+        result.fileSize = data.size ();
+        return result;
+    }
+
+
+    //
+    // Estimate the file size from the middle of the image, scaled up by
+    // area.
+    //
+
+    const QRect imageRect = job.image.rect ();
+    QRect cropRect (0, 0,
+                    qMin (imageRect.width (), EstimateCropSize),
+                    qMin (imageRect.height (), EstimateCropSize));
+    cropRect.moveCenter (imageRect.center ());
+
+    const bool cropIsWholeImage = (cropRect == imageRect);
+    const QByteArray cropData = ::Encode (job,
+        cropIsWholeImage ? job.image : job.image.copy (cropRect));
+    if (cropData.isEmpty ())
+        return result;
+
+    result.fileSize = qint64 (cropData.size ()) *
+        (qint64 (imageRect.width ()) * imageRect.height ()) /
+        (qint64 (cropRect.width ()) * cropRect.height ());
+    if (cropIsWholeImage)
+        result.isEstimate = false;
+
+
+    //
+    // Show what the file will look like, from a small copy of the image.
+    //
+
+    result.previewSource = job.previewSource;
+    if (result.previewSource.isNull ())
+    {
+        if (imageRect.width () <= PreviewSize && imageRect.height () <= PreviewSize)
+            result.previewSource = job.image;
+        else
+        {
+            const QSize previewSize =
+                imageRect.size ().scaled (PreviewSize, PreviewSize,
+                                          Qt::KeepAspectRatio);
+            result.previewSource = kpPixmapFX::scale (job.image,
+                qMax (1, previewSize.width ()), qMax (1, previewSize.height ()),
+                kpPixmapFX::BoxFilter);
+        }
+    }
+
+    const QByteArray previewData = ::Encode (job, result.previewSource);
+    if (previewData.isEmpty () ||
+        !result.preview.loadFromData (previewData, job.saveExt.toLatin1 ()))
+    {
+        return result;
+    }
+
+    result.ok = true;
+    return result;
+}
+
+//---------------------------------------------------------------------
+
+struct kpDocumentSaveSettingsDialogPrivate
+{
+    kpImage image;
+    QString saveExt;
+    kpDocumentSaveSettings saveSettings;
+
+    QComboBox *colorDepthCombo;
+    QSlider *qualitySlider;
+    QSpinBox *qualityInput;
+    QSpinBox *compressionInput;
+    QPushButton *previewButton;
+
+    kpDocumentSaveOptionsPreviewDialog *previewDialog;
+
+    // Bumped on every change of settings so that running encodes notice
+    // they are stale.  Shared with them as they may outlive the dialog.
+    QSharedPointer <QAtomicInt> latestGeneration;
+
+    // Cached from the first estimate.
+    kpImage previewSource;
+    kpImage preview;
+};
+
+//---------------------------------------------------------------------
+
+kpDocumentSaveSettingsDialog::kpDocumentSaveSettingsDialog (
+        const kpImage &image,
+        const QString &saveExt,
+        const kpDocumentSaveSettings &saveSettings,
+        QWidget *parent)
+    : KDialog (parent),
+      d (new kpDocumentSaveSettingsDialogPrivate ())
+{
+    d->image = image;
+    d->saveExt = saveExt;
+    d->saveSettings = saveSettings;
+    d->previewDialog = 0;
+    d->latestGeneration = QSharedPointer <QAtomicInt> (new QAtomicInt (0));
+
+    setCaption (i18n ("Save Settings"));
+    setButtons (QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+    QWidget *baseWidget = new QWidget (this);
+    setMainWidget (baseWidget);
+
+
+    QLabel *colorDepthLabel = new QLabel (i18n ("Convert &to:"), baseWidget);
+    d->colorDepthCombo = new QComboBox (baseWidget);
+    colorDepthLabel->setBuddy (d->colorDepthCombo);
+    int colorDepthIndex = 0;
+    for (int i = 0; i < NumColorDepthChoices; i++)
+    {
+        d->colorDepthCombo->addItem (i18n (ColorDepthChoices [i].text));
+
+        if (ColorDepthChoices [i].depth == saveSettings.colorDepth () &&
+            ColorDepthChoices [i].dither == saveSettings.dither ())
+        {
+            colorDepthIndex = i;
+        }
+    }
+    d->colorDepthCombo->setCurrentIndex (colorDepthIndex);
+
+
+    QLabel *qualityLabel = new QLabel (i18n ("Quali&ty:"), baseWidget);
+    d->qualitySlider = new QSlider (Qt::Horizontal, baseWidget);
+    d->qualityInput = new QSpinBox (baseWidget);
+    qualityLabel->setBuddy (d->qualityInput);
+
+    d->qualitySlider->setRange (kpDocumentSaveSettings::DefaultQuality,
+                                kpDocumentSaveSettings::MaxQuality);
+    d->qualityInput->setRange (kpDocumentSaveSettings::DefaultQuality,
+                               kpDocumentSaveSettings::MaxQuality);
+    d->qualityInput->setSpecialValueText (i18n ("Default"));
+    d->qualitySlider->setValue (saveSettings.quality ());
+    d->qualityInput->setValue (saveSettings.quality ());
+
+
+    QLabel *compressionLabel = new QLabel (i18n ("Co&mpression:"), baseWidget);
+    d->compressionInput = new QSpinBox (baseWidget);
+    compressionLabel->setBuddy (d->compressionInput);
+
+    d->compressionInput->setRange (kpDocumentSaveSettings::DefaultCompression,
+                                   kpDocumentSaveSettings::MaxCompression);
+    d->compressionInput->setSpecialValueText (i18n ("Default"));
+    d->compressionInput->setValue (saveSettings.compression ());
+
+
+    d->previewButton = new QPushButton (i18n ("&Preview"), baseWidget);
+    d->previewButton->setCheckable (true);
+
+
+    QGridLayout *lay = new QGridLayout (baseWidget);
+    lay->setMargin (0/*margin*/);
+    lay->setSpacing (spacingHint ());
+
+    lay->addWidget (colorDepthLabel, 0, 0);
+    lay->addWidget (d->colorDepthCombo, 0, 1, 1, 2);
+
+    lay->addWidget (qualityLabel, 1, 0);
+    lay->addWidget (d->qualitySlider, 1, 1);
+    lay->addWidget (d->qualityInput, 1, 2);
+
+    lay->addWidget (compressionLabel, 2, 0);
+    lay->addWidget (d->compressionInput, 2, 1, 1, 2);
+
+    lay->addWidget (d->previewButton, 3, 0, 1, 3, Qt::AlignRight);
+
+    lay->setColumnStretch (1, 1);
+
+
+    // Only offer what the format understands.
+    const bool hasQuality = kpDocumentSaveSettings::FormatSupportsQuality (saveExt);
+    qualityLabel->setVisible (hasQuality);
+    d->qualitySlider->setVisible (hasQuality);
+    d->qualityInput->setVisible (hasQuality);
+
+    const bool hasCompression =
+        kpDocumentSaveSettings::FormatSupportsCompression (saveExt);
+    compressionLabel->setVisible (hasCompression);
+    d->compressionInput->setVisible (hasCompression);
+
+
+    connect (d->qualitySlider, SIGNAL (valueChanged (int)),
+             d->qualityInput, SLOT (setValue (int)));
+    connect (d->qualityInput, SIGNAL (valueChanged (int)),
+             d->qualitySlider, SLOT (setValue (int)));
+
+    connect (d->colorDepthCombo, SIGNAL (activated (int)),
+             this, SLOT (slotSettingsChanged ()));
+    connect (d->qualityInput, SIGNAL (valueChanged (int)),
+             this, SLOT (slotSettingsChanged ()));
+    connect (d->compressionInput, SIGNAL (valueChanged (int)),
+             this, SLOT (slotSettingsChanged ()));
+
+    connect (d->previewButton, SIGNAL (toggled (bool)),
+             this, SLOT (slotPreviewToggled (bool)));
+}
+
+//---------------------------------------------------------------------
+
+kpDocumentSaveSettingsDialog::~kpDocumentSaveSettingsDialog ()
+{
+    // Abandon the running encodes.  Their watchers die with us.
+    d->latestGeneration->fetchAndAddOrdered (1);
+
+    delete d;
+}
+
+//---------------------------------------------------------------------
+
+// public
+kpDocumentSaveSettings kpDocumentSaveSettingsDialog::saveSettings () const
+{
+    kpDocumentSaveSettings settings = d->saveSettings;
+
+    const kpColorDepthChoice &choice =
+        ColorDepthChoices [qMax (0, d->colorDepthCombo->currentIndex ())];
+    settings.setColorDepth (choice.depth);
+    settings.setDither (choice.dither);
+
+    if (kpDocumentSaveSettings::FormatSupportsQuality (d->saveExt))
+        settings.setQuality (d->qualityInput->value ());
+
+    if (kpDocumentSaveSettings::FormatSupportsCompression (d->saveExt))
+        settings.setCompression (d->compressionInput->value ());
+
+    return settings;
+}
+
+//---------------------------------------------------------------------
+
+// private slot
+void kpDocumentSaveSettingsDialog::slotSettingsChanged ()
+{
+    d->latestGeneration->fetchAndAddOrdered (1);
+
+    if (d->previewDialog && d->previewDialog->isVisible ())
+        startEncode (true/*estimate*/);
+}
+
+//---------------------------------------------------------------------
+
+// private slot
+void kpDocumentSaveSettingsDialog::slotPreviewToggled (bool on)
+{
+#if DEBUG_KP_DOCUMENT_SAVE_SETTINGS_DIALOG
+    kDebug () << "kpDocumentSaveSettingsDialog::slotPreviewToggled(" << on << ")";
+#endif
+
+    // Either way, what was running is no longer wanted.
+    d->latestGeneration->fetchAndAddOrdered (1);
+
+    if (!on)
+    {
+        if (d->previewDialog)
+            d->previewDialog->hide ();
+        return;
+    }
+
+    if (!d->previewDialog)
+    {
+        d->previewDialog = new kpDocumentSaveOptionsPreviewDialog (this);
+        d->previewDialog->resize (d->previewDialog->preferredMinimumSize ());
+        d->previewDialog->move (frameGeometry ().topRight () +
+                                QPoint (spacingHint (), 0));
+
+        connect (d->previewDialog, SIGNAL (finished ()),
+                 this, SLOT (slotPreviewDialogFinished ()));
+    }
+
+    d->previewDialog->show ();
+
+    startEncode (true/*estimate*/);
+}
+
+//---------------------------------------------------------------------
+
+// private slot
+void kpDocumentSaveSettingsDialog::slotPreviewDialogFinished ()
+{
+    d->previewButton->setChecked (false);
+}
+
+//---------------------------------------------------------------------
+
+// private
+void kpDocumentSaveSettingsDialog::startEncode (bool isEstimate)
+{
+    kpSaveSettingsEncodeJob job;
+    job.image = d->image;
+    job.previewSource = d->previewSource;
+    job.saveExt = d->saveExt;
+    job.saveSettings = saveSettings ();
+    job.isEstimate = isEstimate;
+    job.generation = d->latestGeneration->loadAcquire ();
+    job.latestGeneration = d->latestGeneration;
+
+#if DEBUG_KP_DOCUMENT_SAVE_SETTINGS_DIALOG
+    kDebug () << "kpDocumentSaveSettingsDialog::startEncode(" << isEstimate
+              << ") generation=" << job.generation;
+#endif
+
+    QFutureWatcher <kpSaveSettingsEncodeResult> *watcher =
+        new QFutureWatcher <kpSaveSettingsEncodeResult> (this);
+    connect (watcher, SIGNAL (finished ()),
+             this, SLOT (slotEncodeFinished ()));
+    watcher->setFuture (QtConcurrent::run (::RunEncodeJob, job));
+}
+
+//---------------------------------------------------------------------
+
+// private slot
+void kpDocumentSaveSettingsDialog::slotEncodeFinished ()
+{
+    QFutureWatcher <kpSaveSettingsEncodeResult> *watcher =
+        static_cast <QFutureWatcher <kpSaveSettingsEncodeResult> *> (sender ());
+    watcher->deleteLater ();
+
+    const kpSaveSettingsEncodeResult result = watcher->result ();
+#if DEBUG_KP_DOCUMENT_SAVE_SETTINGS_DIALOG
+    kDebug () << "kpDocumentSaveSettingsDialog::slotEncodeFinished()"
+              << " generation=" << result.generation
+              << " isEstimate=" << result.isEstimate
+              << " ok=" << result.ok
+              << " fileSize=" << result.fileSize;
+#endif
+
+    // Settings changed or preview closed since?
+    if (result.generation != d->latestGeneration->loadAcquire () ||
+        !d->previewDialog)
+    {
+        return;
+    }
+
+    if (!result.ok)
+    {
+        qCritical () << "kpDocumentSaveSettingsDialog could not encode"
+                     << d->saveExt;
+        return;
+    }
+
+    if (!result.previewSource.isNull ())
+        d->previewSource = result.previewSource;
+    if (!result.preview.isNull ())
+        d->preview = result.preview;
+
+    d->previewDialog->setFilePreviewAndSize (d->preview, d->image.size (),
+        result.fileSize, result.isEstimate);
+
+    if (result.isEstimate)
+        startEncode (false/*exact*/);
+}
+
+//---------------------------------------------------------------------
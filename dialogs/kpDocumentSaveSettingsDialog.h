@@ -0,0 +1,76 @@
+/*
+   Copyright (c) 2015-2018 Maikel Diaz <ariguanabosoft@gmail.com>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef kpDocumentSaveSettingsDialog_H
+#define kpDocumentSaveSettingsDialog_H
+
+
+#include <kdialog.h>
+
+#include <kpDocumentSaveSettings.h>
+#include <kpImage.h>
+
+
+//
+// Asks for the color depth, quality and compression to save <image> with,
+// in the format given by <saveExt>.
+//
+// While the preview is shown, the image is encoded on a worker thread
+// after every change: first a quick estimate from a crop of the image
+// (and a small preview of what the file will look like), then the whole
+// image for the exact file size.  Encodes made stale by a later change
+// are abandoned, so the dialog never waits on the encoder.
+//
+class kpDocumentSaveSettingsDialog : public KDialog
+{
+Q_OBJECT
+
+public:
+    kpDocumentSaveSettingsDialog (const kpImage &image,
+                                  const QString &saveExt,
+                                  const kpDocumentSaveSettings &saveSettings,
+                                  QWidget *parent);
+    virtual ~kpDocumentSaveSettingsDialog ();
+
+    kpDocumentSaveSettings saveSettings () const;
+
+private slots:
+    void slotSettingsChanged ();
+
+    void slotPreviewToggled (bool on);
+    void slotPreviewDialogFinished ();
+
+    void slotEncodeFinished ();
+
+private:
+    void startEncode (bool isEstimate);
+
+    struct kpDocumentSaveSettingsDialogPrivate * const d;
+};
+
+
+#endif  // kpDocumentSaveSettingsDialog_H
@@ -0,0 +1,154 @@
+/*
+   Copyright (c) 2015-2018 Maikel Diaz <ariguanabosoft@gmail.com>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <kpCompositedImageSource.h>
+
+#include <qrect.h>
+
+#include <kpAbstractSelection.h>
+#include <kpDocument.h>
+#include <kpPixmapFX.h>
+
+//---------------------------------------------------------------------
+
+// The size of each band.
+static const int BandBytes = 4 << 20;
+
+//---------------------------------------------------------------------
+
+kpCompositedImageSource::kpCompositedImageSource (const kpDocument *document)
+    : m_document (document)
+{
+    Q_ASSERT (m_document);
+}
+
+//---------------------------------------------------------------------
+
+kpCompositedImageSource::kpCompositedImageSource (const QImage &image)
+    : m_document (0),
+      m_image (image)
+{
+}
+
+//---------------------------------------------------------------------
+
+// public
+int kpCompositedImageSource::width () const
+{
+    return m_document ? m_document->width () : m_image.width ();
+}
+
+//---------------------------------------------------------------------
+
+// public
+int kpCompositedImageSource::height () const
+{
+    return m_document ? m_document->height () : m_image.height ();
+}
+
+//---------------------------------------------------------------------
+
+// public
+int kpCompositedImageSource::bandHeight () const
+{
+    return qMax (1, BandBytes / qMax (1, width () * 4));
+}
+
+//---------------------------------------------------------------------
+
+// public
+QImage kpCompositedImageSource::band (int top, int rows) const
+{
+    const QRect rect = QRect (0, top, width (), rows).intersected (
+        QRect (0, 0, width (), height ()));
+
+    QImage ret;
+
+    if (m_document)
+    {
+        const kpAbstractSelection *sel = m_document->selection ();
+
+        // It need not have any content because e.g. a text box with an
+        // opaque background, but no content, is still visually there
+        // (see kpDocument::imageWithSelection()).
+        if (sel && sel->boundingRect ().intersects (rect))
+        {
+            ret = m_document->getImageAt (rect);
+            sel->paint (&ret, rect);
+        }
+        else
+        {
+            ret = m_document->getImageViewAt (rect);
+        }
+    }
+    else
+    {
+        ret = kpPixmapFX::getPixmapViewAt (m_image, rect);
+    }
+
+    if (ret.format () != QImage::Format_ARGB32_Premultiplied)
+        ret = ret.convertToFormat (QImage::Format_ARGB32_Premultiplied);
+
+    return ret;
+}
+
+//---------------------------------------------------------------------
+
+// public
+bool kpCompositedImageSource::isOpaque () const
+{
+    if (!m_document && !m_image.hasAlphaChannel ())
+        return true;
+
+    const int rows = bandHeight ();
+    for (int top = 0; top < height (); top += rows)
+    {
+        const QImage image = band (top, rows);
+
+        for (int y = 0; y < image.height (); y++)
+        {
+            const QRgb *line = reinterpret_cast <const QRgb *> (image.constScanLine (y));
+            for (int x = 0; x < image.width (); x++)
+            {
+                if (qAlpha (line [x]) != 255)
+                    return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+//---------------------------------------------------------------------
+
+// public
+QImage kpCompositedImageSource::image () const
+{
+    return m_document ? m_document->imageWithSelection () : m_image;
+}
+
+//---------------------------------------------------------------------
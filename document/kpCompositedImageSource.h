@@ -0,0 +1,81 @@
+/*
+   Copyright (c) 2015-2018 Maikel Diaz <ariguanabosoft@gmail.com>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef kpCompositedImageSource_H
+#define kpCompositedImageSource_H
+
+
+#include <qimage.h>
+
+
+class kpDocument;
+
+
+//
+// A document as it is saved or printed -- with its floating selection
+// painted on top, selection transparency included -- handed out a band
+// of rows at a time.
+//
+// Unlike kpDocument::imageWithSelection(), this never makes a composited
+// copy of the whole document: only the bands that the selection overlaps
+// are copied, and only one band at a time.  Band-wise consumers (e.g.
+// kpStreamingImageWriter) therefore need about one band of memory on top
+// of the document, instead of another whole document.
+//
+// The document must not change while a source for it is in use.
+//
+class kpCompositedImageSource
+{
+public:
+    explicit kpCompositedImageSource (const kpDocument *document);
+    // A plain image, without a selection.
+    explicit kpCompositedImageSource (const QImage &image);
+
+    int width () const;
+    int height () const;
+
+    // Returns how many rows to ask band() for at a time, to keep each
+    // band at a few megabytes.
+    int bandHeight () const;
+
+    // Returns rows [<top>, <top> + <rows>) in Format_ARGB32_Premultiplied.
+    QImage band (int top, int rows) const;
+
+    // Returns whether every pixel is fully opaque.  Reads every band.
+    bool isOpaque () const;
+
+    // Returns the whole composited image.  Only for consumers that cannot
+    // work band by band.
+    QImage image () const;
+
+private:
+    const kpDocument *m_document;
+    QImage m_image;
+};
+
+
+#endif  // kpCompositedImageSource_H
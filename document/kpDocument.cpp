@@ -36,6 +36,8 @@
 
 #include <math.h>
 
+#include <algorithm>
+
 #include <qcolor.h>
 #include <qbitmap.h>
 #include <qbrush.h>
@@ -93,6 +95,20 @@ kpDocument::kpDocument (int w, int h,
 
 //---------------------------------------------------------------------
 
+// public static
+kpDocument *kpDocument::NewForOpen (int w, int h,
+        kpDocumentEnvironment *environ)
+{
+    kpDocument *doc = new kpDocument (1, 1, environ);
+
+    doc->m_constructorWidth = w;
+    doc->m_constructorHeight = h;
+
+    return doc;
+}
+
+//---------------------------------------------------------------------
+
 kpDocument::~kpDocument ()
 {
     delete d;
@@ -196,6 +212,22 @@ void kpDocument::setSaveOptions (const QString &saveExt)
 
 //---------------------------------------------------------------------
 
+// public
+kpDocumentSaveSettings kpDocument::saveSettings () const
+{
+    return d->saveSettings;
+}
+
+//---------------------------------------------------------------------
+
+// public
+void kpDocument::setSaveSettings (const kpDocumentSaveSettings &saveSettings)
+{
+    d->saveSettings = saveSettings;
+}
+
+//---------------------------------------------------------------------
+
 // public
 const kpDocumentMetaInfo *kpDocument::metaInfo () const
 {
@@ -323,6 +355,14 @@ kpImage kpDocument::getImageAt (const QRect &rect) const
 
 //---------------------------------------------------------------------
 
+// public
+kpImage kpDocument::getImageViewAt (const QRect &rect) const
+{
+    return kpPixmapFX::getPixmapViewAt (*m_image, rect);
+}
+
+//---------------------------------------------------------------------
+
 // public
 void kpDocument::setImageAt (const kpImage &image, const QPoint &at)
 {
@@ -341,6 +381,43 @@ void kpDocument::setImageAt (const kpImage &image, const QPoint &at)
 
 //---------------------------------------------------------------------
 
+// public
+void kpDocument::swapImageAt (kpImage *image, const QPoint &at)
+{
+    Q_ASSERT (image);
+
+    const QRect rect (at, image->size ());
+
+    if (image->isNull () || image->format () != m_image->format () ||
+        image->depth () < 8 || !m_image->rect ().contains (rect))
+    {
+        const kpImage oldImage = getImageAt (rect);
+        setImageAt (*image, at);
+        *image = oldImage;
+        return;
+    }
+
+    const int bytesPerPixel = m_image->depth () / 8;
+    const int rowBytes = rect.width () * bytesPerPixel;
+
+    // (bits() detaches either image first if it is shared)
+    uchar *docBits = m_image->bits () +
+        rect.y () * m_image->bytesPerLine () + rect.x () * bytesPerPixel;
+    uchar *imageBits = image->bits ();
+
+    for (int y = 0; y < rect.height (); y++)
+    {
+        std::swap_ranges (docBits, docBits + rowBytes, imageBits);
+
+        docBits += m_image->bytesPerLine ();
+        imageBits += image->bytesPerLine ();
+    }
+
+    slotContentsChanged (rect);
+}
+
+//---------------------------------------------------------------------
+
 // public
 kpImage kpDocument::image (bool ofSelection) const
 {
@@ -36,6 +36,7 @@
 #include <qobject.h>
 #include <qstring.h>
 
+#include <kpDocumentSaveSettings.h>
 #include <kpImage.h>
 #include <kpPixmapFX.h>
 #undef environ
@@ -48,6 +49,7 @@ class QRect;
 class QSize;
 
 class kpColor;
+class kpCompositedImageSource;
 class kpDocumentEnvironment;
 
 class kpDocumentMetaInfo;
@@ -73,6 +75,11 @@ public:
     kpDocument (int w, int h, kpDocumentEnvironment *environ);
     ~kpDocument ();
 
+    // Returns a document to open() into.  Until then, it only has a 1x1
+    // placeholder image: the <w>x<h> image is only allocated by
+    // openNew(), if there turns out to be nothing to open.
+    static kpDocument *NewForOpen (int w, int h, kpDocumentEnvironment *environ);
+
     kpDocumentEnvironment *environ () const;
     void setEnviron (kpDocumentEnvironment *environ);
 
@@ -107,19 +114,39 @@ public:
                                     const kpDocumentMetaInfo &metaInfo,
                                     bool lossyPrompt,
                                     QWidget *parent,
-                                    bool *userCancelled = 0);
+                                    bool *userCancelled = 0,
+                                    const kpDocumentSaveSettings &saveSettings =
+                                        kpDocumentSaveSettings ());
     static bool savePixmapToFile (const QImage &pixmap,
                                   const QString &url,
                                   const QString &saveOptions,
                                   const kpDocumentMetaInfo &metaInfo,
                                   bool overwritePrompt,
                                   bool lossyPrompt,
-                                  QWidget *parent);
+                                  QWidget *parent,
+                                  const kpDocumentSaveSettings &saveSettings =
+                                      kpDocumentSaveSettings ());
+    // Same as above but, for the formats kpStreamingImageWriter supports,
+    // encodes <source> a band at a time instead of asking it for the
+    // whole image.
+    static bool savePixmapToFile (const kpCompositedImageSource &source,
+                                  const QString &url,
+                                  const QString &saveOptions,
+                                  const kpDocumentMetaInfo &metaInfo,
+                                  bool overwritePrompt,
+                                  bool lossyPrompt,
+                                  QWidget *parent,
+                                  const kpDocumentSaveSettings &saveSettings =
+                                      kpDocumentSaveSettings ());
+    // Saves with saveSettings().
     bool save (bool overwritePrompt = false, bool lossyPrompt = false);
+    // On success, <saveSettings> become the document's saveSettings().
     bool saveAs (const QString &url,
                  const QString &saveOptions,
                  bool overwritePrompt = true,
-                 bool lossyPrompt = true);
+                 bool lossyPrompt = true,
+                 const kpDocumentSaveSettings &saveSettings =
+                     kpDocumentSaveSettings ());
 
 
     // Returns whether save() or saveAs() have ever been called and returned true
@@ -153,6 +180,10 @@ public:
     const QString *saveOptions () const;
     void setSaveOptions (const QString &saveOptions);
 
+    // The depth, quality and compression the document was last saved with.
+    kpDocumentSaveSettings saveSettings () const;
+    void setSaveSettings (const kpDocumentSaveSettings &saveSettings);
+
     const kpDocumentMetaInfo *metaInfo () const;
     void setMetaInfo (const kpDocumentMetaInfo &metaInfo);
 
@@ -188,8 +219,20 @@ public:
     // selection).
     kpImage getImageAt (const QRect &rect) const;
 
+    // Same as getImageAt() but reads the document's pixels in place,
+    // without copying, until the returned image is written to.  Use for
+    // images that are only read, or are written to straight away, and that
+    // are gone before the document is next changed -- otherwise that change
+    // has to copy the whole document image.
+    kpImage getImageViewAt (const QRect &rect) const;
+
     void setImageAt (const kpImage &image, const QPoint &at);
 
+    // Exchanges the pixels at the rectangle with the top-left <at> and
+    // dimensions <image->rect()> with <*image>.  Same as getImageAt() and
+    // setImageAt() but swaps in place when it can.
+    void swapImageAt (kpImage *image, const QPoint &at);
+
     // "image(false)" returns a copy of the document's image, ignoring any
     // floating selection.
     //
@@ -334,6 +377,12 @@ signals:
     // whether we've switched to the text tool).
     void selectionIsTextChanged (bool isText);
 
+private slots:
+    // Connected to the selection's changed() signal.  Only marks the
+    // document as modified if the selection has content, like
+    // setSelection().
+    void slotSelectionChanged (const QRect &docRect);
+
 private:
     int m_constructorWidth, m_constructorHeight;
     kpImage *m_image;
@@ -0,0 +1,124 @@
+/*
+   Copyright (c) 2015-2018 Maikel Diaz <ariguanabosoft@gmail.com>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#define DEBUG_KP_DOCUMENT_PREFETCH 0
+
+
+#include <kpDocumentPrefetch.h>
+
+#include <QtConcurrentRun>
+
+#include <qhash.h>
+#include <qimagereader.h>
+
+#include <qdebug.h>
+
+#include <kpDocument.h>
+
+
+static QHash <QString, QFuture <kpDocumentPrefetch::Result> > Started;
+
+
+kpDocumentPrefetch::Result::Result ()
+    : error (NoError)
+{
+}
+
+//---------------------------------------------------------------------
+
+// public static
+kpDocumentPrefetch::Result kpDocumentPrefetch::Read (const QString &url)
+{
+#if DEBUG_KP_DOCUMENT_PREFETCH
+    qDebug () << "kpDocumentPrefetch::Read(" << url << ")";
+#endif
+
+    Result result;
+
+    if (url.isEmpty ())
+    {
+        result.error = Result::NoURL;
+        return result;
+    }
+
+    const QString detectedMimeType = QString (QImageReader::imageFormat (url));
+    if (detectedMimeType.isEmpty ())
+    {
+        result.error = Result::UnknownMimeType;
+        return result;
+    }
+
+    result.saveExt = detectedMimeType;
+
+    QImage image (url);
+    if (image.isNull ())
+    {
+        result.error = Result::UnsupportedFormat;
+        return result;
+    }
+
+    kpDocument::getDataFromImage (image, result.metaInfo);
+
+    // make sure we always have Format_ARGB32_Premultiplied as this is the fastest to draw on
+    // and Qt can not draw onto Format_Indexed8 (Qt-4.7)
+    if (image.format () != QImage::Format_ARGB32_Premultiplied)
+        image = image.convertToFormat (QImage::Format_ARGB32_Premultiplied);
+
+    result.image = image;
+    return result;
+}
+
+//---------------------------------------------------------------------
+
+// public static
+QFuture <kpDocumentPrefetch::Result> kpDocumentPrefetch::Start (const QString &url)
+{
+    if (!::Started.contains (url))
+        ::Started.insert (url, QtConcurrent::run (&kpDocumentPrefetch::Read, url));
+
+    return ::Started.value (url);
+}
+
+//---------------------------------------------------------------------
+
+// public static
+bool kpDocumentPrefetch::Take (const QString &url, Result *result)
+{
+    if (!::Started.contains (url))
+        return false;
+
+    QFuture <Result> future = ::Started.take (url);
+    *result = future.result ();
+
+#if DEBUG_KP_DOCUMENT_PREFETCH
+    qDebug () << "kpDocumentPrefetch::Take(" << url << ") error=" << result->error;
+#endif
+
+    return true;
+}
+
+//---------------------------------------------------------------------
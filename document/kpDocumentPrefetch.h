@@ -0,0 +1,88 @@
+/*
+   Copyright (c) 2015-2018 Maikel Diaz <ariguanabosoft@gmail.com>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef kpDocumentPrefetch_H
+#define kpDocumentPrefetch_H
+
+
+#include <qfuture.h>
+#include <qimage.h>
+#include <qstring.h>
+
+#include <kpDocumentMetaInfo.h>
+
+
+//
+// Decodes image files on the global thread pool ahead of their being
+// opened, so that opening many files at once (e.g. from the command line)
+// takes about as long as the slowest decode, rather than the sum of them.
+//
+// kpDocument::getPixmapFromFile() uses the result of Start()ing a URL, if
+// there is one, instead of reading the file itself.
+//
+// Start() and Take() must only be called from the GUI thread.
+//
+class kpDocumentPrefetch
+{
+public:
+    struct Result
+    {
+        enum Error
+        {
+            NoError,
+            NoURL,
+            UnknownMimeType,
+            UnsupportedFormat
+        };
+
+        Result ();
+
+        Error error;
+
+        // Format_ARGB32_Premultiplied, or null on error.
+        QImage image;
+        // The format detected, for saving.
+        QString saveExt;
+        kpDocumentMetaInfo metaInfo;
+    };
+
+    // Reads <url> without any user interaction.  Safe to call from any
+    // thread.
+    static Result Read (const QString &url);
+
+    // Starts Read()ing <url> in the background, if it is not already being
+    // read, and returns a future to watch for it finishing.
+    static QFuture <Result> Start (const QString &url);
+
+    // If <url> has been Start()ed, waits for it to finish, forgets it
+    // (a later open reads the file again) and returns true with the result
+    // in <result>.  Otherwise, returns false.
+    static bool Take (const QString &url, Result *result);
+};
+
+
+#endif  // kpDocumentPrefetch_H
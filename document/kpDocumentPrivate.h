@@ -30,6 +30,9 @@
 #define kpDocumentPrivate_H
 
 
+#include <kpDocumentSaveSettings.h>
+
+
 class kpDocumentEnvironment;
 
 
@@ -40,6 +43,8 @@ struct kpDocumentPrivate
     }
 
     kpDocumentEnvironment *environ;
+
+    kpDocumentSaveSettings saveSettings;
 };
 
 
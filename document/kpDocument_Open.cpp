@@ -54,6 +54,7 @@
 #include <kpDocumentEnvironment.h>
 
 #include <kpDocumentMetaInfo.h>
+#include <kpDocumentPrefetch.h>
 #include <kpEffectReduceColors.h>
 #include <kpPixmapFX.h>
 #include <kpTool.h>
@@ -92,8 +93,19 @@ QImage kpDocument::getPixmapFromFile(const QString &url, bool suppressDoesntExis
     if (metaInfo)
         *metaInfo = kpDocumentMetaInfo ();
 
-    if (url.isEmpty ())
+    // (already decoded in the background, if asked for at startup)
+    kpDocumentPrefetch::Result result;
+    if (!kpDocumentPrefetch::Take (url, &result))
+        result = kpDocumentPrefetch::Read (url);
+
+#if DEBUG_KP_DOCUMENT
+    kDebug () << "\terror=" << result.error
+              << "mimetype=" << result.saveExt;
+#endif
+
+    switch (result.error)
     {
+    case kpDocumentPrefetch::Result::NoURL:
         if (!suppressDoesntExistDialog)
         {
             // TODO: Use "Cannot" instead of "Could not" in all dialogs in KolourPaint.
@@ -105,26 +117,8 @@ QImage kpDocument::getPixmapFromFile(const QString &url, bool suppressDoesntExis
         }
 
         return QImage ();
-    }
-
-    QString detectedMimeType = QString(QImageReader::imageFormat (url));
 
-    QImage image;
-    if (!detectedMimeType.isEmpty())
-    {
-
-    	if (saveOptions)
-            *saveOptions = detectedMimeType;
-
-    #if DEBUG_KP_DOCUMENT
-        kDebug () << "\ttempFile=" << tempFile;
-        kDebug () << "\tmimetype=" << detectedMimeType;
-        kDebug () << "\tsrc=" << url.path ();
-    #endif
-
-        image = QImage (url);
-    }
-    else {
+    case kpDocumentPrefetch::Result::UnknownMimeType:
         // TODO: <detectedMimeType> might be different.
         //       Should we feed it into QImage to solve this problem?
         //
@@ -141,32 +135,34 @@ QImage kpDocument::getPixmapFromFile(const QString &url, bool suppressDoesntExis
                                 kpUrlFormatter::PrettyFilename (url)));
 
         return QImage ();
-    }
 
-    if (image.isNull ())
-    {
+    case kpDocumentPrefetch::Result::UnsupportedFormat:
+        if (saveOptions)
+            *saveOptions = result.saveExt;
+
         QMessageBox::critical (parent, "Sorry",
                             i18n ("Could not open \"%1\" - unsupported image format.\n"
                                   "The file may be corrupt.",
                                   kpUrlFormatter::PrettyFilename (url)));
         return QImage ();
+
+    default:
+        break;
     }
 
 #if DEBUG_KP_DOCUMENT
-    kDebug () << "\tpixmap: depth=" << image.depth ()
-                << " hasAlphaChannel=" << image.hasAlphaChannel ()
+    kDebug () << "\tpixmap: depth=" << result.image.depth ()
+                << " hasAlphaChannel=" << result.image.hasAlphaChannel ()
                 << endl;
 #endif
 
-    if (metaInfo )
-      getDataFromImage(image, *metaInfo);
+    if (saveOptions)
+        *saveOptions = result.saveExt;
 
-    // make sure we always have Format_ARGB32_Premultiplied as this is the fastest to draw on
-    // and Qt can not draw onto Format_Indexed8 (Qt-4.7)
-    if ( image.format() != QImage::Format_ARGB32_Premultiplied )
-      image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    if (metaInfo)
+        *metaInfo = result.metaInfo;
 
-    return image;
+    return result.image;
 }
 
 //---------------------------------------------------------------------
@@ -177,6 +173,15 @@ void kpDocument::openNew (const QString &url)
     kDebug () << "kpDocument::openNew (" << url << ")";
 #endif
 
+    // (see NewForOpen())
+    if (m_image->width () != m_constructorWidth ||
+        m_image->height () != m_constructorHeight)
+    {
+        delete m_image;
+        m_image = new kpImage (m_constructorWidth, m_constructorHeight,
+                               QImage::Format_ARGB32_Premultiplied);
+    }
+
     m_image->fill(QColor(Qt::white).rgb());
 
     setURL (url, false/*not from url*/);
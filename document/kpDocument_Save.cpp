@@ -60,11 +60,13 @@
 
 #include <kpColor.h>
 #include <kpColorToolBar.h>
+#include <kpCompositedImageSource.h>
 #include <kpDefs.h>
 #include <kpDocumentEnvironment.h>
 #include <kpDocumentMetaInfo.h>
 #include <kpEffectReduceColors.h>
 #include <kpPixmapFX.h>
+#include <kpStreamingImageWriter.h>
 #include <kpTool.h>
 #include <kpToolToolBar.h>
 #include <kpUrlFormatter.h>
@@ -99,7 +101,8 @@ bool kpDocument::save (bool overwritePrompt, bool lossyPrompt)
 
     return saveAs (m_url, *m_saveExt,
                    overwritePrompt,
-                   lossyPrompt);
+                   lossyPrompt,
+                   d->saveSettings);
 }
 
 //---------------------------------------------------------------------
@@ -111,7 +114,8 @@ bool kpDocument::savePixmapToDevice (const QImage &image,
                                      const kpDocumentMetaInfo &metaInfo,
                                      bool ,
                                      QWidget *,
-                                     bool *userCancelled)
+                                     bool *userCancelled,
+                                     const kpDocumentSaveSettings &saveSettings)
 {
     if (userCancelled)
         *userCancelled = false;
@@ -138,11 +142,11 @@ bool kpDocument::savePixmapToDevice (const QImage &image,
     //
 
 #if DEBUG_KP_DOCUMENT
-    kDebug () << "\tuseSaveOptionsColorDepth=" << useSaveOptionsColorDepth
-              << "current image depth=" << image.depth ()
-              << "save options depth=" << saveOptions.colorDepth ();
+    kDebug () << "\tcurrent image depth=" << image.depth ()
+              << "save settings depth=" << saveSettings.colorDepth ()
+              << "dither=" << saveSettings.dither ();
 #endif
-    QImage imageToSave(image);
+    QImage imageToSave = saveSettings.imageToSave (image);
 
 
     //
@@ -165,8 +169,10 @@ bool kpDocument::savePixmapToDevice (const QImage &image,
     // Save at required quality
     //
 
-    int quality = -1;  // default
-
+    const int quality = saveSettings.writerQuality (type);
+#if DEBUG_KP_DOCUMENT
+    kDebug () << "\tquality=" << quality;
+#endif
 
 #if DEBUG_KP_DOCUMENT
     kDebug () << "\tsaving";
@@ -208,12 +214,32 @@ static void CouldNotSaveDialog (const QString &url, QWidget *parent)
 
 // public static
 bool kpDocument::savePixmapToFile (const QImage &pixmap,
+                                   const QString &url,
+                                   const QString &saveExt,
+                                   const kpDocumentMetaInfo &metaInfo,
+                                   bool overwritePrompt,
+                                   bool lossyPrompt,
+                                   QWidget *parent,
+                                   const kpDocumentSaveSettings &saveSettings)
+{
+    return savePixmapToFile (kpCompositedImageSource (pixmap),
+                             url, saveExt, metaInfo,
+                             overwritePrompt, lossyPrompt,
+                             parent,
+                             saveSettings);
+}
+
+//---------------------------------------------------------------------
+
+// public static
+bool kpDocument::savePixmapToFile (const kpCompositedImageSource &source,
                                    const QString &url,
                                    const QString &saveExt,
                                    const kpDocumentMetaInfo &metaInfo,
                                    bool overwritePrompt,
                                    bool ,
-                                   QWidget *parent)
+                                   QWidget *parent,
+                                   const kpDocumentSaveSettings &saveSettings)
 {
     // TODO: Use KIO::NetAccess:mostLocalURL() for accessing home:/ (and other
     //       such local URLs) for efficiency and because only local writes
@@ -264,10 +290,18 @@ bool kpDocument::savePixmapToFile (const QImage &pixmap,
 		}
 
 		// Write to local temporary file.
-		if (!savePixmapToDevice (pixmap, &atomicFileWriter,
-								 saveExt, metaInfo,
-								 false/*no lossy prompt*/,
-								 parent))
+		const bool saved =
+			kpStreamingImageWriter::IsSupported (saveExt, saveSettings) ?
+				kpStreamingImageWriter::Write (source, &atomicFileWriter,
+											   saveExt, metaInfo,
+											   saveSettings) :
+				savePixmapToDevice (source.image (), &atomicFileWriter,
+									saveExt, metaInfo,
+									false/*no lossy prompt*/,
+									parent,
+									0/*userCancelled*/,
+									saveSettings);
+		if (!saved)
 		{
 			atomicFileWriter.close();
 
@@ -291,22 +325,25 @@ bool kpDocument::savePixmapToFile (const QImage &pixmap,
 bool kpDocument::saveAs (const QString &url,
 						 const QString &saveExt,
                          bool overwritePrompt,
-                         bool lossyPrompt)
+                         bool lossyPrompt,
+                         const kpDocumentSaveSettings &saveSettings)
 {
 #if DEBUG_KP_DOCUMENT
     kDebug () << "kpDocument::saveAs (" << url << ","
                << saveOptions.mimeType () << ")" << endl;
 #endif
 
-    if (kpDocument::savePixmapToFile (imageWithSelection (),
+    if (kpDocument::savePixmapToFile (kpCompositedImageSource (this),
                                       url,
                                       saveExt, *metaInfo (),
                                       overwritePrompt,
                                       lossyPrompt,
-                                      d->environ->dialogParent ()))
+                                      d->environ->dialogParent (),
+                                      saveSettings))
     {
         setURL (url, true/*is from url*/);
         *m_saveExt = saveExt;
+        d->saveSettings = saveSettings;
         m_modified = false;
 
         m_savedAtLeastOnceBefore = true;
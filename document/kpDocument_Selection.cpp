@@ -104,7 +104,7 @@ void kpDocument::setSelection (const kpAbstractSelection &selection)
         // There's no need to uninitialize the old selection
         // (e.g. call disconnect()) since we delete it later.
         connect (m_selection, SIGNAL (changed (const QRect &)),
-                 this, SLOT (slotContentsChanged (const QRect &)));
+                 this, SLOT (slotSelectionChanged (const QRect &)));
 
 
         //
@@ -160,6 +160,17 @@ void kpDocument::setSelection (const kpAbstractSelection &selection)
 
 //---------------------------------------------------------------------
 
+// private slot
+void kpDocument::slotSelectionChanged (const QRect &docRect)
+{
+    if (m_selection && m_selection->hasContent ())
+        slotContentsChanged (docRect);
+    else
+        emit contentsChanged (docRect);
+}
+
+//---------------------------------------------------------------------
+
 // public
 kpImage kpDocument::getSelectedBaseImage () const
 {
@@ -0,0 +1,663 @@
+/*
+   Copyright (c) 2015-2018 Maikel Diaz <ariguanabosoft@gmail.com>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#define DEBUG_KP_STREAMING_IMAGE_WRITER 0
+
+
+#include <kpStreamingImageWriter.h>
+
+#include <string.h>
+
+#include <qbytearray.h>
+#include <qendian.h>
+#include <qimage.h>
+#include <qiodevice.h>
+
+#include <qdebug.h>
+
+#include <kpCompositedImageSource.h>
+#include <kpDocumentMetaInfo.h>
+#include <kpDocumentSaveSettings.h>
+
+#if KP_HAVE_ZLIB
+    #include <zlib.h>
+#endif
+
+//---------------------------------------------------------------------
+
+static void AppendLittleEndian16 (QByteArray *bytes, quint16 value)
+{
+    const quint16 littleEndian = qToLittleEndian (value);
+    bytes->append (reinterpret_cast <const char *> (&littleEndian), 2);
+}
+
+//---------------------------------------------------------------------
+
+static void AppendLittleEndian32 (QByteArray *bytes, quint32 value)
+{
+    const quint32 littleEndian = qToLittleEndian (value);
+    bytes->append (reinterpret_cast <const char *> (&littleEndian), 4);
+}
+
+//---------------------------------------------------------------------
+
+static bool WriteBytes (QIODevice *device, const QByteArray &bytes)
+{
+    return (device->write (bytes) == bytes.size ());
+}
+
+//---------------------------------------------------------------------
+// PNG
+//---------------------------------------------------------------------
+
+#if KP_HAVE_ZLIB
+
+// The most compressed data per IDAT chunk.
+static const int PngIdatBytes = 64 * 1024;
+
+//---------------------------------------------------------------------
+
+static void AppendBigEndian32 (QByteArray *bytes, quint32 value)
+{
+    const quint32 bigEndian = qToBigEndian (value);
+    bytes->append (reinterpret_cast <const char *> (&bigEndian), 4);
+}
+
+//---------------------------------------------------------------------
+
+static bool WritePngChunk (QIODevice *device, const char *type,
+                           const QByteArray &data)
+{
+    QByteArray chunk;
+    chunk.reserve (12 + data.size ());
+
+    AppendBigEndian32 (&chunk, data.size ());
+    chunk.append (type, 4);
+    chunk.append (data);
+
+    // (covers the type and the data)
+    const uLong crc = crc32 (0,
+        reinterpret_cast <const Bytef *> (chunk.constData () + 4),
+        uInt (4 + data.size ()));
+    AppendBigEndian32 (&chunk, quint32 (crc));
+
+    return WriteBytes (device, chunk);
+}
+
+//---------------------------------------------------------------------
+
+static int PngPaethPredictor (int a, int b, int c)
+{
+    const int p = a + b - c;
+    const int pa = qAbs (p - a), pb = qAbs (p - b), pc = qAbs (p - c);
+
+    if (pa <= pb && pa <= pc)
+        return a;
+    else if (pb <= pc)
+        return b;
+    else
+        return c;
+}
+
+//---------------------------------------------------------------------
+
+// Filters <row>, given the unfiltered <prevRow>, with each of the 5 PNG
+// filter types into <candidates> (5 * (1 + <rowBytes>) bytes) and returns
+// the one most likely to compress best, by libpng's heuristic of the
+// smallest sum of absolute (signed) values.
+static const uchar *FilterPngRow (const uchar *row, const uchar *prevRow,
+                                  int rowBytes, int bytesPerPixel,
+                                  uchar *candidates)
+{
+    const uchar *best = 0;
+    quint64 bestSum = 0;
+
+    for (int type = 0; type < 5; type++)
+    {
+        uchar *out = candidates + type * (1 + rowBytes);
+        out [0] = uchar (type);
+
+        quint64 sum = 0;
+        for (int i = 0; i < rowBytes; i++)
+        {
+            const int a = (i >= bytesPerPixel) ? row [i - bytesPerPixel] : 0;
+            const int b = prevRow [i];
+            const int c = (i >= bytesPerPixel) ? prevRow [i - bytesPerPixel] : 0;
+
+            int predicted;
+            switch (type)
+            {
+            case 0: predicted = 0; break;
+            case 1: predicted = a; break;
+            case 2: predicted = b; break;
+            case 3: predicted = (a + b) / 2; break;
+            default: predicted = PngPaethPredictor (a, b, c); break;
+            }
+
+            const uchar value = uchar (row [i] - predicted);
+            out [1 + i] = value;
+            sum += qAbs (int (static_cast <signed char> (value)));
+        }
+
+        if (!best || sum < bestSum)
+        {
+            best = out;
+            bestSum = sum;
+        }
+    }
+
+    return best;
+}
+
+//---------------------------------------------------------------------
+
+// The zlib stream of the image data, written out in IDAT chunks.
+struct PngIdatStream
+{
+    z_stream zs;
+    QByteArray buffer;
+    QIODevice *device;
+};
+
+//---------------------------------------------------------------------
+
+static bool PngIdatDeflate (PngIdatStream *stream,
+                            const uchar *data, int size, int flush)
+{
+    stream->zs.next_in = const_cast <Bytef *> (data);
+    stream->zs.avail_in = uInt (size);
+
+    int ret;
+    do
+    {
+        // Buffer full?
+        if (stream->zs.avail_out == 0)
+        {
+            if (!WritePngChunk (stream->device, "IDAT", stream->buffer))
+                return false;
+
+            stream->zs.next_out = reinterpret_cast <Bytef *> (stream->buffer.data ());
+            stream->zs.avail_out = uInt (stream->buffer.size ());
+        }
+
+        // (Z_BUF_ERROR only means that no progress was possible)
+        ret = deflate (&stream->zs, flush);
+        if (ret == Z_STREAM_ERROR)
+            return false;
+    }
+    while (stream->zs.avail_in > 0 || stream->zs.avail_out == 0 ||
+           (flush == Z_FINISH && ret != Z_STREAM_END));
+
+    if (flush == Z_FINISH)
+    {
+        const int used = stream->buffer.size () - int (stream->zs.avail_out);
+        if (used > 0 &&
+            !WritePngChunk (stream->device, "IDAT", stream->buffer.left (used)))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//---------------------------------------------------------------------
+
+static bool WritePngMetaInfo (QIODevice *device,
+                              const kpDocumentMetaInfo &metaInfo)
+{
+    if (metaInfo.dotsPerMeterX () > 0 && metaInfo.dotsPerMeterY () > 0)
+    {
+        QByteArray physical;
+        AppendBigEndian32 (&physical, metaInfo.dotsPerMeterX ());
+        AppendBigEndian32 (&physical, metaInfo.dotsPerMeterY ());
+        physical.append (char (1));  // unit: meter
+        if (!WritePngChunk (device, "pHYs", physical))
+            return false;
+    }
+
+    if (!metaInfo.offset ().isNull ())
+    {
+        QByteArray offset;
+        AppendBigEndian32 (&offset, quint32 (metaInfo.offset ().x ()));
+        AppendBigEndian32 (&offset, quint32 (metaInfo.offset ().y ()));
+        offset.append (char (0));  // unit: pixel
+        if (!WritePngChunk (device, "oFFs", offset))
+            return false;
+    }
+
+    foreach (const QString &key, metaInfo.textKeys ())
+    {
+        const QByteArray keyword = key.toLatin1 ().left (79);
+        if (keyword.isEmpty ())
+            continue;
+
+        const QString text = metaInfo.text (key);
+
+        QByteArray data = keyword;
+        data.append ('\0');
+
+        if (QString::fromLatin1 (text.toLatin1 ()) == text)
+        {
+            data.append (text.toLatin1 ());
+            if (!WritePngChunk (device, "tEXt", data))
+                return false;
+        }
+        else
+        {
+            // Uncompressed, with no language tag or translated keyword.
+            data.append ('\0');
+            data.append ('\0');
+            data.append ('\0');
+            data.append ('\0');
+            data.append (text.toUtf8 ());
+            if (!WritePngChunk (device, "iTXt", data))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+//---------------------------------------------------------------------
+
+static bool WritePng (const kpCompositedImageSource &source,
+                      QIODevice *device,
+                      const kpDocumentMetaInfo &metaInfo,
+                      const kpDocumentSaveSettings &saveSettings)
+{
+    const int width = source.width (), height = source.height ();
+
+    // Like Qt's writer, leave out the alpha channel if there is nothing in
+    // it, which saves a quarter of the data.
+    const bool opaque = source.isOpaque ();
+    const int bytesPerPixel = opaque ? 3 : 4;
+
+    if (!WriteBytes (device, QByteArray ("\x89PNG\r\n\x1a\n", 8)))
+        return false;
+
+    QByteArray header;
+    AppendBigEndian32 (&header, width);
+    AppendBigEndian32 (&header, height);
+    header.append (char (8));  // bit depth
+    header.append (char (opaque ? 2 : 6));  // color type: RGB or RGBA
+    header.append (char (0));  // compression method: deflate
+    header.append (char (0));  // filter method: adaptive
+    header.append (char (0));  // interlace method: none
+    if (!WritePngChunk (device, "IHDR", header))
+        return false;
+
+    if (!WritePngMetaInfo (device, metaInfo))
+        return false;
+
+
+    PngIdatStream stream;
+    memset (&stream.zs, 0, sizeof (stream.zs));
+    if (deflateInit (&stream.zs,
+            saveSettings.compression () >= 0 ?
+                saveSettings.compression () :
+                Z_DEFAULT_COMPRESSION) != Z_OK)
+    {
+        return false;
+    }
+
+    stream.device = device;
+    stream.buffer = QByteArray (PngIdatBytes, 0);
+    stream.zs.next_out = reinterpret_cast <Bytef *> (stream.buffer.data ());
+    stream.zs.avail_out = uInt (stream.buffer.size ());
+
+    const int rowBytes = width * bytesPerPixel;
+    QByteArray rowBuffer (rowBytes, 0), prevRowBuffer (rowBytes, 0),
+               candidates (5 * (1 + rowBytes), 0);
+    uchar *row = reinterpret_cast <uchar *> (rowBuffer.data ());
+    uchar *prevRow = reinterpret_cast <uchar *> (prevRowBuffer.data ());
+
+    bool ok = true;
+
+    const int bandHeight = source.bandHeight ();
+    for (int top = 0; ok && top < height; top += bandHeight)
+    {
+        const QImage band = source.band (top, bandHeight);
+
+        for (int y = 0; ok && y < band.height (); y++)
+        {
+            const QRgb *src = reinterpret_cast <const QRgb *> (band.constScanLine (y));
+
+            uchar *dest = row;
+            for (int x = 0; x < width; x++)
+            {
+                // PNG alpha is not premultiplied.
+                const QRgb pixel = qUnpremultiply (src [x]);
+
+                *dest++ = uchar (qRed (pixel));
+                *dest++ = uchar (qGreen (pixel));
+                *dest++ = uchar (qBlue (pixel));
+                if (!opaque)
+                    *dest++ = uchar (qAlpha (pixel));
+            }
+
+            const uchar *filtered = FilterPngRow (row, prevRow,
+                rowBytes, bytesPerPixel,
+                reinterpret_cast <uchar *> (candidates.data ()));
+            ok = PngIdatDeflate (&stream, filtered, 1 + rowBytes, Z_NO_FLUSH);
+
+            qSwap (row, prevRow);
+        }
+    }
+
+    if (ok)
+        ok = PngIdatDeflate (&stream, 0, 0, Z_FINISH);
+
+    deflateEnd (&stream.zs);
+
+    return (ok && WritePngChunk (device, "IEND", QByteArray ()));
+}
+
+#endif  // KP_HAVE_ZLIB
+
+//---------------------------------------------------------------------
+// PPM
+//---------------------------------------------------------------------
+
+static bool WritePpm (const kpCompositedImageSource &source, QIODevice *device)
+{
+    const int width = source.width (), height = source.height ();
+
+    if (!WriteBytes (device,
+            QString::fromLatin1 ("P6\n%1 %2\n255\n").arg (width).arg (height).toLatin1 ()))
+    {
+        return false;
+    }
+
+    QByteArray row (width * 3, 0);
+
+    const int bandHeight = source.bandHeight ();
+    for (int top = 0; top < height; top += bandHeight)
+    {
+        const QImage band = source.band (top, bandHeight);
+
+        for (int y = 0; y < band.height (); y++)
+        {
+            const QRgb *src = reinterpret_cast <const QRgb *> (band.constScanLine (y));
+
+            uchar *dest = reinterpret_cast <uchar *> (row.data ());
+            for (int x = 0; x < width; x++)
+            {
+                // (alpha is dropped as Qt does when converting to RGB32)
+                const QRgb pixel = qUnpremultiply (src [x]);
+
+                *dest++ = uchar (qRed (pixel));
+                *dest++ = uchar (qGreen (pixel));
+                *dest++ = uchar (qBlue (pixel));
+            }
+
+            if (!WriteBytes (device, row))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+//---------------------------------------------------------------------
+// TIFF
+//---------------------------------------------------------------------
+
+// The size of each (uncompressed) strip.
+static const quint32 TiffStripBytes = 64 * 1024;
+
+enum TiffType
+{
+    TiffShort = 3,
+    TiffLong = 4,
+    TiffRational = 5
+};
+
+//---------------------------------------------------------------------
+
+static void AppendTiffEntry (QByteArray *ifd,
+                             quint16 tag, TiffType type, quint32 count,
+                             quint32 valueOrOffset)
+{
+    AppendLittleEndian16 (ifd, tag);
+    AppendLittleEndian16 (ifd, quint16 (type));
+    AppendLittleEndian32 (ifd, count);
+
+    // A single SHORT is left-justified in the 4 value bytes.
+    if (type == TiffShort && count == 1)
+    {
+        AppendLittleEndian16 (ifd, quint16 (valueOrOffset));
+        AppendLittleEndian16 (ifd, 0);
+    }
+    else
+    {
+        AppendLittleEndian32 (ifd, valueOrOffset);
+    }
+}
+
+//---------------------------------------------------------------------
+
+static bool WriteTiff (const kpCompositedImageSource &source,
+                       QIODevice *device,
+                       const kpDocumentMetaInfo &metaInfo)
+{
+    const quint32 width = source.width (), height = source.height ();
+    const quint32 rowBytes = width * 4;
+
+    const quint32 rowsPerStrip = qMax (quint32 (1), TiffStripBytes / rowBytes);
+    const quint32 numStrips = (height + rowsPerStrip - 1) / rowsPerStrip;
+
+    const bool hasResolution =
+        (metaInfo.dotsPerMeterX () > 0 && metaInfo.dotsPerMeterY () > 0);
+
+
+    //
+    // Lay out the file: header, IFD, the values that do not fit in their
+    // IFD entries and then the strips, one after the other.  As the strips
+    // are uncompressed, all of their offsets are known in advance.
+    //
+
+    const quint16 numEntries = hasResolution ? 14 : 11;
+
+    quint32 offset = 8 + 2 + numEntries * 12 + 4;
+
+    const quint32 bitsPerSampleOffset = offset;
+    offset += 4 * 2;
+
+    const quint32 xResolutionOffset = offset,
+                  yResolutionOffset = offset + 8;
+    if (hasResolution)
+        offset += 2 * 8;
+
+    const quint32 stripOffsetsOffset = offset,
+                  stripByteCountsOffset = offset + numStrips * 4;
+    if (numStrips > 1)
+        offset += numStrips * 8;
+
+    const quint32 dataOffset = offset;
+
+    // Classic TIFF has 32-bit offsets.
+    if (quint64 (dataOffset) + quint64 (rowBytes) * height > 0xFFFFFFFFu)
+    {
+        qCritical () << "kpStreamingImageWriter: image too big for TIFF";
+        return false;
+    }
+
+
+    QByteArray prefix;
+    prefix.reserve (dataOffset);
+
+    prefix.append ("II", 2);  // little endian
+    AppendLittleEndian16 (&prefix, 42);
+    AppendLittleEndian32 (&prefix, 8);  // IFD offset
+
+    // (entries must be sorted by tag)
+    AppendLittleEndian16 (&prefix, numEntries);
+    AppendTiffEntry (&prefix, 256/*ImageWidth*/, TiffLong, 1, width);
+    AppendTiffEntry (&prefix, 257/*ImageLength*/, TiffLong, 1, height);
+    AppendTiffEntry (&prefix, 258/*BitsPerSample*/, TiffShort, 4, bitsPerSampleOffset);
+    AppendTiffEntry (&prefix, 259/*Compression*/, TiffShort, 1, 1/*none*/);
+    AppendTiffEntry (&prefix, 262/*PhotometricInterpretation*/, TiffShort, 1, 2/*RGB*/);
+    AppendTiffEntry (&prefix, 273/*StripOffsets*/, TiffLong, numStrips,
+        numStrips == 1 ? dataOffset : stripOffsetsOffset);
+    AppendTiffEntry (&prefix, 277/*SamplesPerPixel*/, TiffShort, 1, 4);
+    AppendTiffEntry (&prefix, 278/*RowsPerStrip*/, TiffLong, 1, rowsPerStrip);
+    AppendTiffEntry (&prefix, 279/*StripByteCounts*/, TiffLong, numStrips,
+        numStrips == 1 ? rowBytes * height : stripByteCountsOffset);
+    if (hasResolution)
+    {
+        AppendTiffEntry (&prefix, 282/*XResolution*/, TiffRational, 1, xResolutionOffset);
+        AppendTiffEntry (&prefix, 283/*YResolution*/, TiffRational, 1, yResolutionOffset);
+    }
+    AppendTiffEntry (&prefix, 284/*PlanarConfiguration*/, TiffShort, 1, 1/*chunky*/);
+    if (hasResolution)
+        AppendTiffEntry (&prefix, 296/*ResolutionUnit*/, TiffShort, 1, 3/*cm*/);
+    AppendTiffEntry (&prefix, 338/*ExtraSamples*/, TiffShort, 1, 1/*associated alpha*/);
+    AppendLittleEndian32 (&prefix, 0);  // no next IFD
+
+    for (int i = 0; i < 4; i++)
+        AppendLittleEndian16 (&prefix, 8);
+
+    if (hasResolution)
+    {
+        // (dots per centimeter)
+        AppendLittleEndian32 (&prefix, metaInfo.dotsPerMeterX ());
+        AppendLittleEndian32 (&prefix, 100);
+        AppendLittleEndian32 (&prefix, metaInfo.dotsPerMeterY ());
+        AppendLittleEndian32 (&prefix, 100);
+    }
+
+    if (numStrips > 1)
+    {
+        for (quint32 strip = 0; strip < numStrips; strip++)
+            AppendLittleEndian32 (&prefix, dataOffset + strip * rowsPerStrip * rowBytes);
+
+        for (quint32 strip = 0; strip < numStrips; strip++)
+        {
+            AppendLittleEndian32 (&prefix,
+                qMin (rowsPerStrip, height - strip * rowsPerStrip) * rowBytes);
+        }
+    }
+
+    Q_ASSERT (quint32 (prefix.size ()) == dataOffset);
+
+    if (!WriteBytes (device, prefix))
+        return false;
+
+
+    //
+    // Write the strips
+    //
+
+    QByteArray row (rowBytes, 0);
+
+    const int bandHeight = source.bandHeight ();
+    for (int top = 0; top < int (height); top += bandHeight)
+    {
+        const QImage band = source.band (top, bandHeight);
+
+        for (int y = 0; y < band.height (); y++)
+        {
+            const QRgb *src = reinterpret_cast <const QRgb *> (band.constScanLine (y));
+
+            // (associated alpha is premultiplied, like the band)
+            uchar *dest = reinterpret_cast <uchar *> (row.data ());
+            for (quint32 x = 0; x < width; x++)
+            {
+                *dest++ = uchar (qRed (src [x]));
+                *dest++ = uchar (qGreen (src [x]));
+                *dest++ = uchar (qBlue (src [x]));
+                *dest++ = uchar (qAlpha (src [x]));
+            }
+
+            if (!WriteBytes (device, row))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+//---------------------------------------------------------------------
+
+// public static
+bool kpStreamingImageWriter::IsSupported (const QString &saveExt,
+        const kpDocumentSaveSettings &saveSettings)
+{
+    // Reducing the colors needs the whole image.
+    if (saveSettings.colorDepth () != 0 && saveSettings.colorDepth () != 32)
+        return false;
+
+    const QString ext = saveExt.toLower ();
+
+#if KP_HAVE_ZLIB
+    if (ext == QLatin1String ("png"))
+        return true;
+#endif
+
+    return (ext == QLatin1String ("ppm") ||
+            ext == QLatin1String ("tif") ||
+            ext == QLatin1String ("tiff"));
+}
+
+//---------------------------------------------------------------------
+
+// public static
+bool kpStreamingImageWriter::Write (const kpCompositedImageSource &source,
+        QIODevice *device,
+        const QString &saveExt,
+        const kpDocumentMetaInfo &metaInfo,
+        const kpDocumentSaveSettings &saveSettings)
+{
+    const QString ext = saveExt.toLower ();
+
+#if DEBUG_KP_STREAMING_IMAGE_WRITER
+    qDebug () << "kpStreamingImageWriter::Write() ext=" << ext
+              << " size=" << source.width () << "x" << source.height ()
+              << " bandHeight=" << source.bandHeight ();
+#endif
+
+    if (source.width () <= 0 || source.height () <= 0)
+        return false;
+
+#if KP_HAVE_ZLIB
+    if (ext == QLatin1String ("png"))
+        return ::WritePng (source, device, metaInfo, saveSettings);
+#else
+    Q_UNUSED (saveSettings);
+#endif
+
+    if (ext == QLatin1String ("ppm"))
+        return ::WritePpm (source, device);
+
+    if (ext == QLatin1String ("tif") || ext == QLatin1String ("tiff"))
+        return ::WriteTiff (source, device, metaInfo);
+
+    return false;
+}
+
+//---------------------------------------------------------------------
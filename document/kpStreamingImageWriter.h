@@ -0,0 +1,73 @@
+/*
+   Copyright (c) 2015-2018 Maikel Diaz <ariguanabosoft@gmail.com>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef kpStreamingImageWriter_H
+#define kpStreamingImageWriter_H
+
+
+#include <qstring.h>
+
+
+class QIODevice;
+
+class kpCompositedImageSource;
+class kpDocumentMetaInfo;
+class kpDocumentSaveSettings;
+
+
+//
+// Encodes a kpCompositedImageSource band by band, so that saving never
+// needs a second copy of the image (as going through QImage::save() does,
+// since Qt's writers convert the whole image to their own format first).
+//
+// Supported, if the save settings do not reduce the color depth:
+//
+//   PNG   8-bit RGBA, with pHYs, oFFs and text chunks from the meta info.
+//         Only if built with zlib (KP_HAVE_ZLIB).
+//   PPM   Binary RGB (P6), as Qt writes it.
+//   TIFF  Uncompressed RGBA strips with associated alpha, as Qt writes
+//         premultiplied images.
+//
+// Other formats (e.g. JPEG, which QImageWriter can only be given whole)
+// must still be saved with kpDocument::savePixmapToDevice().
+//
+class kpStreamingImageWriter
+{
+public:
+    static bool IsSupported (const QString &saveExt,
+                             const kpDocumentSaveSettings &saveSettings);
+
+    // Returns false if <source> could not be written to <device>.
+    static bool Write (const kpCompositedImageSource &source,
+                       QIODevice *device,
+                       const QString &saveExt,
+                       const kpDocumentMetaInfo &metaInfo,
+                       const kpDocumentSaveSettings &saveSettings);
+};
+
+
+#endif  // kpStreamingImageWriter_H
@@ -31,6 +31,7 @@
 #include <kpCommandEnvironment.h>
 
 #include <kpColorToolBar.h>
+#include <kpCommandHistory.h>
 #include <kpDocument.h>
 #include <kpMainWindow.h>
 #include <kpImageSelectionTransparency.h>
@@ -73,6 +74,14 @@ void kpCommandEnvironment::somethingBelowTheCursorChanged () const
     tool->somethingBelowTheCursorChanged ();
 }
 
+// public
+void kpCommandEnvironment::commandSizeChanged (const kpCommand *command) const
+{
+    kpCommandHistory *commandHistory = mainWindow ()->commandHistory ();
+    if (commandHistory)
+        commandHistory->commandSizeChanged (command);
+}
+
 
 // public
 kpImageSelectionTransparency kpCommandEnvironment::imageSelectionTransparency () const
@@ -33,6 +33,7 @@
 #include <kpEnvironmentBase.h>
 
 
+class kpCommand;
 class kpMainWindow;
 class kpImageSelectionTransparency;
 class kpTextStyle;
@@ -54,6 +55,11 @@ public:
 
     void somethingBelowTheCursorChanged () const;
 
+    // Tells the command history that <command>'s size() has changed since
+    // it was added e.g. because it finished shrinking its undo data in the
+    // background.
+    void commandSizeChanged (const kpCommand *command) const;
+
 
     // Sets the foreground and background drawing colors in the UI.
     void setColor (int which, const kpColor &color) const;
@@ -0,0 +1,136 @@
+/*
+   Copyright (c) 2015-2018 Maikel Diaz <ariguanabosoft@gmail.com>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <kpLatencyStats.h>
+
+#include <algorithm>
+
+#include <qmath.h>
+#include <qvector.h>
+
+
+static bool Enabled = false;
+
+static QVector <qint64> Samples [kpLatencyStats::NumPhases];
+
+
+// public static
+QString kpLatencyStats::PhaseName (Phase phase)
+{
+    switch (phase)
+    {
+    case Draw:
+        return QLatin1String ("draw");
+    case ViewUpdate:
+        return QLatin1String ("viewUpdate");
+    case Paint:
+        return QLatin1String ("paint");
+    default:
+        return QString ();
+    }
+}
+
+//---------------------------------------------------------------------
+
+// public static
+bool kpLatencyStats::IsEnabled ()
+{
+    return ::Enabled;
+}
+
+//---------------------------------------------------------------------
+
+// public static
+void kpLatencyStats::SetEnabled (bool yes)
+{
+    ::Enabled = yes;
+}
+
+//---------------------------------------------------------------------
+
+// public static
+void kpLatencyStats::AddSample (Phase phase, qint64 nsecs)
+{
+    Q_ASSERT (phase >= 0 && phase < NumPhases);
+
+    ::Samples [phase].append (nsecs);
+}
+
+//---------------------------------------------------------------------
+
+// public static
+void kpLatencyStats::Clear ()
+{
+    for (int i = 0; i < NumPhases; i++)
+        ::Samples [i].clear ();
+}
+
+//---------------------------------------------------------------------
+
+// public static
+int kpLatencyStats::SampleCount (Phase phase)
+{
+    Q_ASSERT (phase >= 0 && phase < NumPhases);
+
+    return ::Samples [phase].size ();
+}
+
+//---------------------------------------------------------------------
+
+// public static
+qint64 kpLatencyStats::Percentile (Phase phase, double percent)
+{
+    Q_ASSERT (phase >= 0 && phase < NumPhases);
+
+    QVector <qint64> samples = ::Samples [phase];
+    if (samples.isEmpty ())
+        return 0;
+
+    // Nearest rank.
+    int rank = qCeil (percent / 100.0 * samples.size ()) - 1;
+    rank = qBound (0, rank, samples.size () - 1);
+
+    std::nth_element (samples.begin (), samples.begin () + rank, samples.end ());
+    return samples [rank];
+}
+
+//---------------------------------------------------------------------
+
+
+kpLatencyTimer::kpLatencyTimer (kpLatencyStats::Phase phase)
+    : m_phase (phase),
+      m_enabled (kpLatencyStats::IsEnabled ())
+{
+    if (m_enabled)
+        m_timer.start ();
+}
+
+kpLatencyTimer::~kpLatencyTimer ()
+{
+    if (m_enabled)
+        kpLatencyStats::AddSample (m_phase, m_timer.nsecsElapsed ());
+}
@@ -0,0 +1,96 @@
+/*
+   Copyright (c) 2015-2018 Maikel Diaz <ariguanabosoft@gmail.com>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef kpLatencyStats_H
+#define kpLatencyStats_H
+
+
+#include <qelapsedtimer.h>
+#include <qglobal.h>
+#include <qstring.h>
+
+
+//
+// Collects how long the phases of reacting to input take, for reporting
+// by kpInputReplayer.
+//
+// Collection is off by default, in which case timing a phase costs only
+// the check of a flag.  Only use from the GUI thread.
+//
+class kpLatencyStats
+{
+public:
+    enum Phase
+    {
+        Draw,        // kpTool drawing in response to input
+        ViewUpdate,  // kpViewManager scheduling view updates
+        Paint,       // kpView::paintEvent()
+
+        NumPhases
+    };
+
+    static QString PhaseName (Phase phase);
+
+    static bool IsEnabled ();
+    static void SetEnabled (bool yes = true);
+
+    static void AddSample (Phase phase, qint64 nsecs);
+    static void Clear ();
+
+    static int SampleCount (Phase phase);
+
+    // Returns the time, in nanoseconds, that <percent>% of the samples of
+    // <phase> took at most (e.g. 50 for the median).  Returns 0 if there
+    // are no samples.
+    static qint64 Percentile (Phase phase, double percent);
+};
+
+
+//
+// Adds the time from construction to destruction to kpLatencyStats, as a
+// sample of <phase>.  Allocate it on the stack:
+//
+//     void kpView::paintEvent (QPaintEvent *e)
+//     {
+//         kpLatencyTimer latencyTimer (kpLatencyStats::Paint);
+//         ...
+//     }
+//
+class kpLatencyTimer
+{
+public:
+    kpLatencyTimer (kpLatencyStats::Phase phase);
+    ~kpLatencyTimer ();
+
+private:
+    kpLatencyStats::Phase m_phase;
+    bool m_enabled;
+    QElapsedTimer m_timer;
+};
+
+
+#endif  // kpLatencyStats_H
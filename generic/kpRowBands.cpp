@@ -0,0 +1,60 @@
+/*
+   Copyright (c) 2015-2018 Maikel Diaz <ariguanabosoft@gmail.com>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <kpRowBands.h>
+
+#include <QThread>
+
+
+// public static
+QList <kpRowBand> kpRowBands::Split (int numRows, int minRowsPerBand)
+{
+    QList <kpRowBand> bands;
+
+    if (numRows <= 0)
+        return bands;
+
+    if (minRowsPerBand < 1)
+        minRowsPerBand = 1;
+
+    // A few bands per thread so that a thread that is descheduled does not
+    // hold everyone else up.
+    const int maxBands = qMax (1, QThread::idealThreadCount () * 4);
+
+    const int rowsPerBand =
+        qMax (minRowsPerBand, (numRows + maxBands - 1) / maxBands);
+
+    for (int top = 0; top < numRows; top += rowsPerBand)
+    {
+        kpRowBand band;
+        band.top = top;
+        band.bottom = qMin (numRows, top + rowsPerBand);
+        bands.append (band);
+    }
+
+    return bands;
+}
@@ -0,0 +1,69 @@
+/*
+   Copyright (c) 2015-2018 Maikel Diaz <ariguanabosoft@gmail.com>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef kpRowBands_H
+#define kpRowBands_H
+
+
+#include <QList>
+
+
+// A range of rows [top, bottom) of an image.
+struct kpRowBand
+{
+    int top;
+    int bottom;
+};
+
+
+//
+// Splits the rows of an image into bands that can be processed
+// independently by worker threads e.g.:
+//
+//     struct MyBandWorker
+//     {
+//         typedef void result_type;
+//         void operator() (const kpRowBand &band) const { ... }
+//     };
+//
+//     QList <kpRowBand> bands = kpRowBands::Split (image.height ());
+//     QtConcurrent::blockingMap (bands, MyBandWorker (...));
+//
+// Small images are returned as a single band, so they are not penalized by
+// thread scheduling overhead.
+//
+class kpRowBands
+{
+public:
+    // Returns bands covering rows [0, <numRows>), each at least
+    // <minRowsPerBand> rows high (except possibly the last), and about
+    // a few per available thread.
+    static QList <kpRowBand> Split (int numRows, int minRowsPerBand = 64);
+};
+
+
+#endif  // kpRowBands_H
@@ -0,0 +1,95 @@
+/*
+   Copyright (c) 2015-2018 Maikel Diaz <ariguanabosoft@gmail.com>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <kpStartupTimes.h>
+
+#include <qelapsedtimer.h>
+#include <qtextstream.h>
+
+#include <stdio.h>
+
+
+static bool Enabled = false;
+static bool FirstPaintMarked = false;
+
+static QElapsedTimer Clock;
+static qint64 LastMarkMSecs = 0;
+
+
+// public static
+void kpStartupTimes::Start ()
+{
+    ::Clock.start ();
+    ::LastMarkMSecs = 0;
+}
+
+//---------------------------------------------------------------------
+
+// public static
+bool kpStartupTimes::IsEnabled ()
+{
+    return ::Enabled;
+}
+
+//---------------------------------------------------------------------
+
+// public static
+void kpStartupTimes::SetEnabled (bool yes)
+{
+    ::Enabled = yes;
+}
+
+//---------------------------------------------------------------------
+
+// public static
+void kpStartupTimes::Mark (const QString &phase)
+{
+    if (!::Enabled || !::Clock.isValid ())
+        return;
+
+    const qint64 msecs = ::Clock.elapsed ();
+
+    QTextStream err (stderr);
+    err << "startup: " << qSetFieldWidth (6) << msecs << qSetFieldWidth (0)
+        << " ms (+" << (msecs - ::LastMarkMSecs) << " ms) " << phase << "\n";
+
+    ::LastMarkMSecs = msecs;
+}
+
+//---------------------------------------------------------------------
+
+// public static
+void kpStartupTimes::MarkFirstPaint ()
+{
+    if (!::Enabled || ::FirstPaintMarked)
+        return;
+
+    ::FirstPaintMarked = true;
+    Mark (QLatin1String ("first paint"));
+}
+
+//---------------------------------------------------------------------
@@ -0,0 +1,61 @@
+/*
+   Copyright (c) 2015-2018 Maikel Diaz <ariguanabosoft@gmail.com>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef kpStartupTimes_H
+#define kpStartupTimes_H
+
+
+#include <qstring.h>
+
+
+//
+// Reports how long the phases of starting up take, from main() to the
+// first paint of a document, and for each main window created (see
+// kpMainWindow::init()).
+//
+// Reporting is off by default (see main.cpp's --startup-times), in which
+// case marking a phase costs only the check of a flag.
+//
+class kpStartupTimes
+{
+public:
+    // Starts the clock.  Call first thing in main().
+    static void Start ();
+
+    static bool IsEnabled ();
+    static void SetEnabled (bool yes = true);
+
+    // Reports, to standard error, that <phase> has just finished, with
+    // the time since the previous mark and since Start().
+    static void Mark (const QString &phase);
+
+    // Mark()s the first paint of a document, only the first time.
+    static void MarkFirstPaint ();
+};
+
+
+#endif  // kpStartupTimes_H
@@ -4,11 +4,18 @@
 #
 #-------------------------------------------------
 
-QT       += core gui dbus
+QT       += core gui dbus concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 greaterThan(QT_MAJOR_VERSION, 4): QT += printsupport
 
+# zlib lets PNGs be saved a band at a time (see kpStreamingImageWriter)
+packagesExist(zlib) {
+    CONFIG += link_pkgconfig
+    PKGCONFIG += zlib
+    DEFINES += KP_HAVE_ZLIB=1
+}
+
 TARGET = ikPaint
 TEMPLATE = app
 
@@ -75,6 +82,7 @@ HEADERS += \
     utl/kselectaction.h \
     utl/kactioncollection.h \
     utl/qqolorbutton.h \
+    kpThumbnail.h \
     kpViewScrollableContainer.h \
     cursors/kpCursorLightCross.h \
     cursors/kpCursorProvider.h \
@@ -86,15 +94,22 @@ HEADERS += \
     dialogs/imagelib/transforms/kpTransformSkewDialog.h \
     dialogs/kpColorSimilarityDialog.h \
     dialogs/kpDocumentSaveOptionsPreviewDialog.h \
+    dialogs/kpDocumentSaveSettingsDialog.h \
+    document/kpCompositedImageSource.h \
     document/kpDocument.h \
+    document/kpDocumentPrefetch.h \
     document/kpDocumentPrivate.h \
+    document/kpStreamingImageWriter.h \
     environments/commands/kpCommandEnvironment.h \
     environments/dialogs/imagelib/transforms/kpTransformDialogEnvironment.h \
     environments/document/kpDocumentEnvironment.h \
     environments/kpEnvironmentBase.h \
     environments/tools/kpToolEnvironment.h \
     environments/tools/selection/kpToolSelectionEnvironment.h \
+    generic/kpLatencyStats.h \
+    generic/kpRowBands.h \
     generic/kpSetOverrideCursorSaver.h \
+    generic/kpStartupTimes.h \
     generic/kpWidgetMapper.h \
     generic/widgets/kpResizeSignallingLabel.h \
     generic/widgets/kpSubWindow.h \
@@ -109,8 +124,10 @@ HEADERS += \
     imagelib/effects/kpEffectToneEnhance.h \
     imagelib/kpColor.h \
     imagelib/kpDocumentMetaInfo.h \
+    imagelib/kpDocumentSaveSettings.h \
     imagelib/kpFloodFill.h \
     imagelib/kpImage.h \
+    imagelib/kpImageDelta.h \
     imagelib/kpPainter.h \
     imagelib/transforms/kpTransformAutoCrop.h \
     imagelib/transforms/kpTransformCrop.h \
@@ -133,6 +150,8 @@ HEADERS += \
     lgpl/generic/kpUrlFormatter.h \
     lgpl/generic/widgets/kpColorCellsBase.h \
     lgpl/kolourpaint_lgpl_export.h \
+    mainWindow/kpInputRecorder.h \
+    mainWindow/kpInputReplayer.h \
     mainWindow/kpMainWindow.h \
     mainWindow/kpMainWindowPrivate.h \
     pixmapfx/kpPixmapFX.h \
@@ -168,6 +187,8 @@ HEADERS += \
     tools/selection/text/kpToolTextPrivate.h \
     utl/kdialog.h \
     utl/tools.h \
+    views/kpThumbnailCache.h \
+    views/kpThumbnailView.h \
     views/kpView.h \
     views/kpViewPrivate.h \
     views/kpZoomedView.h \
@@ -220,9 +241,11 @@ HEADERS += \
     commands/kpCommand.h \
     commands/kpCommandHistory.h \
     commands/kpCommandHistoryBase.h \
+    commands/kpCommandImageStore.h \
     commands/kpCommandSize.h \
     commands/kpMacroCommand.h \
     commands/kpNamedCommand.h \
+    commands/kpUndoImage.h \
     commands/tools/flow/kpToolFlowCommand.h \
     commands/tools/kpToolColorPickerCommand.h \
     commands/tools/kpToolFloodFillCommand.h \
@@ -254,6 +277,7 @@ SOURCES += utl/kaction.cpp \
     utl/kselectaction.cpp \
     utl/kactioncollection.cpp \
     utl/qqolorbutton.cpp \
+    kpThumbnail.cpp \
     kpViewScrollableContainer.cpp \
     cursors/kpCursorLightCross.cpp \
     cursors/kpCursorProvider.cpp \
@@ -265,17 +289,24 @@ SOURCES += utl/kaction.cpp \
     dialogs/imagelib/transforms/kpTransformSkewDialog.cpp \
     dialogs/kpColorSimilarityDialog.cpp \
     dialogs/kpDocumentSaveOptionsPreviewDialog.cpp \
+    dialogs/kpDocumentSaveSettingsDialog.cpp \
+    document/kpCompositedImageSource.cpp \
     document/kpDocument.cpp \
+    document/kpDocumentPrefetch.cpp \
     document/kpDocument_Open.cpp \
     document/kpDocument_Save.cpp \
     document/kpDocument_Selection.cpp \
+    document/kpStreamingImageWriter.cpp \
     environments/commands/kpCommandEnvironment.cpp \
     environments/dialogs/imagelib/transforms/kpTransformDialogEnvironment.cpp \
     environments/document/kpDocumentEnvironment.cpp \
     environments/kpEnvironmentBase.cpp \
     environments/tools/kpToolEnvironment.cpp \
     environments/tools/selection/kpToolSelectionEnvironment.cpp \
+    generic/kpLatencyStats.cpp \
+    generic/kpRowBands.cpp \
     generic/kpSetOverrideCursorSaver.cpp \
+    generic/kpStartupTimes.cpp \
     generic/kpWidgetMapper.cpp \
     generic/widgets/kpResizeSignallingLabel.cpp \
     generic/widgets/kpSubWindow.cpp \
@@ -291,7 +322,9 @@ SOURCES += utl/kaction.cpp \
     imagelib/kpColor.cpp \
     imagelib/kpColor_Constants.cpp \
     imagelib/kpDocumentMetaInfo.cpp \
+    imagelib/kpDocumentSaveSettings.cpp \
     imagelib/kpFloodFill.cpp \
+    imagelib/kpImageDelta.cpp \
     imagelib/kpPainter.cpp \
     imagelib/transforms/kpTransformAutoCrop.cpp \
     imagelib/transforms/kpTransformCrop.cpp \
@@ -314,6 +347,8 @@ SOURCES += utl/kaction.cpp \
     lgpl/generic/kpColorCollection.cpp \
     lgpl/generic/kpUrlFormatter.cpp \
     lgpl/generic/widgets/kpColorCellsBase.cpp \
+    mainWindow/kpInputRecorder.cpp \
+    mainWindow/kpInputReplayer.cpp \
     mainWindow/kpMainWindow.cpp \
     mainWindow/kpMainWindow_Colors.cpp \
     mainWindow/kpMainWindow_Edit.cpp \
@@ -324,11 +359,13 @@ SOURCES += utl/kaction.cpp \
     mainWindow/kpMainWindow_Text.cpp \
     mainWindow/kpMainWindow_Tools.cpp \
     mainWindow/kpMainWindow_View.cpp \
+    mainWindow/kpMainWindow_View_Thumbnail.cpp \
     mainWindow/kpMainWindow_View_Zoom.cpp \
     pixmapfx/kpPixmapFX_DrawRasterOps.cpp \
     pixmapfx/kpPixmapFX_DrawShapes.cpp \
     pixmapfx/kpPixmapFX_Effects.cpp \
     pixmapfx/kpPixmapFX_GetSetPixmapParts.cpp \
+    pixmapfx/kpPixmapFX_Scale.cpp \
     pixmapfx/kpPixmapFX_Transforms.cpp \
     tools/flow/kpToolBrush.cpp \
     tools/flow/kpToolColorEraser.cpp \
@@ -380,6 +417,8 @@ SOURCES += utl/kaction.cpp \
     tools/selection/text/kpToolText_SelectText.cpp \
     tools/selection/text/kpToolText_TextStyle.cpp \
     utl/kdialog.cpp \
+    views/kpThumbnailCache.cpp \
+    views/kpThumbnailView.cpp \
     views/kpView.cpp \
     views/kpView_Events.cpp \
     views/kpView_Paint.cpp \
@@ -435,9 +474,11 @@ SOURCES += utl/kaction.cpp \
     commands/kpCommand.cpp \
     commands/kpCommandHistory.cpp \
     commands/kpCommandHistoryBase.cpp \
+    commands/kpCommandImageStore.cpp \
     commands/kpCommandSize.cpp \
     commands/kpMacroCommand.cpp \
     commands/kpNamedCommand.cpp \
+    commands/kpUndoImage.cpp \
     commands/tools/flow/kpToolFlowCommand.cpp \
     commands/tools/kpToolColorPickerCommand.cpp \
     commands/tools/kpToolFloodFillCommand.cpp \
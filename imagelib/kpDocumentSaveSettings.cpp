@@ -0,0 +1,193 @@
+/*
+   Copyright (c) 2015-2018 Maikel Diaz <ariguanabosoft@gmail.com>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <kpDocumentSaveSettings.h>
+
+#include <kpEffectReduceColors.h>
+
+
+// public static
+const int kpDocumentSaveSettings::DefaultQuality = -1;
+const int kpDocumentSaveSettings::MinQuality = 0;
+const int kpDocumentSaveSettings::MaxQuality = 100;
+
+const int kpDocumentSaveSettings::DefaultCompression = -1;
+const int kpDocumentSaveSettings::MinCompression = 0;
+const int kpDocumentSaveSettings::MaxCompression = 9;
+
+
+kpDocumentSaveSettings::kpDocumentSaveSettings ()
+    : m_colorDepth (0),
+      m_dither (false),
+      m_quality (DefaultQuality),
+      m_compression (DefaultCompression)
+{
+}
+
+//---------------------------------------------------------------------
+
+// public
+bool kpDocumentSaveSettings::operator== (const kpDocumentSaveSettings &rhs) const
+{
+    return (m_colorDepth == rhs.m_colorDepth &&
+            m_dither == rhs.m_dither &&
+            m_quality == rhs.m_quality &&
+            m_compression == rhs.m_compression);
+}
+
+//---------------------------------------------------------------------
+
+// public
+bool kpDocumentSaveSettings::operator!= (const kpDocumentSaveSettings &rhs) const
+{
+    return !(*this == rhs);
+}
+
+//---------------------------------------------------------------------
+
+// public
+int kpDocumentSaveSettings::colorDepth () const
+{
+    return m_colorDepth;
+}
+
+//---------------------------------------------------------------------
+
+// public
+void kpDocumentSaveSettings::setColorDepth (int depth)
+{
+    if (depth != 1 && depth != 8 && depth != 32)
+        depth = 0;
+
+    m_colorDepth = depth;
+}
+
+//---------------------------------------------------------------------
+
+// public
+bool kpDocumentSaveSettings::dither () const
+{
+    return m_dither;
+}
+
+//---------------------------------------------------------------------
+
+// public
+void kpDocumentSaveSettings::setDither (bool yes)
+{
+    m_dither = yes;
+}
+
+//---------------------------------------------------------------------
+
+// public
+int kpDocumentSaveSettings::quality () const
+{
+    return m_quality;
+}
+
+//---------------------------------------------------------------------
+
+// public
+void kpDocumentSaveSettings::setQuality (int quality)
+{
+    if (quality < 0)
+        m_quality = DefaultQuality;
+    else
+        m_quality = qBound (MinQuality, quality, MaxQuality);
+}
+
+//---------------------------------------------------------------------
+
+// public
+int kpDocumentSaveSettings::compression () const
+{
+    return m_compression;
+}
+
+//---------------------------------------------------------------------
+
+// public
+void kpDocumentSaveSettings::setCompression (int compression)
+{
+    if (compression < 0)
+        m_compression = DefaultCompression;
+    else
+        m_compression = qBound (MinCompression, compression, MaxCompression);
+}
+
+//---------------------------------------------------------------------
+
+// public static
+bool kpDocumentSaveSettings::FormatSupportsQuality (const QString &saveExt)
+{
+    const QString ext = saveExt.toLower ();
+    return (ext == QLatin1String ("jpg") ||
+            ext == QLatin1String ("jpeg") ||
+            ext == QLatin1String ("webp"));
+}
+
+//---------------------------------------------------------------------
+
+// public static
+bool kpDocumentSaveSettings::FormatSupportsCompression (const QString &saveExt)
+{
+    return (saveExt.toLower () == QLatin1String ("png"));
+}
+
+//---------------------------------------------------------------------
+
+// public
+QImage kpDocumentSaveSettings::imageToSave (const QImage &image) const
+{
+    if (m_colorDepth == 0 || m_colorDepth == image.depth ())
+        return image;
+
+    return kpEffectReduceColors::convertImageDepth (image, m_colorDepth, m_dither);
+}
+
+//---------------------------------------------------------------------
+
+// public
+int kpDocumentSaveSettings::writerQuality (const QString &saveExt) const
+{
+    if (FormatSupportsQuality (saveExt))
+        return m_quality;
+
+    if (FormatSupportsCompression (saveExt) && m_compression >= 0)
+    {
+        // Qt's PNG writer has no separate compression knob when going
+        // through QImage::save() - it derives the zlib level from the
+        // quality as "(100 - quality) * 9 / 91".  Pick the largest quality
+        // that still maps to our level.
+        return 100 - (m_compression * 91 + 8) / 9;
+    }
+
+    return -1;  // default
+}
+
+//---------------------------------------------------------------------
@@ -0,0 +1,104 @@
+/*
+   Copyright (c) 2015-2018 Maikel Diaz <ariguanabosoft@gmail.com>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef kpDocumentSaveSettings_H
+#define kpDocumentSaveSettings_H
+
+
+#include <qimage.h>
+#include <qstring.h>
+
+
+//
+// The encoder settings used when writing an image to a file: the color
+// depth to reduce to, JPEG/WebP quality and PNG compression.
+//
+// The file format itself is not part of this - it is still determined
+// by the extension passed alongside (see kpDocument::saveOptions()).
+//
+class kpDocumentSaveSettings
+{
+public:
+    kpDocumentSaveSettings ();
+
+    bool operator== (const kpDocumentSaveSettings &rhs) const;
+    bool operator!= (const kpDocumentSaveSettings &rhs) const;
+
+
+    //
+    // Constants (enforced by methods)
+    //
+
+    static const int DefaultQuality, MinQuality, MaxQuality;
+    static const int DefaultCompression, MinCompression, MaxCompression;
+
+
+    // 0 keeps the depth of the image being saved.
+    // Else, one of 1, 8 or 32 (see kpEffectReduceColors).
+    int colorDepth () const;
+    void setColorDepth (int depth);
+
+    // Whether reducing to colorDepth() dithers.
+    bool dither () const;
+    void setDither (bool yes = true);
+
+    // DefaultQuality (-1) lets the encoder pick.
+    // Else, automatically bounded to MinQuality ... MaxQuality inclusive.
+    //
+    // Only used if FormatSupportsQuality().
+    int quality () const;
+    void setQuality (int quality);
+
+    // zlib level: DefaultCompression (-1) lets the encoder pick.
+    // Else, automatically bounded to MinCompression ... MaxCompression
+    // inclusive.
+    //
+    // Only used if FormatSupportsCompression().
+    int compression () const;
+    void setCompression (int compression);
+
+
+    static bool FormatSupportsQuality (const QString &saveExt);
+    static bool FormatSupportsCompression (const QString &saveExt);
+
+
+    // Returns <image> converted to colorDepth(), ready to be encoded.
+    QImage imageToSave (const QImage &image) const;
+
+    // Returns the "quality" argument to pass to QImage::save() or
+    // QImageWriter::setQuality() for <saveExt>.
+    int writerQuality (const QString &saveExt) const;
+
+private:
+    int m_colorDepth;
+    bool m_dither;
+    int m_quality;
+    int m_compression;
+};
+
+
+#endif  // kpDocumentSaveSettings_H
@@ -0,0 +1,210 @@
+/*
+   Copyright (c) 2015-2018 Maikel Diaz <ariguanabosoft@gmail.com>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <kpImageDelta.h>
+
+#include <climits>
+
+
+// Runs shorter than this are stored as literal words, as a run takes
+// two words itself.
+static const int MinRunLength = 3;
+
+//---------------------------------------------------------------------
+
+// Returns how many of the XORs of <oldRow> and <newRow> from <x>, up to
+// <maxX> (exclusive), equal the one at <x>.  Stops counting at <limit>.
+static inline int RunLength (const quint32 *oldRow, const quint32 *newRow,
+                             int x, int maxX, int limit)
+{
+    const quint32 value = oldRow [x] ^ newRow [x];
+
+    int run = 1;
+    while (x + run < maxX && run < limit &&
+           (oldRow [x + run] ^ newRow [x + run]) == value)
+    {
+        run++;
+    }
+
+    return run;
+}
+
+//---------------------------------------------------------------------
+
+kpImageDelta::kpImageDelta ()
+    : m_format (QImage::Format_Invalid)
+{
+}
+
+//---------------------------------------------------------------------
+
+kpImageDelta::kpImageDelta (const kpImage &oldImage, const kpImage &newImage)
+    : m_format (QImage::Format_Invalid)
+{
+    if (oldImage.isNull () ||
+        oldImage.size () != newImage.size () ||
+        oldImage.format () != newImage.format () ||
+        oldImage.depth () != 32)
+    {
+        return;
+    }
+
+    const int width = oldImage.width ();
+
+    for (int y = 0; y < oldImage.height (); y++)
+    {
+        const quint32 *oldRow =
+            reinterpret_cast <const quint32 *> (oldImage.constScanLine (y));
+        const quint32 *newRow =
+            reinterpret_cast <const quint32 *> (newImage.constScanLine (y));
+
+        int left = 0;
+        while (left < width && oldRow [left] == newRow [left])
+            left++;
+
+        if (left == width)
+            continue;
+
+        int right = width;
+        while (oldRow [right - 1] == newRow [right - 1])
+            right--;
+
+        m_data << quint32 (y) << quint32 (left) << quint32 (right - left);
+        m_changedRect |= QRect (left, y, right - left, 1);
+
+        int x = left;
+        while (x < right)
+        {
+            const int run = ::RunLength (oldRow, newRow, x, right, INT_MAX);
+            if (run >= MinRunLength)
+            {
+                m_data << ((quint32 (run) << 1) | 1)
+                       << (oldRow [x] ^ newRow [x]);
+                x += run;
+                continue;
+            }
+
+            // Literals, up to the next run worth storing as one.
+            const int literalsStart = x;
+            x += run;
+            while (x < right)
+            {
+                const int nextRun = ::RunLength (oldRow, newRow, x, right,
+                                                 MinRunLength);
+                if (nextRun >= MinRunLength)
+                    break;
+
+                x += nextRun;
+            }
+
+            m_data << (quint32 (x - literalsStart) << 1);
+            for (int i = literalsStart; i < x; i++)
+                m_data << (oldRow [i] ^ newRow [i]);
+        }
+    }
+
+    m_data.squeeze ();
+
+    m_size = oldImage.size ();
+    m_format = oldImage.format ();
+}
+
+//---------------------------------------------------------------------
+
+// public
+bool kpImageDelta::isNull () const
+{
+    return (m_format == QImage::Format_Invalid);
+}
+
+//---------------------------------------------------------------------
+
+// public
+QRect kpImageDelta::changedRect () const
+{
+    return m_changedRect;
+}
+
+//---------------------------------------------------------------------
+
+// public
+kpCommandSize::SizeType kpImageDelta::size () const
+{
+    return kpCommandSize::SizeType (m_data.size ()) * sizeof (quint32);
+}
+
+//---------------------------------------------------------------------
+
+// public
+kpImage kpImageDelta::oldImage (const kpImage &newImage) const
+{
+    if (isNull () ||
+        newImage.size () != m_size || newImage.format () != m_format)
+    {
+        return kpImage ();
+    }
+
+    kpImage ret = newImage;
+    if (m_data.isEmpty ())
+        return ret;
+
+    const quint32 *data = m_data.constData ();
+    const quint32 * const dataEnd = data + m_data.size ();
+
+    while (data < dataEnd)
+    {
+        const int y = int (*data++);
+        const int x = int (*data++);
+        const int width = int (*data++);
+
+        // (detaches on the first row)
+        quint32 *pixel = reinterpret_cast <quint32 *> (ret.scanLine (y)) + x;
+        quint32 * const pixelEnd = pixel + width;
+
+        while (pixel < pixelEnd)
+        {
+            const quint32 control = *data++;
+            const int count = int (control >> 1);
+
+            if (control & 1)
+            {
+                const quint32 value = *data++;
+                for (int i = 0; i < count; i++)
+                    *pixel++ ^= value;
+            }
+            else
+            {
+                for (int i = 0; i < count; i++)
+                    *pixel++ ^= *data++;
+            }
+        }
+    }
+
+    return ret;
+}
+
+//---------------------------------------------------------------------
@@ -0,0 +1,87 @@
+/*
+   Copyright (c) 2015-2018 Maikel Diaz <ariguanabosoft@gmail.com>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef kpImageDelta_H
+#define kpImageDelta_H
+
+
+#include <qrect.h>
+#include <qsize.h>
+#include <qvector.h>
+
+#include <kpCommandSize.h>
+#include <kpImage.h>
+
+
+//
+// The difference between an old and a new image of the same size and
+// 32-bit format, from which the old image can be rebuilt given the new one.
+//
+// Only the changed span of each row is kept, as the XOR of the old and new
+// pixels, run-length encoded.  So an effect or fill that changes a few
+// pixels, or changes many pixels of a color to the same color, takes little
+// space.
+//
+class kpImageDelta
+{
+public:
+    // A null delta.
+    kpImageDelta ();
+
+    // Compares every pixel so don't call on the GUI thread with big images.
+    //
+    // If the images are not of the same size and 32-bit format, the delta
+    // will be null.
+    kpImageDelta (const kpImage &oldImage, const kpImage &newImage);
+
+    bool isNull () const;
+
+    // The bounding rectangle of the changed pixels.
+    QRect changedRect () const;
+
+    kpCommandSize::SizeType size () const;
+
+    // Returns the old image, rebuilt from <newImage> -- which must be the
+    // new image given to the constructor, or an identical one.
+    //
+    // Returns a null image if <newImage> can't be that.
+    kpImage oldImage (const kpImage &newImage) const;
+
+private:
+    QSize m_size;
+    QImage::Format m_format;
+    QRect m_changedRect;
+
+    // For each row with changes: its y, the x and width of the changed
+    // span, and then the XOR of the span as runs.  Each run is a control
+    // word: (count << 1) | 1 followed by a word to repeat <count> times, or
+    // (count << 1) followed by <count> words.
+    QVector <quint32> m_data;
+};
+
+
+#endif  // kpImageDelta_H
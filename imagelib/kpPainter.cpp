@@ -399,7 +399,12 @@ static QRect Wash (kpImage *image,
               << " readableImageRect=" << pack.readableImageRect
               << endl;
 #endif
-    pack.readableImage = kpPixmapFX::getPixmapAt (*image, pack.readableImageRect);
+    // Read <image> in place.  Detach it first so that the painter below
+    // doesn't move its pixels from under the view.  The view then sees the
+    // washed pixels but that doesn't matter: they are already <color>.
+    image->bits ();
+    pack.readableImage = kpPixmapFX::getPixmapViewAt (*image,
+        pack.readableImageRect, false/*don't keep alive*/);
 
     QPainter painter(image);
     return (*drawFunc)(&painter, &pack);
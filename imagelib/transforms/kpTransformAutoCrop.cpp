@@ -48,10 +48,15 @@
 
 #include <kpTransformAutoCrop.h>
 
+#include <string.h>
+
 #include <qapplication.h>
 #include <qbitmap.h>
 #include <qimage.h>
 #include <qpainter.h>
+#include <QAtomicInt>
+#include <QVector>
+#include <QtConcurrentMap>
 
 #include <qdebug.h>
 #include <qlocale.h>
@@ -67,6 +72,7 @@
 #include <kpPainter.h>
 #include <kpPixmapFX.h>
 #include <kpRectangularImageSelection.h>
+#include <kpRowBands.h>
 #include <kpSetOverrideCursorSaver.h>
 #include <kpTool.h>
 #include <kpViewManager.h>
@@ -94,8 +100,10 @@ public:
     kpColor averageColor () const;
     bool isSingleColor () const;
 
-    // (returns true on success (even if no rect) or false on error)
-    bool calculate (int isX, int dir);
+    // Sets the border found by CalculateBorders().
+    void set (const QRect &rect, const kpColor &referenceColor,
+              qint64 redSum, qint64 greenSum, qint64 blueSum,
+              bool isSingleColor);
 
     bool fillsEntireImage () const;
     bool exists () const;
@@ -107,7 +115,7 @@ private:
 
     QRect m_rect;
     kpColor m_referenceColor;
-    int m_redSum, m_greenSum, m_blueSum;
+    qint64 m_redSum, m_greenSum, m_blueSum;
     bool m_isSingleColor;
 };
 
@@ -187,12 +195,12 @@ kpColor kpTransformAutoCropBorder::averageColor () const
         return m_referenceColor;
     else
     {
-        int numPixels = (m_rect.width () * m_rect.height ());
+        const qint64 numPixels = qint64 (m_rect.width ()) * m_rect.height ();
         Q_ASSERT (numPixels > 0);
 
-        return kpColor (m_redSum / numPixels,
-                        m_greenSum / numPixels,
-                        m_blueSum / numPixels);
+        return kpColor (int (m_redSum / numPixels),
+                        int (m_greenSum / numPixels),
+                        int (m_blueSum / numPixels));
     }
 }
 
@@ -206,130 +214,321 @@ bool kpTransformAutoCropBorder::isSingleColor () const
 //---------------------------------------------------------------------
 
 // public
-bool kpTransformAutoCropBorder::calculate (int isX, int dir)
+void kpTransformAutoCropBorder::set (const QRect &rect,
+        const kpColor &referenceColor,
+        qint64 redSum, qint64 greenSum, qint64 blueSum,
+        bool isSingleColor)
 {
-#if DEBUG_KP_TOOL_AUTO_CROP && 1
-    kDebug () << "kpTransformAutoCropBorder::calculate() CALLED!";
-#endif
-    int maxX = m_imagePtr->width () - 1;
-    int maxY = m_imagePtr->height () - 1;
+    m_rect = rect;
+    m_referenceColor = referenceColor;
+    m_redSum = redSum, m_greenSum = greenSum, m_blueSum = blueSum;
+    m_isSingleColor = isSingleColor;
+}
+
+// public
+bool kpTransformAutoCropBorder::fillsEntireImage () const
+{
+    return (m_rect == m_imagePtr->rect ());
+}
+
+// public
+bool kpTransformAutoCropBorder::exists () const
+{
+    // (will use in an addition so make sure returns 1 or 0)
+    return (m_rect.isValid () ? 1 : 0);
+}
+
+// public
+void kpTransformAutoCropBorder::invalidate ()
+{
+    m_rect = QRect ();
+    m_referenceColor = kpColor::Invalid;
+    m_redSum = m_greenSum = m_blueSum = 0;
+    m_isSingleColor = false;
+}
+
 
-    QImage qimage = *m_imagePtr;
-    Q_ASSERT (!qimage.isNull ());
+//---------------------------------------------------------------------
+
+// The image being scanned by CalculateBorders(), in a 32-bit format whose
+// words are what QImage::pixel() -- and so kpPixmapFX::getColorAtPixel()
+// -- returns: Format_ARGB32_Premultiplied or Format_ARGB32.
+struct AutoCropScan
+{
+    const uchar *bits;
+    int bytesPerLine;
+    int width, height;
+    int processedColorSimilarity;
 
-    // (sync both branches)
-    if (isX)
+    const QRgb *scanLine (int y) const
     {
-        int numCols = 0;
-        int startX = (dir > 0) ? 0 : maxX;
+        return reinterpret_cast <const QRgb *> (bits + y * bytesPerLine);
+    }
 
-        kpColor col = kpPixmapFX::getColorAtPixel (qimage, startX, 0);
-        for (int x = startX;
-             x >= 0 && x <= maxX;
-             x += dir)
-        {
-            int y;
-            for (y = 0; y <= maxY; y++)
-            {
-                if (!kpPixmapFX::getColorAtPixel (qimage, x, y).isSimilarTo (col, m_processedColorSimilarity))
-                    break;
-            }
+    // Same as kpColor::isSimilarTo() but on scanLine() words.
+    bool matches (QRgb word, QRgb ref) const
+    {
+        if (word == ref)
+            return true;
 
-            if (y <= maxY)
-                break;
-            else
-                numCols++;
-        }
+        if (processedColorSimilarity == kpColor::Exact)
+            return false;
 
-        if (numCols)
-        {
-            m_rect =
-                kpPainter::normalizedRect(QPoint(startX, 0),
-                       QPoint(startX + (numCols - 1) * dir, maxY));
-            m_referenceColor = col;
-        }
+        const int dr = qRed (word) - qRed (ref),
+                  dg = qGreen (word) - qGreen (ref),
+                  db = qBlue (word) - qBlue (ref);
+        return (dr * dr + dg * dg + db * db <= processedColorSimilarity);
     }
-    else
+};
+
+//---------------------------------------------------------------------
+
+// Lowers <*value> to <candidate> if it is smaller.
+static void AtomicMin (QAtomicInt *value, int candidate)
+{
+    int current = value->loadAcquire ();
+    while (candidate < current &&
+           !value->testAndSetOrdered (current, candidate))
     {
-        int numRows = 0;
-        int startY = (dir > 0) ? 0 : maxY;
+        current = value->loadAcquire ();
+    }
+}
 
-        kpColor col = kpPixmapFX::getColorAtPixel (qimage, 0, startY);
-        for (int y = startY;
-             y >= 0 && y <= maxY;
-             y += dir)
-        {
-            int x;
-            for (x = 0; x <= maxX; x++)
-            {
-                if (!kpPixmapFX::getColorAtPixel (qimage, x, y).isSimilarTo (col, m_processedColorSimilarity))
-                    break;
-            }
+//---------------------------------------------------------------------
 
-            if (x <= maxX)
-                break;
-            else
-                numRows++;
-        }
+// Finds, for the rows of a kpRowBand, the number of leading and trailing
+// pixels that match the left and right reference colors.  The minimums
+// over all rows -- the left and right border widths -- are shared between
+// bands so that each row is only scanned as far as the narrowest border
+// found so far: with small margins, that is only a few pixels per row.
+struct SideBordersWorker
+{
+    typedef void result_type;
+
+    const AutoCropScan *scan;
+    QRgb leftColor, rightColor;
+
+    QAtomicInt *leftWidth, *rightWidth;
 
-        if (numRows)
+    void operator() (const kpRowBand &band) const
+    {
+        const int w = scan->width;
+
+        for (int y = band.top; y < band.bottom; y++)
         {
-            m_rect = kpPainter::normalizedRect(QPoint(0, startY),
-                         QPoint(maxX, startY + (numRows - 1) * dir));
-            m_referenceColor = col;
+            const int maxLeft = leftWidth->loadAcquire ();
+            const int maxRight = rightWidth->loadAcquire ();
+
+            // Another band has already ruled out both borders.
+            if (maxLeft == 0 && maxRight == 0)
+                return;
+
+            const QRgb *line = scan->scanLine (y);
+
+            int x = 0;
+            while (x < maxLeft && scan->matches (line [x], leftColor))
+                x++;
+            if (x < maxLeft)
+                ::AtomicMin (leftWidth, x);
+
+            x = 0;
+            while (x < maxRight && scan->matches (line [w - 1 - x], rightColor))
+                x++;
+            if (x < maxRight)
+                ::AtomicMin (rightWidth, x);
         }
     }
+};
 
+//---------------------------------------------------------------------
 
-    if (m_rect.isValid ())
+// Sums the color components of the pixels of the border at <rect> and
+// works out if they are all <ref>.
+static void SumBorder (const AutoCropScan &scan, const QRect &rect,
+        QRgb ref,
+        qint64 *redSum, qint64 *greenSum, qint64 *blueSum,
+        bool *isSingleColor)
+{
+    *redSum = *greenSum = *blueSum = 0;
+    *isSingleColor = true;
+
+    for (int y = rect.top (); y <= rect.bottom (); y++)
     {
-        m_isSingleColor = true;
+        const QRgb *line = scan.scanLine (y);
 
-        if (m_processedColorSimilarity != 0)
+        for (int x = rect.left (); x <= rect.right (); x++)
         {
-            for (int y = m_rect.top (); y <= m_rect.bottom (); y++)
-            {
-                for (int x = m_rect.left (); x <= m_rect.right (); x++)
-                {
-                    kpColor colAtPixel = kpPixmapFX::getColorAtPixel (qimage, x, y);
+            const QRgb p = line [x];
 
-                    if (m_isSingleColor && colAtPixel != m_referenceColor)
-                        m_isSingleColor = false;
+            if (p != ref)
+                *isSingleColor = false;
 
-                    m_redSum += colAtPixel.red ();
-                    m_greenSum += colAtPixel.green ();
-                    m_blueSum += colAtPixel.blue ();
-                }
-            }
+            *redSum += qRed (p);
+            *greenSum += qGreen (p);
+            *blueSum += qBlue (p);
         }
     }
+}
 
+//---------------------------------------------------------------------
+
+// Returns whether row <y> is entirely <ref>.  <refRow> is a row of <ref>,
+// for exact matches.
+static bool RowMatches (const AutoCropScan &scan, int y,
+        QRgb ref, const QVector <QRgb> &refRow)
+{
+    const QRgb *line = scan.scanLine (y);
+
+    if (scan.processedColorSimilarity == kpColor::Exact)
+        return (memcmp (line, refRow.constData (), scan.width * sizeof (QRgb)) == 0);
+
+    for (int x = 0; x < scan.width; x++)
+    {
+        if (!scan.matches (line [x], ref))
+            return false;
+    }
 
     return true;
 }
 
-// public
-bool kpTransformAutoCropBorder::fillsEntireImage () const
-{
-    return (m_rect == m_imagePtr->rect ());
-}
+//---------------------------------------------------------------------
 
-// public
-bool kpTransformAutoCropBorder::exists () const
+// Finds the borders on all 4 sides of <image> -- runs of rows or columns
+// similar to the color in the nearest corner (top-left for the left and
+// top borders, top-right for the right border and bottom-left for the
+// bottom border).
+//
+// Rows are scanned in memory order: the top and bottom borders row by row
+// inwards, stopping at the first row that differs, and the left and right
+// borders together in one pass over the rows, split between threads.
+// Only the pixels of the borders found are then read again, to work out
+// their average colors.
+//
+// Returns false if a border covers the entire image.
+static bool CalculateBorders (const kpImage &image, int processedColorSimilarity,
+        kpTransformAutoCropBorder *leftBorder,
+        kpTransformAutoCropBorder *rightBorder,
+        kpTransformAutoCropBorder *topBorder,
+        kpTransformAutoCropBorder *botBorder)
 {
-    // (will use in an addition so make sure returns 1 or 0)
-    return (m_rect.isValid () ? 1 : 0);
-}
+    Q_ASSERT (!image.isNull ());
 
-// public
-void kpTransformAutoCropBorder::invalidate ()
-{
-    m_rect = QRect ();
-    m_referenceColor = kpColor::Invalid;
-    m_redSum = m_greenSum = m_blueSum = 0;
-    m_isSingleColor = false;
+    // Compare colors as QImage::pixel() returns them: as they are if they
+    // are premultiplied, else as non-premultiplied ARGB.
+    const QImage scanImage =
+        (image.format () == QImage::Format_ARGB32_Premultiplied) ?
+            image : image.convertToFormat (QImage::Format_ARGB32);
+
+    AutoCropScan scan;
+    scan.bits = scanImage.constBits ();
+    scan.bytesPerLine = scanImage.bytesPerLine ();
+    scan.width = scanImage.width ();
+    scan.height = scanImage.height ();
+    scan.processedColorSimilarity = processedColorSimilarity;
+
+    const int maxX = scan.width - 1, maxY = scan.height - 1;
+
+    const QRgb topLeft = scan.scanLine (0) [0];
+    const QRgb topRight = scan.scanLine (0) [maxX];
+    const QRgb botLeft = scan.scanLine (maxY) [0];
+
+
+    //
+    // Top and bottom
+    //
+
+    int numTopRows = 0;
+    {
+        const QVector <QRgb> refRow (scan.width, topLeft);
+        while (numTopRows < scan.height &&
+               ::RowMatches (scan, numTopRows, topLeft, refRow))
+        {
+            numTopRows++;
+        }
+    }
+    if (numTopRows == scan.height)
+        return false;
+
+    int numBotRows = 0;
+    {
+        const QVector <QRgb> refRow (scan.width, botLeft);
+        while (numBotRows < scan.height &&
+               ::RowMatches (scan, maxY - numBotRows, botLeft, refRow))
+        {
+            numBotRows++;
+        }
+    }
+    if (numBotRows == scan.height)
+        return false;
+
+
+    //
+    // Left and right
+    //
+
+    QAtomicInt leftWidth (scan.width), rightWidth (scan.width);
+
+    SideBordersWorker worker;
+    worker.scan = &scan;
+    worker.leftColor = topLeft;
+    worker.rightColor = topRight;
+    worker.leftWidth = &leftWidth;
+    worker.rightWidth = &rightWidth;
+
+    QList <kpRowBand> bands = kpRowBands::Split (scan.height);
+    QtConcurrent::blockingMap (bands, worker);
+
+    const int numLeftCols = leftWidth.loadAcquire ();
+    const int numRightCols = rightWidth.loadAcquire ();
+    if (numLeftCols == scan.width || numRightCols == scan.width)
+        return false;
+
+
+    //
+    // Fill in the borders
+    //
+
+    const QRect rects [] =
+    {
+        QRect (0, 0, numLeftCols, scan.height),
+        QRect (scan.width - numRightCols, 0, numRightCols, scan.height),
+        QRect (0, 0, scan.width, numTopRows),
+        QRect (0, scan.height - numBotRows, scan.width, numBotRows)
+    };
+    const QRgb refColors [] =
+    {
+        topLeft, topRight, topLeft, botLeft
+    };
+    kpTransformAutoCropBorder *borders [] =
+    {
+        leftBorder, rightBorder, topBorder, botBorder
+    };
+
+    for (int i = 0; i < 4; i++)
+    {
+        borders [i]->invalidate ();
+
+        if (rects [i].isEmpty ())
+            continue;
+
+        qint64 redSum = 0, greenSum = 0, blueSum = 0;
+        bool isSingleColor = true;
+
+        // Exact matches are all the reference color.
+        if (processedColorSimilarity != kpColor::Exact)
+        {
+            ::SumBorder (scan, rects [i], refColors [i],
+                &redSum, &greenSum, &blueSum, &isSingleColor);
+        }
+
+        borders [i]->set (rects [i], kpColor (refColors [i]),
+            redSum, greenSum, blueSum, isSingleColor);
+    }
+
+    return true;
 }
 
+//---------------------------------------------------------------------
 
 struct kpTransformAutoCropCommandPrivate
 {
@@ -675,14 +874,8 @@ bool kpTransformAutoCrop (kpMainWindow *mainWindow)
     // TODO: e.g. When the top fills entire rect but bot doesn't we could
     //       invalidate top and continue autocrop.
     int numRegions = 0;
-    if (!leftBorder.calculate (true/*x*/, +1/*going right*/) ||
-        leftBorder.fillsEntireImage () ||
-        !rightBorder.calculate (true/*x*/, -1/*going left*/) ||
-        rightBorder.fillsEntireImage () ||
-        !topBorder.calculate (false/*y*/, +1/*going down*/) ||
-        topBorder.fillsEntireImage () ||
-        !botBorder.calculate (false/*y*/, -1/*going up*/) ||
-        botBorder.fillsEntireImage () ||
+    if (!::CalculateBorders (image, processedColorSimilarity,
+            &leftBorder, &rightBorder, &topBorder, &botBorder) ||
         ((numRegions = leftBorder.exists () +
                        rightBorder.exists () +
                        topBorder.exists () +
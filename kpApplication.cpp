@@ -30,16 +30,66 @@
 
 #include <kpMainWindow.h>
 #include <kpDocument.h>
+#include <kpDocumentPrefetch.h>
 
 #include <qdebug.h>
 
 #include <QFileOpenEvent>
+#include <QFutureWatcher>
 
 kpApplication::kpApplication(int &argc, char **argv)
     : QApplication(argc, argv) {
 
 }
 
+void kpApplication::openFiles(const QStringList &files) {
+
+    foreach (const QString &file, files)
+        kpDocumentPrefetch::Start (file);
+
+    const bool alreadyOpening = !m_filesToOpen.isEmpty();
+    m_filesToOpen += files;
+
+    if (!alreadyOpening)
+        openNextFile();
+}
+
+void kpApplication::openNextFile() {
+
+    QFutureWatcher<kpDocumentPrefetch::Result> *watcher =
+        dynamic_cast<QFutureWatcher<kpDocumentPrefetch::Result> *>(sender());
+    if (watcher)
+        watcher->deleteLater();
+
+    while (!m_filesToOpen.isEmpty()) {
+        const QFuture<kpDocumentPrefetch::Result> future =
+            kpDocumentPrefetch::Start (m_filesToOpen.first());
+
+        if (!future.isFinished()) {
+            // Come back when it is, without holding up the event loop.
+            watcher = new QFutureWatcher<kpDocumentPrefetch::Result>(this);
+            connect(watcher, SIGNAL(finished()), this, SLOT(openNextFile()));
+            watcher->setFuture(future);
+            return;
+        }
+
+        // (kpDocument::getPixmapFromFile() takes the decoded image)
+        kpMainWindow *mainWindow = new kpMainWindow (m_filesToOpen.takeFirst());
+        mainWindow->show ();
+    }
+}
+
+void kpApplication::openWindowIfNone() {
+
+    foreach (QWidget *widget, topLevelWidgets()) {
+        if (qobject_cast<kpMainWindow *>(widget))
+            return;
+    }
+
+    kpMainWindow *mainWindow = new kpMainWindow ();
+    mainWindow->show ();
+}
+
 bool kpApplication::event(QEvent *e) {
 
     switch (e->type()) {
@@ -48,8 +98,21 @@ bool kpApplication::event(QEvent *e) {
         {
            const QString file_name = static_cast<QFileOpenEvent *>(e)->file();
 
+           // If openWindowIfNone() got in first, the file takes the place
+           // of its untouched new document.
+           kpMainWindow *emptyMainWindow = 0;
+           foreach (QWidget *widget, topLevelWidgets()) {
+               kpMainWindow *otherMainWindow = qobject_cast<kpMainWindow *>(widget);
+               if (otherMainWindow && otherMainWindow->document() &&
+                   otherMainWindow->document()->isEmpty())
+                   emptyMainWindow = otherMainWindow;
+           }
+
            kpMainWindow *mainWindow = new kpMainWindow (file_name);
            mainWindow->show ();
+
+           if (emptyMainWindow)
+               emptyMainWindow->close ();
         }
     return true;
 
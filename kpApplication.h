@@ -29,6 +29,7 @@
 
 #include <QApplication>
 #include <QEvent>
+#include <QStringList>
 
 class kpApplication : public QApplication {
 
@@ -37,8 +38,25 @@ class kpApplication : public QApplication {
     public:
         kpApplication(int &argc, char **argv);
 
+        // Opens a main window for each of <files>, in order.  The files
+        // are all decoded at once in the background (see
+        // kpDocumentPrefetch) and each window is opened as soon as its
+        // file, and those before it, are ready.
+        void openFiles(const QStringList &files);
+
+    public slots:
+        // Opens a main window with a new document, unless there already is
+        // a main window (e.g. from a FileOpen event).
+        void openWindowIfNone();
+
     protected:
         bool event(QEvent *e);
+
+    private slots:
+        void openNextFile();
+
+    private:
+        QStringList m_filesToOpen;
 };
 
 #endif // KPAPPLICATION_H
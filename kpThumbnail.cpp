@@ -0,0 +1,148 @@
+/*
+   Copyright (c) 2015-2018 Maikel Diaz <ariguanabosoft@gmail.com>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#define DEBUG_KP_THUMBNAIL 0
+
+
+#include <kpThumbnail.h>
+
+#include <qevent.h>
+#include <qlayout.h>
+
+#include <qdebug.h>
+#include <tools.h>
+
+#include <kpMainWindow.h>
+#include <kpThumbnailView.h>
+
+//---------------------------------------------------------------------
+
+kpThumbnail::kpThumbnail (kpMainWindow *parent)
+    : kpSubWindow (parent),
+      m_mainWindow (parent),
+      m_view (0),
+      m_layout (new QVBoxLayout (this))
+{
+    Q_ASSERT (m_mainWindow);
+
+    m_layout->setContentsMargins (0, 0, 0, 0);
+
+    setMinimumSize (64, 64);
+    updateCaption ();
+}
+
+//---------------------------------------------------------------------
+
+kpThumbnail::~kpThumbnail ()
+{
+}
+
+//---------------------------------------------------------------------
+
+// public
+kpThumbnailView *kpThumbnail::view () const
+{
+    return m_view;
+}
+
+//---------------------------------------------------------------------
+
+// public
+void kpThumbnail::setView (kpThumbnailView *view)
+{
+#if DEBUG_KP_THUMBNAIL
+    qDebug () << "kpThumbnail::setView(" << view << ")";
+#endif
+
+    if (m_view == view)
+        return;
+
+    if (m_view)
+    {
+        disconnect (m_view, SIGNAL (zoomLevelChanged (int, int)),
+                    this, SLOT (updateCaption ()));
+
+        m_layout->removeWidget (m_view);
+    }
+
+    m_view = view;
+
+    if (m_view)
+    {
+        connect (m_view, SIGNAL (zoomLevelChanged (int, int)),
+                 this, SLOT (updateCaption ()));
+
+        m_layout->addWidget (m_view);
+        m_view->show ();
+    }
+
+    updateCaption ();
+}
+
+//---------------------------------------------------------------------
+
+// public slot
+void kpThumbnail::updateCaption ()
+{
+    setWindowTitle (m_view ? m_view->caption () : i18n ("Thumbnail"));
+}
+
+//---------------------------------------------------------------------
+
+// protected virtual [base QWidget]
+void kpThumbnail::resizeEvent (QResizeEvent *e)
+{
+    kpSubWindow::resizeEvent (e);
+
+    m_mainWindow->notifyThumbnailGeometryChanged ();
+}
+
+//---------------------------------------------------------------------
+
+// protected virtual [base QWidget]
+void kpThumbnail::moveEvent (QMoveEvent *e)
+{
+    kpSubWindow::moveEvent (e);
+
+    m_mainWindow->notifyThumbnailGeometryChanged ();
+}
+
+//---------------------------------------------------------------------
+
+// public slot virtual [base QDialog]
+void kpThumbnail::reject ()
+{
+#if DEBUG_KP_THUMBNAIL
+    qDebug () << "kpThumbnail::reject()";
+#endif
+
+    kpSubWindow::reject ();
+
+    emit windowClosed ();
+}
+
+//---------------------------------------------------------------------
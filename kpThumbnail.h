@@ -0,0 +1,80 @@
+/*
+   Copyright (c) 2015-2018 Maikel Diaz <ariguanabosoft@gmail.com>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef kpThumbnail_H
+#define kpThumbnail_H
+
+
+#include <kpSubWindow.h>
+
+
+class QMoveEvent;
+class QResizeEvent;
+class QVBoxLayout;
+
+class kpMainWindow;
+class kpThumbnailView;
+
+
+//
+// The thumbnail window.  It holds a single kpThumbnailView, which fills it
+// and is owned by (and created by) kpMainWindow.
+//
+class kpThumbnail : public kpSubWindow
+{
+Q_OBJECT
+
+public:
+    kpThumbnail (kpMainWindow *parent);
+    virtual ~kpThumbnail ();
+
+    kpThumbnailView *view () const;
+    void setView (kpThumbnailView *view);
+
+public slots:
+    void updateCaption ();
+
+signals:
+    // Emitted when the user closes the window.
+    void windowClosed ();
+
+protected:
+    virtual void resizeEvent (QResizeEvent *e);
+    virtual void moveEvent (QMoveEvent *e);
+
+public slots:
+    // (QDialog::closeEvent() and the Escape key both end up here)
+    virtual void reject ();
+
+private:
+    kpMainWindow *m_mainWindow;
+    kpThumbnailView *m_view;
+    QVBoxLayout *m_layout;
+};
+
+
+#endif  // kpThumbnail_H
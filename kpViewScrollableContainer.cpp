@@ -386,12 +386,13 @@ kpViewScrollableContainer::kpViewScrollableContainer(QWidget *parent)
       m_haveMovedFromOriginalDocSize (false)
 
 {
-    // the base widget holding the documents view plus the resize grips
-    setWidget(new QWidget(viewport()));
-
-    m_bottomGrip = new kpGrip(kpGrip::Bottom, widget());
-    m_rightGrip = new kpGrip(kpGrip::Right, widget());
-    m_bottomRightGrip = new kpGrip(kpGrip::BottomRight, widget());
+    // There is deliberately no scrolled widget (see setWidget()) as big as
+    // the zoomed document plus the resize grips: the view and the grips are
+    // children of the viewport, the view only covers the visible part of the
+    // document and the scrollbar ranges are maintained in updateScrollArea().
+    m_bottomGrip = new kpGrip(kpGrip::Bottom, viewport());
+    m_rightGrip = new kpGrip(kpGrip::Right, viewport());
+    m_bottomRightGrip = new kpGrip(kpGrip::BottomRight, viewport());
 
     m_bottomGrip->setObjectName(QLatin1String("Bottom Grip"));
     m_rightGrip->setObjectName(QLatin1String("Right Grip"));
@@ -489,14 +490,30 @@ QSize kpViewScrollableContainer::newDocSize (int viewDX, int viewDY) const
     if (!docResizingGrip ())
         return QSize ();
 
-    const int docX = (int) m_view->transformViewToDocX (m_view->width () + viewDX);
-    const int docY = (int) m_view->transformViewToDocY (m_view->height () + viewDY);
+    const int docX = (int) m_view->transformViewToDocX (docRightViewX () + viewDX);
+    const int docY = (int) m_view->transformViewToDocY (docBottomViewY () + viewDY);
 
     return QSize (qMax (1, docX), qMax (1, docY));
 }
 
 //---------------------------------------------------------------------
 
+// private
+int kpViewScrollableContainer::docRightViewX () const
+{
+    return m_view ? m_view->zoomedDocWidth () + m_view->origin ().x () : 0;
+}
+
+//---------------------------------------------------------------------
+
+// private
+int kpViewScrollableContainer::docBottomViewY () const
+{
+    return m_view ? m_view->zoomedDocHeight () + m_view->origin ().y () : 0;
+}
+
+//---------------------------------------------------------------------
+
 // protected
 void kpViewScrollableContainer::calculateDocResizingGrip ()
 {
@@ -557,12 +574,12 @@ int kpViewScrollableContainer::rightResizeLineWidth () const
 // protected
 QRect kpViewScrollableContainer::bottomResizeLineRect () const
 {
-    if (m_resizeRoundedLastViewX < 0 || m_resizeRoundedLastViewY < 0)
+    if (!m_view || m_resizeRoundedLastViewX < 0 || m_resizeRoundedLastViewY < 0)
         return QRect ();
 
-    QRect visibleArea = QRect(QPoint(horizontalScrollBar()->value(),verticalScrollBar()->value()), viewport()->size());
+    const QRect visibleArea (QPoint (0, 0), viewport ()->size ());
 
-    return QRect (QPoint (0,
+    return QRect (QPoint (m_view->origin ().x (),
                           m_resizeRoundedLastViewY),
                   QPoint (m_resizeRoundedLastViewX - 1,
                           m_resizeRoundedLastViewY + bottomResizeLineWidth () - 1)).intersected(visibleArea);
@@ -573,13 +590,13 @@ QRect kpViewScrollableContainer::bottomResizeLineRect () const
 // protected
 QRect kpViewScrollableContainer::rightResizeLineRect () const
 {
-    if (m_resizeRoundedLastViewX < 0 || m_resizeRoundedLastViewY < 0)
+    if (!m_view || m_resizeRoundedLastViewX < 0 || m_resizeRoundedLastViewY < 0)
         return QRect ();
 
-    QRect visibleArea = QRect(QPoint(horizontalScrollBar()->value(),verticalScrollBar()->value()), viewport()->size());
+    const QRect visibleArea (QPoint (0, 0), viewport ()->size ());
 
     return QRect (QPoint (m_resizeRoundedLastViewX,
-                          0),
+                          m_view->origin ().y ()),
                   QPoint (m_resizeRoundedLastViewX + rightResizeLineWidth () - 1,
                           m_resizeRoundedLastViewY - 1)).intersected(visibleArea);
 }
@@ -592,7 +609,7 @@ QRect kpViewScrollableContainer::bottomRightResizeLineRect () const
     if (m_resizeRoundedLastViewX < 0 || m_resizeRoundedLastViewY < 0)
         return QRect ();
 
-    QRect visibleArea = QRect(QPoint(horizontalScrollBar()->value(),verticalScrollBar()->value()), viewport()->size());
+    const QRect visibleArea (QPoint (0, 0), viewport ()->size ());
 
     return QRect (QPoint (m_resizeRoundedLastViewX,
                           m_resizeRoundedLastViewY),
@@ -608,8 +625,9 @@ QRect kpViewScrollableContainer::mapViewToViewport (const QRect &viewRect)
     if (!viewRect.isValid ())
         return QRect ();
 
+    // (the view sits at the top-left of the viewport)
     QRect ret = viewRect;
-    ret.translate (-horizontalScrollBar()->value() - viewport()->x(), -verticalScrollBar()->value() - viewport()->y());
+    ret.translate (-viewport()->x(), -viewport()->y());
     return ret;
 }
 
@@ -692,7 +710,7 @@ void kpViewScrollableContainer::slotGripBeganDraw ()
 
     m_haveMovedFromOriginalDocSize = false;
 
-    updateResizeLines (m_view->width (), m_view->height (),
+    updateResizeLines (docRightViewX (), docBottomViewY (),
                        0/*viewDX*/, 0/*viewDY*/);
 
     emit beganDocResize ();
@@ -733,8 +751,8 @@ void kpViewScrollableContainer::slotGripContinuedDraw (int inViewDX, int inViewD
 
     m_haveMovedFromOriginalDocSize = true;
 
-    updateResizeLines (qMax (1, qMax (m_view->width () + viewDX, (int) m_view->transformDocToViewX (1))),
-                       qMax (1, qMax (m_view->height () + viewDY, (int) m_view->transformDocToViewY (1))),
+    updateResizeLines (qMax (1, qMax (docRightViewX () + viewDX, (int) m_view->transformDocToViewX (1))),
+                       qMax (1, qMax (docBottomViewY () + viewDY, (int) m_view->transformDocToViewY (1))),
                        viewDX, viewDY);
 
     emit continuedDocResize (newDocSize ());
@@ -870,8 +888,6 @@ void kpViewScrollableContainer::slotContentsMoved ()
 // protected
 void kpViewScrollableContainer::disconnectViewSignals ()
 {
-    disconnect (m_view, SIGNAL (sizeChanged (const QSize &)),
-                this, SLOT (updateGrips ()));
     disconnect (m_view, SIGNAL (destroyed ()),
                 this, SLOT (slotViewDestroyed ()));
 }
@@ -881,8 +897,6 @@ void kpViewScrollableContainer::disconnectViewSignals ()
 // protected
 void kpViewScrollableContainer::connectViewSignals ()
 {
-    connect (m_view, SIGNAL (sizeChanged (const QSize &)),
-             this, SLOT (updateGrips ()));
     connect (m_view, SIGNAL (destroyed ()),
              this, SLOT (slotViewDestroyed ()));
 }
@@ -912,11 +926,11 @@ void kpViewScrollableContainer::setView (kpView *view)
 
     if ( m_view )
     {
-      m_view->setParent(widget());
+      m_view->setParent(viewport());
       m_view->show();
     }
 
-    updateGrips ();
+    updateScrollArea ();
 
     if (m_view)
     {
@@ -926,29 +940,62 @@ void kpViewScrollableContainer::setView (kpView *view)
 
 //---------------------------------------------------------------------
 
+// public slot
+void kpViewScrollableContainer::updateScrollArea ()
+{
+    // The scrolled contents are the zoomed document plus the grips.
+    const int contentsWidth = m_view ? m_view->zoomedDocWidth () + kpGrip::Size : 0;
+    const int contentsHeight = m_view ? m_view->zoomedDocHeight () + kpGrip::Size : 0;
+
+    // (showing or hiding a scrollbar resizes the viewport and re-enters us
+    //  through resizeEvent(), so always read the current viewport size)
+    horizontalScrollBar()->setPageStep(viewport()->width());
+    horizontalScrollBar()->setSingleStep(20);
+    horizontalScrollBar()->setRange(0, qMax(0, contentsWidth - viewport()->width()));
+
+    verticalScrollBar()->setPageStep(viewport()->height());
+    verticalScrollBar()->setSingleStep(20);
+    verticalScrollBar()->setRange(0, qMax(0, contentsHeight - viewport()->height()));
+
+    updateGrips ();
+
+    recalculateStatusMessage ();
+}
+
+//---------------------------------------------------------------------
+
 // public slot
 void kpViewScrollableContainer::updateGrips ()
 {
     if (m_view)
     {
-      widget()->resize(m_view->size() + m_bottomRightGrip->size());
+      const QPoint scrollOffset (horizontalScrollBar()->value(),
+                                 verticalScrollBar()->value());
+
+      const int docRight = m_view->zoomedDocWidth() - scrollOffset.x();
+      const int docBottom = m_view->zoomedDocHeight() - scrollOffset.y();
+
+      // Back only the visible part of the zoomed document with the view,
+      // however big the document and the zoom level are.
+      m_view->setGeometry(0, 0,
+                          qBound(0, docRight, viewport()->width()),
+                          qBound(0, docBottom, viewport()->height()));
+      m_view->scrollOrigin(-scrollOffset);
 
       // to make the grip more easily "touchable" make it as high as the view
       m_rightGrip->setFixedHeight(m_view->height());
-      m_rightGrip->move(m_view->width(), 0);
+      m_rightGrip->move(docRight, 0);
 
       // to make the grip more easily "touchable" make it as wide as the view
       m_bottomGrip->setFixedWidth(m_view->width());
-      m_bottomGrip->move(0, m_view->height ());
+      m_bottomGrip->move(0, docBottom);
 
-      m_bottomRightGrip->move(m_view->width(), m_view->height());
+      m_bottomRightGrip->move(docRight, docBottom);
     }
 
     m_bottomGrip->setHidden (m_view == 0);
     m_rightGrip->setHidden (m_view == 0);
     m_bottomRightGrip->setHidden (m_view == 0);
-
-    recalculateStatusMessage ();
 }
 
 //---------------------------------------------------------------------
@@ -957,7 +1004,7 @@ void kpViewScrollableContainer::updateGrips ()
 void kpViewScrollableContainer::slotViewDestroyed ()
 {
     m_view = 0;
-    updateGrips ();
+    updateScrollArea ();
 }
 
 //---------------------------------------------------------------------
@@ -1094,12 +1141,14 @@ bool kpViewScrollableContainer::slotDragScroll (bool *didSomething)
         scrolled = (oldContentsX != horizontalScrollBar()->value () ||
                     oldContentsY != verticalScrollBar()->value ());
 
-        if (scrolled)
+        if (scrolled && m_view)
         {
-            QRegion region = QRect (horizontalScrollBar()->value (), verticalScrollBar()->value (),
-                                    viewport()->width(), viewport()->height());
-            region -= QRect (oldContentsX, oldContentsY,
-                             viewport()->width(), viewport()->height());
+            // scrollContentsBy() has blitted the view; the strips that
+            // scrolled into view are what is left.
+            QRegion region = m_view->rect ();
+            region -= m_view->rect ().translated (
+                oldContentsX - horizontalScrollBar()->value (),
+                oldContentsY - verticalScrollBar()->value ());
 
             // Repaint newly exposed region immediately to reduce tearing
             // of scrollView.
@@ -1154,7 +1203,19 @@ void kpViewScrollableContainer::resizeEvent (QResizeEvent *e)
 {
     QScrollArea::resizeEvent (e);
 
+    updateScrollArea ();
+
     emit resized ();
 }
 
 //---------------------------------------------------------------------
+
+// protected virtual [base QAbstractScrollArea]
+void kpViewScrollableContainer::scrollContentsBy (int /*dx*/, int /*dy*/)
+{
+    // Rather than moving a widget as big as the zoomed document, move the
+    // view's origin, which blits what is still visible.
+    updateGrips ();
+}
+
+//---------------------------------------------------------------------
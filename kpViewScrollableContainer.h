@@ -150,6 +150,12 @@ signals:
 public slots:
     void recalculateStatusMessage ();
 
+    // Recalculates the scrollbar ranges from the zoomed size of view()'s
+    // document and then calls updateGrips().
+    void updateScrollArea ();
+
+    // Places view() over the visible part of its zoomed document, sets its
+    // origin to the scroll offset and moves the grips to the document edges.
     void updateGrips ();
 
     // TODO: Why the need for view's zoomLevel?  We have the view() anyway.
@@ -163,6 +169,10 @@ private:
 
     QSize newDocSize (int viewDX, int viewDY) const;
 
+    // The right/bottom edge of the zoomed document in view coordinates.
+    int docRightViewX () const;
+    int docBottomViewY () const;
+
     void calculateDocResizingGrip ();
     kpGrip *docResizingGrip () const;
 
@@ -185,6 +195,7 @@ private:
 
     virtual void wheelEvent(QWheelEvent *e);
     virtual void resizeEvent(QResizeEvent *e);
+    virtual void scrollContentsBy(int dx, int dy);
 
 private slots:
     void slotGripBeganDraw ();
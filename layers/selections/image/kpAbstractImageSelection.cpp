@@ -35,6 +35,9 @@
 
 #include <QBitmap>
 #include <QPainter>
+#include <QVector>
+
+#include <string.h>
 
 #include <qdebug.h>
 #include <tools.h>
@@ -68,7 +71,11 @@ struct kpAbstractImageSelectionPrivate
 
     // The mask for the image, after selection transparency (a.k.a. background
     // subtraction) is applied.
-    QBitmap transparencyMaskCache;  // OPT: calculate lazily i.e. on-demand only
+    //
+    // This is a QImage::Format_MonoLSB image where a set bit means that the
+    // pixel is transparent.  The padding bits at the end of each row are
+    // always 0 so that rows can be compared with memcmp().
+    QImage transparencyMaskCache;  // OPT: calculate lazily i.e. on-demand only
 };
 
 //---------------------------------------------------------------------
@@ -212,7 +219,7 @@ kpCommandSize::SizeType kpAbstractImageSelection::size () const
 {
     return kpAbstractSelection::size () +
         kpCommandSize::ImageSize (d->baseImage) +
-        (d->transparencyMaskCache.width() * d->transparencyMaskCache.height()) / 8;
+        kpCommandSize::QImageSize (d->transparencyMaskCache);
 }
 
 //---------------------------------------------------------------------
@@ -366,7 +373,7 @@ bool kpAbstractImageSelection::setTransparency (
 
     bool haveChanged = true;
 
-    QBitmap oldTransparencyMaskCache = d->transparencyMaskCache;
+    const QImage oldTransparencyMaskCache = d->transparencyMaskCache;
     recalculateTransparencyMaskCache ();
 
 
@@ -382,26 +389,22 @@ bool kpAbstractImageSelection::setTransparency (
         }
         else if (checkTransparentPixmapChanged)
         {
-            QImage oldTransparencyMaskImage = oldTransparencyMaskCache.toImage();
-            QImage newTransparencyMaskImage = d->transparencyMaskCache.toImage();
+            const QImage &oldMask = oldTransparencyMaskCache;
+            const QImage &newMask = d->transparencyMaskCache;
+
+            // (the padding bits of each row are always 0)
+            const size_t rowBytes = (newMask.width () + 7) / 8;
 
             bool changed = false;
-            for (int y = 0; y < oldTransparencyMaskImage.height () && !changed; y++)
+            for (int y = 0; y < newMask.height () && !changed; y++)
             {
-                for (int x = 0; x < oldTransparencyMaskImage.width () && !changed; x++)
+                if (memcmp (oldMask.constScanLine (y), newMask.constScanLine (y),
+                            rowBytes) != 0)
                 {
-                    if (kpPixmapFX::getColorAtPixel (oldTransparencyMaskImage, x, y) !=
-                        kpPixmapFX::getColorAtPixel (newTransparencyMaskImage, x, y))
-                    {
-                    #if DEBUG_KP_SELECTION
-                        kDebug () << "\tdiffer at " << QPoint (x, y)
-                                   << " old=" << (int *) kpPixmapFX::getColorAtPixel (oldTransparencyMaskImage, x, y).toQRgb ()
-                                   << " new=" << (int *) kpPixmapFX::getColorAtPixel (newTransparencyMaskImage, x, y).toQRgb ()
-                                   << endl;
-                    #endif
-                        changed = true;
-                        break;
-                    }
+                #if DEBUG_KP_SELECTION
+                    kDebug () << "\tdiffer at row " << y;
+                #endif
+                    changed = true;
                 }
             }
 
@@ -419,6 +422,89 @@ bool kpAbstractImageSelection::setTransparency (
 
 //---------------------------------------------------------------------
 
+// Sets <flags>[x] to 1 for every pixel of <rgbaRow> that is fully transparent
+// or similar to <transparentColor>; to 0 otherwise.
+//
+// <rgbaRow> holds raw pixels exactly as kpPixmapFX::getColorAtPixel() would
+// see them.  The matching rules are the same as those of
+// kpColor::isSimilarTo() but without any branches in the loop, so that the
+// compiler can vectorize it.
+static void CalculateTransparentFlags (const QRgb *rgbaRow, int width,
+        QRgb transparentColor, int processedSimilarity,
+        uchar *flags)
+{
+    if (processedSimilarity == kpColor::Exact)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            const QRgb pixel = rgbaRow [x];
+            flags [x] = uchar ((pixel == 0/*kpColor::Transparent*/) |
+                               (pixel == transparentColor));
+        }
+    }
+    else
+    {
+        const int tr = qRed (transparentColor),
+                  tg = qGreen (transparentColor),
+                  tb = qBlue (transparentColor);
+
+        for (int x = 0; x < width; x++)
+        {
+            const QRgb pixel = rgbaRow [x];
+
+            const int dr = int ((pixel >> 16) & 0xFF) - tr;
+            const int dg = int ((pixel >> 8) & 0xFF) - tg;
+            const int db = int (pixel & 0xFF) - tb;
+
+            flags [x] = uchar ((pixel == 0/*kpColor::Transparent*/) |
+                               (pixel == transparentColor) |
+                               (dr * dr + dg * dg + db * db <= processedSimilarity));
+        }
+    }
+}
+
+//---------------------------------------------------------------------
+
+// Packs <width> 0/1 <flags> into <bits>, least significant bit first
+// (QImage::Format_MonoLSB).  The padding bits of the last byte are set to 0.
+//
+// Returns whether any flag was set.
+static bool PackFlagsLSB (const uchar *flags, int width, uchar *bits)
+{
+    uchar any = 0;
+
+    const int fullBytes = width / 8;
+    for (int i = 0; i < fullBytes; i++)
+    {
+        const uchar *f = flags + i * 8;
+        const uchar byte = uchar (f [0] |
+                                  (f [1] << 1) |
+                                  (f [2] << 2) |
+                                  (f [3] << 3) |
+                                  (f [4] << 4) |
+                                  (f [5] << 5) |
+                                  (f [6] << 6) |
+                                  (f [7] << 7));
+        bits [i] = byte;
+        any |= byte;
+    }
+
+    const int remaining = width % 8;
+    if (remaining)
+    {
+        uchar byte = 0;
+        for (int b = 0; b < remaining; b++)
+            byte |= uchar (flags [fullBytes * 8 + b] << b);
+
+        bits [fullBytes] = byte;
+        any |= byte;
+    }
+
+    return (any != 0);
+}
+
+//---------------------------------------------------------------------
+
 // private
 void kpAbstractImageSelection::recalculateTransparencyMaskCache ()
 {
@@ -431,7 +517,7 @@ void kpAbstractImageSelection::recalculateTransparencyMaskCache ()
     #if DEBUG_KP_SELECTION
         kDebug () << "\tno image - no need for transparency mask";
     #endif
-        d->transparencyMaskCache = QBitmap ();
+        d->transparencyMaskCache = QImage ();
         return;
     }
 
@@ -440,47 +526,77 @@ void kpAbstractImageSelection::recalculateTransparencyMaskCache ()
     #if DEBUG_KP_SELECTION
         kDebug () << "\topaque - no need for transparency mask";
     #endif
-        d->transparencyMaskCache = QBitmap ();
+        d->transparencyMaskCache = QImage ();
         return;
     }
 
-    d->transparencyMaskCache = QBitmap (d->baseImage.width (), d->baseImage.height ());
+    const kpColor transparentColor = d->transparency.transparentColor ();
+    const int processedSimilarity = d->transparency.processedColorSimilarity ();
 
+    // Read the raw pixels that kpPixmapFX::getColorAtPixel() would have
+    // returned.  For these formats, QImage::pixel() returns the stored
+    // value (with the alpha forced to opaque for RGB32).
     QImage image = d->baseImage;
-    QPainter transparencyMaskPainter (&d->transparencyMaskCache);
+    if (image.format () != QImage::Format_ARGB32_Premultiplied &&
+        image.format () != QImage::Format_ARGB32 &&
+        image.format () != QImage::Format_RGB32)
+    {
+        image = image.convertToFormat (QImage::Format_ARGB32);
+    }
+    const bool forceOpaque = (image.format () == QImage::Format_RGB32);
+
+    const int width = image.width (), height = image.height ();
+
+    QImage mask (width, height, QImage::Format_MonoLSB);
+    mask.setColorCount (2);
+    mask.setColor (0, qRgb (0xFF, 0xFF, 0xFF)/*opaque*/);
+    mask.setColor (1, qRgb (0, 0, 0)/*transparent*/);
+
+    QVector <QRgb> opaqueRow (forceOpaque ? width : 0);
+    QVector <uchar> flags (width);
 
     bool hasTransparent = false;
-    for (int y = 0; y < d->baseImage.height (); y++)
+    for (int y = 0; y < height; y++)
     {
-        for (int x = 0; x < d->baseImage.width (); x++)
+        const QRgb *rgbaRow =
+            reinterpret_cast <const QRgb *> (image.constScanLine (y));
+
+        if (forceOpaque)
         {
-            const kpColor pixelCol = kpPixmapFX::getColorAtPixel (image, x, y);
-            if (pixelCol == kpColor::Transparent ||
-                pixelCol.isSimilarTo (d->transparency.transparentColor (),
-                                      d->transparency.processedColorSimilarity ()))
-            {
-                transparencyMaskPainter.setPen (Qt::color1/*transparent*/);
-                hasTransparent = true;
-            }
-            else
-            {
-                transparencyMaskPainter.setPen (Qt::color0/*opaque*/);
-            }
+            for (int x = 0; x < width; x++)
+                opaqueRow [x] = 0xFF000000 | rgbaRow [x];
 
-            transparencyMaskPainter.drawPoint (x, y);
+            rgbaRow = opaqueRow.constData ();
         }
-    }
 
-    transparencyMaskPainter.end ();
+        if (transparentColor.isValid ())
+        {
+            ::CalculateTransparentFlags (rgbaRow, width,
+                transparentColor.toQRgb (), processedSimilarity,
+                flags.data ());
+        }
+        else
+        {
+            // An invalid color is not similar to any pixel: only pick up
+            // the fully transparent ones.
+            for (int x = 0; x < width; x++)
+                flags [x] = uchar (rgbaRow [x] == 0/*kpColor::Transparent*/);
+        }
+
+        if (::PackFlagsLSB (flags.constData (), width, mask.scanLine (y)))
+            hasTransparent = true;
+    }
 
     if (!hasTransparent)
     {
     #if DEBUG_KP_SELECTION
         kDebug () << "\tcolour useless - completely opaque";
     #endif
-        d->transparencyMaskCache = QBitmap ();
+        d->transparencyMaskCache = QImage ();
         return;
     }
+
+    d->transparencyMaskCache = mask;
 }
 
 //---------------------------------------------------------------------
@@ -492,9 +608,32 @@ kpImage kpAbstractImageSelection::transparentImage () const
 
     if (!d->transparencyMaskCache.isNull ())
     {
-      QPainter painter(&image);
-      painter.setCompositionMode(QPainter::CompositionMode_Clear);
-      painter.drawPixmap(0, 0, d->transparencyMaskCache);
+        if (image.format () != QImage::Format_ARGB32_Premultiplied)
+            image = image.convertToFormat (QImage::Format_ARGB32_Premultiplied);
+
+        const QImage &mask = d->transparencyMaskCache;
+        Q_ASSERT (mask.size () == image.size ());
+
+        // Clear every pixel whose mask bit is set.
+        for (int y = 0; y < image.height (); y++)
+        {
+            const uchar *bits = mask.constScanLine (y);
+            QRgb *rgbaRow = reinterpret_cast <QRgb *> (image.scanLine (y));
+
+            for (int x = 0; x < image.width (); x += 8)
+            {
+                const uchar byte = bits [x / 8];
+                if (!byte)
+                    continue;
+
+                const int bitsInByte = qMin (8, image.width () - x);
+                for (int b = 0; b < bitsInByte; b++)
+                {
+                    if (byte & (1 << b))
+                        rgbaRow [x + b] = 0;
+                }
+            }
+        }
     }
 
     return image;
@@ -540,11 +679,11 @@ void kpAbstractImageSelection::flip (bool horiz, bool vert)
     if (!d->transparencyMaskCache.isNull ())
     {
     #if DEBUG_KP_SELECTION && 1
-        kDebug () << "\thave transparency mask - flipping that";
+        kDebug () << "\thave transparency mask - recalculating that";
     #endif
-        QImage image = d->transparencyMaskCache.toImage();
-        kpPixmapFX::flip (&image, horiz, vert);
-        d->transparencyMaskCache = QBitmap::fromImage(image);
+        // Rebuilding the mask from the flipped image is as cheap as
+        // flipping it and keeps its padding bits clear.
+        recalculateTransparencyMaskCache ();
     }
 
     emit changed (boundingRect ());
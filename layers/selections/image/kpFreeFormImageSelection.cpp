@@ -67,6 +67,13 @@ struct kpFreeFormImageSelectionPrivate
     // These interpolated points are stored in <cardPointsCache>.  Regarding
     // <cardPointsLoopCache>, see the APIDoc for cardinallyAdjacentPointsLoop().
     QPolygon cardPointsCache, cardPointsLoopCache;
+
+    // The points interpolated from the last to the first point of
+    // <cardPointsCache>, not including the last.  Kept apart so that
+    // appendPoint() only has to redo this segment, and <cardPointsLoopCache>
+    // is only put together when needed.
+    QPolygon cardPointsClosingCache;
+    bool cardPointsLoopCacheValid;
 };
 
 
@@ -75,6 +82,7 @@ kpFreeFormImageSelection::kpFreeFormImageSelection (
     : kpAbstractImageSelection (transparency),
       d (new kpFreeFormImageSelectionPrivate ())
 {
+    d->cardPointsLoopCacheValid = true;
 }
 
 kpFreeFormImageSelection::kpFreeFormImageSelection (const QPolygon &points,
@@ -110,6 +118,8 @@ kpFreeFormImageSelection &kpFreeFormImageSelection::operator= (const kpFreeFormI
     d->orgPoints = rhs.d->orgPoints;
     d->cardPointsCache = rhs.d->cardPointsCache;
     d->cardPointsLoopCache = rhs.d->cardPointsLoopCache;
+    d->cardPointsClosingCache = rhs.d->cardPointsClosingCache;
+    d->cardPointsLoopCacheValid = rhs.d->cardPointsLoopCacheValid;
 
     return *this;
 }
@@ -161,7 +171,8 @@ kpCommandSize::SizeType kpFreeFormImageSelection::size () const
     return kpAbstractImageSelection::size () +
         (kpCommandSize::PolygonSize (d->orgPoints) +
          kpCommandSize::PolygonSize (d->cardPointsCache) +
-         kpCommandSize::PolygonSize (d->cardPointsLoopCache));
+         kpCommandSize::PolygonSize (d->cardPointsLoopCache) +
+         kpCommandSize::PolygonSize (d->cardPointsClosingCache));
 }
 
 // public virtual [kpAbstractSelection]
@@ -177,6 +188,40 @@ QPolygon kpFreeFormImageSelection::originalPoints () const
 }
 
 
+// Returns the points from <from> (exclusive) to <to> (inclusive), such that
+// consecutive points are cardinally adjacent.  Empty if <from> == <to>.
+static QPolygon CardinallyAdjacentSegment (const QPoint &from, const QPoint &to)
+{
+    QPolygon segment;
+
+    if (from == to)
+        return segment;
+
+    if (kpPainter::pointsAreCardinallyAdjacent (to, from))
+    {
+        segment.append (to);
+        return segment;
+    }
+
+    QList <QPoint> interpPoints = kpPainter::interpolatePoints (
+        from,
+        to,
+        true/*cardinal adjacency*/);
+
+    Q_ASSERT (interpPoints.size () >= 2);
+    Q_ASSERT (interpPoints [0] == from);
+    Q_ASSERT (interpPoints.last () == to);
+
+    for (int i = 1/*skip already existing point*/;
+         i < interpPoints.size ();
+         i++)
+    {
+        segment.append (interpPoints [i]);
+    }
+
+    return segment;
+}
+
 static QPolygon RecalculateCardinallyAdjacentPoints (const QPolygon &points)
 {
 #if DEBUG_KP_SELECTION
@@ -202,27 +247,8 @@ static QPolygon RecalculateCardinallyAdjacentPoints (const QPolygon &points)
     QPolygon cardPoints;
     foreach (const QPoint &p, noDups)
     {
-        if (!cardPoints.isEmpty () &&
-            !kpPainter::pointsAreCardinallyAdjacent (p, cardPoints.last ()))
-        {
-            const QPoint lastPoint = cardPoints.last ();
-
-            QList <QPoint> interpPoints = kpPainter::interpolatePoints (
-                lastPoint,
-                p,
-                true/*cardinal adjacency*/);
-
-            Q_ASSERT (interpPoints.size () >= 2);
-            Q_ASSERT (interpPoints [0] == lastPoint);
-            Q_ASSERT (interpPoints.last () == p);
-
-            for (int i = 1/*skip already existing point*/;
-                 i < interpPoints.size ();
-                 i++)
-            {
-                cardPoints.append (interpPoints [i]);
-            }
-        }
+        if (!cardPoints.isEmpty ())
+            cardPoints += ::CardinallyAdjacentSegment (cardPoints.last (), p);
         else
             cardPoints.append (p);
     }
@@ -238,15 +264,17 @@ void kpFreeFormImageSelection::recalculateCardinallyAdjacentPoints ()
 {
     d->cardPointsCache = ::RecalculateCardinallyAdjacentPoints (d->orgPoints);
 
+    // Only the closing segment needs interpolating, since the rest of the
+    // loop is <cardPointsCache>.
+    d->cardPointsClosingCache.clear ();
+    if (!d->cardPointsCache.isEmpty ())
+    {
+        d->cardPointsClosingCache = ::CardinallyAdjacentSegment (
+            d->cardPointsCache.last (), d->cardPointsCache.first ());
+    }
 
-    QPolygon pointsLoop = d->cardPointsCache;
-    if (!pointsLoop.isEmpty ())
-        pointsLoop.append (pointsLoop.first ());
-
-    // OPT: We know this method only needs to act on the last 2 points of
-    //      "pointLoop", since the previous points are definitely cardinally
-    //      adjacent.
-    d->cardPointsLoopCache = ::RecalculateCardinallyAdjacentPoints (pointsLoop);
+    d->cardPointsLoopCache.clear ();
+    d->cardPointsLoopCacheValid = false;
 }
 
 // public
@@ -258,6 +286,12 @@ QPolygon kpFreeFormImageSelection::cardinallyAdjacentPoints () const
 // public
 QPolygon kpFreeFormImageSelection::cardinallyAdjacentPointsLoop () const
 {
+    if (!d->cardPointsLoopCacheValid)
+    {
+        d->cardPointsLoopCache = d->cardPointsCache + d->cardPointsClosingCache;
+        d->cardPointsLoopCacheValid = true;
+    }
+
     return d->cardPointsLoopCache;
 }
 
@@ -265,14 +299,15 @@ QPolygon kpFreeFormImageSelection::cardinallyAdjacentPointsLoop () const
 // public virtual [kpAbstractSelection]
 QPolygon kpFreeFormImageSelection::calculatePoints () const
 {
-    return d->cardPointsLoopCache;
+    return cardinallyAdjacentPointsLoop ();
 }
 
 
 // protected virtual [kpAbstractSelection]
 QRegion kpFreeFormImageSelection::shapeRegion () const
 {
-    const QRegion region = QRegion (d->cardPointsLoopCache, Qt::OddEvenFill);
+    const QRegion region = QRegion (cardinallyAdjacentPointsLoop (),
+                                    Qt::OddEvenFill);
 
     // In Qt4, while QPainter::drawRect() gives you rectangles 1 pixel
     // wider and higher, QRegion(QPolygon) gives you regions 1 pixel
@@ -293,7 +328,7 @@ QRegion kpFreeFormImageSelection::shapeRegion () const
     //    Having said that, this is probably the safest option as region shifting
     //    is dodgy.  Also, this would guarantee that shapeBitmap() and shapeRegion()
     //    are consistent and we wouldn't need cardinally adjacent points either
-    //    (d->cardPointsCache and d->cardPointsLoopCache).
+    //    (d->cardPointsCache and cardinallyAdjacentPointsLoop()).
     const QRegion regionX = region.translated (1, 0);
     const QRegion regionY = region.translated (0, 1);
     const QRegion regionXY = region.translated (1, 1);
@@ -315,6 +350,48 @@ bool kpFreeFormImageSelection::contains (const QPoint &point) const
 }
 
 
+// public
+void kpFreeFormImageSelection::appendPoint (const QPoint &point)
+{
+    // The base image would need to grow with the border.
+    Q_ASSERT (!hasContent ());
+
+    d->orgPoints.append (point);
+
+    if (d->cardPointsCache.isEmpty ())
+    {
+        recalculateCardinallyAdjacentPoints ();
+        setBoundingRect (d->orgPoints.boundingRect ());
+
+        emit changed (boundingRect ());
+        return;
+    }
+
+    const QPoint lastPoint = d->cardPointsCache.last ();
+
+    const QPolygon segment = ::CardinallyAdjacentSegment (lastPoint, point);
+    if (segment.isEmpty ())
+        return;
+
+    d->cardPointsCache += segment;
+
+    d->cardPointsClosingCache = ::CardinallyAdjacentSegment (
+        d->cardPointsCache.last (), d->cardPointsCache.first ());
+
+    d->cardPointsLoopCache.clear ();
+    d->cardPointsLoopCacheValid = false;
+
+    #if QT_VERSION >= 0x050000
+    setBoundingRect (boundingRect ().united (QRect (point, point)));
+    #else
+    setBoundingRect (boundingRect ().unite (QRect (point, point)));
+    #endif
+
+    // Until the selection is finished, its border is drawn without the
+    // closing segment so only the new segment needs repainting.
+    emit changed (QRect (lastPoint, point).normalized ());
+}
+
 // public virtual [base kpAbstractSelection]
 void kpFreeFormImageSelection::moveBy (int dx, int dy)
 {
@@ -322,6 +399,7 @@ void kpFreeFormImageSelection::moveBy (int dx, int dy)
 
     d->cardPointsCache.translate (dx, dy);
     d->cardPointsLoopCache.translate (dx, dy);
+    d->cardPointsClosingCache.translate (dx, dy);
 
     // Call base last since it fires the changed() signal and we only
     // want that to fire at the very end of this method, after all
@@ -359,6 +437,7 @@ void kpFreeFormImageSelection::flip (bool horiz, bool vert)
 
     ::FlipPoints (&d->cardPointsCache, horiz, vert, boundingRect ());
     ::FlipPoints (&d->cardPointsLoopCache, horiz, vert, boundingRect ());
+    ::FlipPoints (&d->cardPointsClosingCache, horiz, vert, boundingRect ());
 
 
     // Call base last since it fires the changed() signal and we only
@@ -137,6 +137,11 @@ public:
 //
 
 public:
+    // Appends <point> to the originalPoints(), interpolating only the new
+    // segment, and emits changed() for just that segment.  Only for
+    // selections without content that are being dragged out.
+    void appendPoint (const QPoint &point);
+
     virtual void moveBy (int dx, int dy);
 
     virtual void flip (bool horiz, bool vert);
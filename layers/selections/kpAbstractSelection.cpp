@@ -155,6 +155,12 @@ QRect kpAbstractSelection::boundingRect () const
     return d->rect;
 }
 
+// protected
+void kpAbstractSelection::setBoundingRect (const QRect &rect)
+{
+    d->rect = rect;
+}
+
 // public static
 QPolygon kpAbstractSelection::CalculatePointsForRectangle (const QRect &rect)
 {
@@ -170,6 +170,10 @@ public:
     // Returns the bounding rectangle.
     QRect boundingRect () const;
 
+protected:
+    // For subclasses whose border grows in place.  Does not emit changed().
+    void setBoundingRect (const QRect &rect);
+
 public:
     // Use this to implement calculatePoints() for rectangular selections.
     static QPolygon CalculatePointsForRectangle (const QRect &rect);
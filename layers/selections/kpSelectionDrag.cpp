@@ -35,6 +35,7 @@
 
 #include <qdatastream.h>
 #include <QImage>
+#include <QStringList>
 
 #include <qdebug.h>
 
@@ -50,7 +51,13 @@ const char * const kpSelectionDrag::SelectionMimeType =
 
 //---------------------------------------------------------------------
 
+// The format that QMimeData::hasImage() and QMimeData::imageData() use.
+static const char * const ImageMimeType = "application/x-qt-image";
+
+//---------------------------------------------------------------------
+
 kpSelectionDrag::kpSelectionDrag (const kpAbstractImageSelection &sel)
+    : m_selection (sel.clone ())
 {
 #if DEBUG_KP_SELECTION_DRAG && 1
     kDebug () << "kpSelectionDrag() w=" << sel.width ()
@@ -60,30 +67,78 @@ kpSelectionDrag::kpSelectionDrag (const kpAbstractImageSelection &sel)
 
     Q_ASSERT (sel.hasContent ());
 
-    // Store as selection.
-    QByteArray ba;
-    {
-        QDataStream stream (&ba, QIODevice::WriteOnly);
-        stream << sel;
-    }
-    setData (kpSelectionDrag::SelectionMimeType, ba);
+    // (the base image is shared with <sel> until one of them is modified
+    //  so nothing is serialized or converted until retrieveData())
+}
 
-    // Store as image (so that QMimeData::hasImage()) works).
-    // OPT: an awful waste of memory storing image in both selection and QImage
-    const QImage image = sel.baseImage ();
-#if DEBUG_KP_SELECTION_DRAG && 1
-    kDebug () << "\timage: w=" << image.width ()
-               << " h=" << image.height ()
-               << endl;
+//---------------------------------------------------------------------
+
+kpSelectionDrag::~kpSelectionDrag ()
+{
+    delete m_selection;
+}
+
+//---------------------------------------------------------------------
+
+// public virtual [base QMimeData]
+QStringList kpSelectionDrag::formats () const
+{
+    QStringList ret;
+    ret << QString::fromLatin1 (kpSelectionDrag::SelectionMimeType)
+        // So that QMimeData::hasImage() works.
+        << QString::fromLatin1 (::ImageMimeType);
+    return ret;
+}
+
+//---------------------------------------------------------------------
+
+// public virtual [base QMimeData]
+bool kpSelectionDrag::hasFormat (const QString &mimeType) const
+{
+    return formats ().contains (mimeType);
+}
+
+//---------------------------------------------------------------------
+
+// protected virtual [base QMimeData]
+QVariant kpSelectionDrag::retrieveData (const QString &mimeType,
+        QVariant::Type type) const
+{
+#if DEBUG_KP_SELECTION_DRAG
+    kDebug () << "kpSelectionDrag::retrieveData(" << mimeType
+              << "," << type << ")";
 #endif
-    if (image.isNull ())
+
+    if (mimeType == QLatin1String (kpSelectionDrag::SelectionMimeType))
+    {
+        QByteArray ba;
+        {
+            QDataStream stream (&ba, QIODevice::WriteOnly);
+            stream << *m_selection;
+        }
+
+        return ba;
+    }
+    else if (mimeType == QLatin1String (::ImageMimeType))
     {
-        // TODO: proper error handling.
-        qCritical () << "kpSelectionDrag::setSelection() could not convert to image"
+        const QImage image = m_selection->baseImage ();
+    #if DEBUG_KP_SELECTION_DRAG && 1
+        kDebug () << "\timage: w=" << image.width ()
+                   << " h=" << image.height ()
                    << endl;
+    #endif
+        if (image.isNull ())
+        {
+            // TODO: proper error handling.
+            qCritical () << "kpSelectionDrag::retrieveData() could not convert to image"
+                       << endl;
+            return QVariant ();
+        }
+
+        return image;
     }
-    else
-        setImageData (image);
+
+    return QMimeData::retrieveData (mimeType, type);
 }
 
 //---------------------------------------------------------------------
@@ -99,9 +154,10 @@ bool kpSelectionDrag::canDecode(const QMimeData *mimeData)
              << "hasImage=" << mimeData->hasImage();
 #endif
 
-    // mimeData->hasImage() would not check if the data is a valid image
+    // Don't decode the image to check that it is valid: it could be huge
+    // and this is called whenever any application changes the clipboard.
     return mimeData->hasFormat(kpSelectionDrag::SelectionMimeType) ||
-           !qvariant_cast<QImage>(mimeData->imageData()).isNull();
+           mimeData->hasImage();
 }
 
 //---------------------------------------------------------------------
@@ -114,6 +170,16 @@ kpAbstractImageSelection *kpSelectionDrag::decode(const QMimeData *mimeData)
 #endif
     Q_ASSERT (mimeData);
 
+    // Our own selection, in this process?  Then skip serialization.
+    const kpSelectionDrag *selDrag = qobject_cast <const kpSelectionDrag *> (mimeData);
+    if (selDrag)
+    {
+    #if DEBUG_KP_SELECTION_DRAG
+        kDebug () << "\tmimeSource is our own selection - clone it";
+    #endif
+        return selDrag->m_selection->clone ();
+    }
+
     if (mimeData->hasFormat (kpSelectionDrag::SelectionMimeType))
     {
     #if DEBUG_KP_SELECTION_DRAG
@@ -33,6 +33,13 @@
 class kpAbstractImageSelection;
 
 
+//
+// Clipboard and drag data for an image selection.
+//
+// The selection is only serialized (to SelectionMimeType) or converted to
+// an image when a consumer actually asks for that format, so copying a
+// huge selection costs no more than a (copy-on-write) clone of it.
+//
 class kpSelectionDrag : public QMimeData
 {
   Q_OBJECT
@@ -42,10 +49,25 @@ class kpSelectionDrag : public QMimeData
 
     // ASSUMPTION: <sel> has content (is not just a border).
     kpSelectionDrag(const kpAbstractImageSelection &sel);
+    virtual ~kpSelectionDrag();
 
   public:
+    virtual QStringList formats() const;
+    virtual bool hasFormat(const QString &mimeType) const;
+
+  protected:
+    virtual QVariant retrieveData(const QString &mimeType,
+                                  QVariant::Type type) const;
+
+  public:
+    // Only looks at the advertised formats so that it is cheap enough to be
+    // called on every clipboard change.  decode() may still fail if the
+    // data turns out to be invalid.
     static bool canDecode(const QMimeData *mimeData);
     static kpAbstractImageSelection *decode(const QMimeData *mimeData);
+
+  private:
+    kpAbstractImageSelection *m_selection;
 };
 
 
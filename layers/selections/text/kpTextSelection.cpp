@@ -289,9 +289,122 @@ QList <QString> kpTextSelection::textLines () const
 // public
 void kpTextSelection::setTextLines (const QList <QString> &textLines_)
 {
+    const QList <QString> oldTextLines = d->textLines;
     d->textLines = textLines_;
 
-    emit changed (boundingRect ());
+    // Gaining or losing content changes more than the text.
+    if (oldTextLines.isEmpty () || d->textLines.isEmpty ())
+    {
+        d->renderDirtyFirstRow = 0;
+        d->renderDirtyLastRow = qMax (oldTextLines.count (), d->textLines.count ());
+
+        emit changed (boundingRect ());
+        return;
+    }
+
+    const int minCount = qMin (oldTextLines.count (), d->textLines.count ());
+    const int maxCount = qMax (oldTextLines.count (), d->textLines.count ());
+
+    int firstRow = 0;
+    while (firstRow < minCount && oldTextLines [firstRow] == d->textLines [firstRow])
+        firstRow++;
+
+    // Rows below a line that was added or removed have all moved.
+    int lastRow = maxCount - 1;
+    if (oldTextLines.count () == d->textLines.count ())
+    {
+        while (lastRow >= firstRow && oldTextLines [lastRow] == d->textLines [lastRow])
+            lastRow--;
+    }
+
+    if (firstRow > lastRow)
+        return;
+
+    textRowsChanged (firstRow, lastRow);
+}
+
+// public
+int kpTextSelection::textLineCount () const
+{
+    return d->textLines.count ();
+}
+
+// public
+QString kpTextSelection::textLine (int row) const
+{
+    return d->textLines.value (row);
+}
+
+// public
+void kpTextSelection::setTextLine (int row, const QString &textLine)
+{
+    Q_ASSERT (row >= 0 && row < d->textLines.count ());
+
+    d->textLines [row] = textLine;
+
+    textRowsChanged (row, row);
+}
+
+// public
+void kpTextSelection::insertTextLine (int row, const QString &textLine)
+{
+    Q_ASSERT (row >= 0 && row <= d->textLines.count ());
+
+    if (d->textLines.isEmpty ())
+    {
+        setTextLines (QList <QString> () << textLine);
+        return;
+    }
+
+    d->textLines.insert (row, textLine);
+
+    textRowsChanged (row, d->textLines.count () - 1);
+}
+
+// public
+void kpTextSelection::removeTextLine (int row)
+{
+    Q_ASSERT (row >= 0 && row < d->textLines.count ());
+
+    if (d->textLines.count () == 1)
+    {
+        setTextLines (QList <QString> ());
+        return;
+    }
+
+    d->textLines.removeAt (row);
+
+    // (the old last row is now empty)
+    textRowsChanged (row, d->textLines.count ());
+}
+
+// private
+void kpTextSelection::textRowsChanged (int firstRow, int lastRow)
+{
+    // (updateRenderCache() handles glyphs sticking into neighbouring rows)
+    if (d->renderDirtyFirstRow < 0)
+    {
+        d->renderDirtyFirstRow = firstRow;
+        d->renderDirtyLastRow = lastRow;
+    }
+    else
+    {
+        d->renderDirtyFirstRow = qMin (d->renderDirtyFirstRow, firstRow);
+        d->renderDirtyLastRow = qMax (d->renderDirtyLastRow, lastRow);
+    }
+
+    // Glyphs may stick out of their line (e.g. accents and descenders).
+    firstRow = qMax (0, firstRow - 1);
+    lastRow++;
+
+    const QFontMetrics fontMetrics (d->textStyle.font ());
+    const int top = textAreaRect ().y () + firstRow * fontMetrics.lineSpacing ();
+    const int bottom = textAreaRect ().y () + (lastRow + 1) * fontMetrics.lineSpacing () - 1;
+
+    const QRect rowsRect =
+        QRect (x (), top, width (), bottom - top + 1).intersected (boundingRect ());
+    if (!rowsRect.isEmpty ())
+        emit changed (rowsRect);
 }
 
 
@@ -207,8 +207,25 @@ public:
 
 public:
     QList <QString> textLines () const;
+    // Only the rows that differ from the current textLines() are repainted.
     void setTextLines (const QList <QString> &textLines);
 
+    // Access textLines() one line at a time, without copying the list.
+    int textLineCount () const;
+    QString textLine (int row) const;
+
+    // Edit textLines() in place.  Only the rows that change are repainted:
+    // <row> for setTextLine() and <row> plus the rows below it, which move
+    // up or down, for insertTextLine() and removeTextLine().
+    void setTextLine (int row, const QString &textLine);
+    void insertTextLine (int row, const QString &textLine);
+    void removeTextLine (int row);
+
+private:
+    // Marks rows <firstRow> to <lastRow> inclusive, and their neighbours,
+    // for re-rendering and emits changed() for them.
+    void textRowsChanged (int firstRow, int lastRow);
+
     static QString TextForTextLines (const QList <QString> &textLines);
     // Returns textLines() as one long newline-separated string.
     // If the last text line is not empty, there is no trailing newline.
@@ -265,6 +282,15 @@ public:
 private:
     void drawPreeditString(QPainter &painter, int &x, int y, const kpPreeditText &preeditText) const;
 
+    // Draws text lines <firstRow> to <lastRow> inclusive (and the preedit
+    // text, if it is on one of them) onto <painter>, whose origin is the
+    // top-left of the boundingRect().
+    void drawTextLines(QPainter &painter, int firstRow, int lastRow) const;
+
+    // Brings the cached rendering of the text box up to date, re-rendering
+    // only the lines that changed if possible.
+    void updateRenderCache() const;
+
 public:
     virtual void paint(QImage *destPixmap, const QRect &docRect) const;
 
@@ -31,6 +31,7 @@
 
 
 #include <QList>
+#include <QString>
 
 #include <kpImage.h>
 #include <kpTextStyle.h>
@@ -41,6 +42,25 @@ struct kpTextSelectionPrivate
     QList <QString> textLines;
     kpTextStyle textStyle;
     kpPreeditText preeditText;
+
+    // The text box rendered by kpTextSelection::paint(), relative to the
+    // top-left of the boundingRect(), and what it was rendered from.
+    //
+    // paint() only re-renders the rows that changed since, from
+    // <renderDirtyFirstRow> to <renderDirtyLastRow> inclusive (-1 if
+    // none), so blinking the cursor, or typing, does not re-render the
+    // whole box.
+    mutable kpImage renderCache;
+    mutable kpTextStyle renderedTextStyle;
+    mutable bool renderedWithPreedit;
+    mutable int renderDirtyFirstRow, renderDirtyLastRow;
+
+    kpTextSelectionPrivate ()
+        : renderedWithPreedit (false),
+          renderDirtyFirstRow (-1),
+          renderDirtyLastRow (-1)
+    {
+    }
 };
 
 
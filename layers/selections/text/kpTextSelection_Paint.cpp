@@ -111,44 +111,13 @@ void kpTextSelection::drawPreeditString(QPainter &painter, int &x, int y, const
 
 //---------------------------------------------------------------------
 
-// public virtual [kpAbstractSelection]
-void kpTextSelection::paint(QImage *destPixmap, const QRect &docRect) const
+// private
+void kpTextSelection::drawTextLines(QPainter &painter, int firstRow, int lastRow) const
 {
-#if DEBUG_KP_SELECTION
-    kDebug () << "kpTextSelection::paint() textStyle: fcol="
-            << (int *) d->textStyle.foregroundColor ().toQRgb ()
-            << " bcol="
-            << (int *) d->textStyle.backgroundColor ().toQRgb ()
-            << endl;
-#endif
-
-    // Drawing text is slow so if the text box will be rendered completely
-    // outside of <destRect>, don't bother rendering it at all.
-    #if QT_VERSION >= 0x050000
-    const QRect modifyingRect = docRect.intersected (boundingRect ());
-    #else
-    const QRect modifyingRect = docRect.intersect (boundingRect ());
-    #endif
-    if (modifyingRect.isEmpty ())
-        return;
-
-
-    // Is the text box completely invisible?
-    if (textStyle ().foregroundColor ().isTransparent () &&
-        textStyle ().backgroundColor ().isTransparent ())
-    {
-        return;
-    }
-
-    kpImage floatImage(modifyingRect.size(), QImage::Format_ARGB32_Premultiplied);
-    floatImage.fill(0);
-
-    QRect theWholeAreaRect, theTextAreaRect;
-    theWholeAreaRect = boundingRect ().translated (-modifyingRect.topLeft ());
-    theTextAreaRect = textAreaRect ().translated (-modifyingRect.topLeft ());
+    const QRect theTextAreaRect = textAreaRect ().translated (-topLeft ());
 
-    QList <QString> theTextLines = textLines();
-    kpTextStyle theTextStyle = textStyle();
+    const QList <QString> &theTextLines = d->textLines;
+    const kpTextStyle &theTextStyle = d->textStyle;
 
     const QFontMetrics fontMetrics (theTextStyle.font ());
 
@@ -162,15 +131,6 @@ void kpTextSelection::paint(QImage *destPixmap, const QRect &docRect) const
                << endl;
 #endif
 
-    QPainter painter(&floatImage);
-
-    // Fill in the background using the transparent/opaque tool setting
-    if ( theTextStyle.isBackgroundTransparent() )
-      painter.fillRect(theWholeAreaRect, Qt::transparent);
-    else
-      painter.fillRect(theWholeAreaRect, theTextStyle.backgroundColor().toQColor());
-
-    painter.setClipRect(theWholeAreaRect);
     painter.setPen(theTextStyle.foregroundColor().toQColor());
     painter.setFont(theTextStyle.font());
 
@@ -181,10 +141,11 @@ void kpTextSelection::paint(QImage *destPixmap, const QRect &docRect) const
       // into the background where the text is
       painter.setCompositionMode(QPainter::CompositionMode_Clear);
 
-      int baseLine = theTextAreaRect.y () + fontMetrics.ascent ();
-      foreach (const QString &str, theTextLines)
+      int baseLine = theTextAreaRect.y () + fontMetrics.ascent () +
+                     firstRow * fontMetrics.lineSpacing ();
+      for (int i = firstRow; i <= lastRow && i < theTextLines.count (); i++)
       {
-          painter.drawText (theTextAreaRect.x (), baseLine, str);
+          painter.drawText (theTextAreaRect.x (), baseLine, theTextLines [i]);
           baseLine += fontMetrics.lineSpacing ();
 
           // if the next textline would already be below the visible text area, stop drawing
@@ -199,9 +160,10 @@ void kpTextSelection::paint(QImage *destPixmap, const QRect &docRect) const
     // Draw a line at a time instead of using QPainter::drawText(QRect,...).
     // Else, the line heights become >QFontMetrics::height() if you type Chinese
     // characters (!) and then the cursor gets out of sync.
-    int baseLine = theTextAreaRect.y () + fontMetrics.ascent ();
+    int baseLine = theTextAreaRect.y () + fontMetrics.ascent () +
+                   firstRow * fontMetrics.lineSpacing ();
 
-    kpPreeditText thePreeditText = preeditText();
+    const kpPreeditText &thePreeditText = d->preeditText;
 
     if ( theTextLines.isEmpty() )
     {
@@ -213,11 +175,12 @@ void kpTextSelection::paint(QImage *destPixmap, const QRect &docRect) const
     }
     else
     {
-        int i = 0;
         int row = thePreeditText.position().y();
         int col = thePreeditText.position().x();
-        foreach (const QString &str, theTextLines)
+        for (int i = firstRow; i <= lastRow && i < theTextLines.count (); i++)
         {
+            const QString &str = theTextLines [i];
+
             if (row == i && !thePreeditText.isEmpty())
             {
                 QString left = str.left(col);
@@ -234,19 +197,132 @@ void kpTextSelection::paint(QImage *destPixmap, const QRect &docRect) const
                 painter.drawText(theTextAreaRect.x (), baseLine, str);
             }
             baseLine += fontMetrics.lineSpacing();
-            i++;
 
             // if the next textline would already be below the visible text area, stop drawing
             if ( (baseLine - fontMetrics.ascent()) > (theTextAreaRect.y() + theTextAreaRect.height()) )
               break;
         }
     }
+}
+
+//---------------------------------------------------------------------
+
+// private
+void kpTextSelection::updateRenderCache() const
+{
+    const QRect theWholeAreaRect (QPoint (0, 0), boundingRect ().size ());
+    const QRect theTextAreaRect = textAreaRect ().translated (-topLeft ());
+
+    const kpTextStyle &theTextStyle = d->textStyle;
+    const QFontMetrics fontMetrics (theTextStyle.font ());
+
+    const QColor backgroundColor = theTextStyle.isBackgroundTransparent () ?
+        QColor (Qt::transparent) :
+        theTextStyle.backgroundColor ().toQColor ();
+
+    // Only the lines that changed can be re-rendered if nothing else about
+    // the text box changed.  Preedit text is transient and negative leading
+    // makes lines overlap, so don't bother in those cases.
+    const bool canRenderChangedLinesOnly =
+        d->renderCache.size () == theWholeAreaRect.size () &&
+        d->renderedTextStyle == theTextStyle &&
+        !d->renderedWithPreedit && d->preeditText.isEmpty () &&
+        fontMetrics.leading () >= 0;
+
+    if (!canRenderChangedLinesOnly)
+    {
+    #if DEBUG_KP_SELECTION
+        kDebug () << "kpTextSelection::updateRenderCache() rendering everything";
+    #endif
+        d->renderCache = kpImage (theWholeAreaRect.size (),
+                                  QImage::Format_ARGB32_Premultiplied);
+        d->renderCache.fill (0);
+
+        QPainter painter (&d->renderCache);
+
+        // Fill in the background using the transparent/opaque tool setting
+        painter.fillRect (theWholeAreaRect, backgroundColor);
+
+        painter.setClipRect (theWholeAreaRect);
+        drawTextLines (painter, 0, d->textLines.count () - 1);
+    }
+    else if (d->renderDirtyFirstRow >= 0)
+    {
+        // Glyphs may stick out of their line (e.g. accents and descenders)
+        // so the neighbouring lines' parts must be cleared and redrawn too.
+        const int firstRow = qMax (0, d->renderDirtyFirstRow - 1);
+        const int lastRow = d->renderDirtyLastRow + 1;
+
+    #if DEBUG_KP_SELECTION
+        kDebug () << "kpTextSelection::updateRenderCache() rendering rows"
+                  << firstRow << "to" << lastRow;
+    #endif
+
+        const QRect band =
+            QRect (theWholeAreaRect.x (),
+                   theTextAreaRect.y () + firstRow * fontMetrics.lineSpacing (),
+                   theWholeAreaRect.width (),
+                   (lastRow - firstRow + 1) * fontMetrics.lineSpacing ())
+                .intersected (theWholeAreaRect);
+
+        if (!band.isEmpty ())
+        {
+            QPainter painter (&d->renderCache);
+            painter.setClipRect (band);
+
+            painter.setCompositionMode (QPainter::CompositionMode_Source);
+            painter.fillRect (band, backgroundColor);
+            painter.setCompositionMode (QPainter::CompositionMode_SourceOver);
+
+            // The lines just outside <band> may stick into it as well.
+            drawTextLines (painter, qMax (0, firstRow - 1), lastRow + 1);
+        }
+    }
+
+    d->renderDirtyFirstRow = d->renderDirtyLastRow = -1;
+    d->renderedTextStyle = theTextStyle;
+    d->renderedWithPreedit = !d->preeditText.isEmpty ();
+}
+
+//---------------------------------------------------------------------
+
+// public virtual [kpAbstractSelection]
+void kpTextSelection::paint(QImage *destPixmap, const QRect &docRect) const
+{
+#if DEBUG_KP_SELECTION
+    kDebug () << "kpTextSelection::paint() textStyle: fcol="
+            << (int *) d->textStyle.foregroundColor ().toQRgb ()
+            << " bcol="
+            << (int *) d->textStyle.backgroundColor ().toQRgb ()
+            << endl;
+#endif
+
+    // Drawing text is slow so if the text box will be rendered completely
+    // outside of <destRect>, don't bother rendering it at all.
+    #if QT_VERSION >= 0x050000
+    const QRect modifyingRect = docRect.intersected (boundingRect ());
+    #else
+    const QRect modifyingRect = docRect.intersect (boundingRect ());
+    #endif
+    if (modifyingRect.isEmpty ())
+        return;
+
+
+    // Is the text box completely invisible?
+    if (textStyle ().foregroundColor ().isTransparent () &&
+        textStyle ().backgroundColor ().isTransparent ())
+    {
+        return;
+    }
+
+    updateRenderCache ();
 
     // ... convert that into "painting" transparent pixels on top of
-    // the document.
+    // the document.  Only the part being repainted is copied, so that
+    // e.g. a cursor blink costs only the cursor rectangle.
     kpPixmapFX::paintPixmapAt (destPixmap,
         modifyingRect.topLeft () - docRect.topLeft (),
-        floatImage);
+        d->renderCache.copy (modifyingRect.translated (-topLeft ())));
 }
 
 //---------------------------------------------------------------------
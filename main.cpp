@@ -31,20 +31,57 @@
 
 #include <qapplication.h>
 #include <qdebug.h>
+#include <qfileinfo.h>
 #include <qlocale.h>
 #include <qmessagebox.h>
+#include <qtimer.h>
 
 #include <kpDefs.h>
 #include <kpMainWindow.h>
 #include <kpApplication.h>
 #include <kpDocument.h>
+#include <kpInputRecorder.h>
+#include <kpInputReplayer.h>
+#include <kpStartupTimes.h>
 
 
 int main (int argc, char *argv [])
 {
+    kpStartupTimes::Start ();
+
+    // Replays are for benchmarking and need no display: default to the
+    // offscreen platform unless told otherwise.  This must be decided
+    // before the application object exists.
+    bool replay = false, platformGiven = false;
+    for (int i = 1; i < argc; i++) {
+        if (qstrcmp (argv [i], "--replay") == 0)
+            replay = true;
+        else if (qstrcmp (argv [i], "-platform") == 0)
+            platformGiven = true;
+        else if (qstrcmp (argv [i], "--startup-times") == 0)
+            kpStartupTimes::SetEnabled (true);
+    }
+    if (replay && !platformGiven && qEnvironmentVariableIsEmpty ("QT_QPA_PLATFORM"))
+        qputenv ("QT_QPA_PLATFORM", "offscreen");
 
     kpApplication app(argc, argv);
-    QStringList arg = QApplication::arguments();
+    kpStartupTimes::Mark (QLatin1String ("application"));
+
+    // Strip our own options; what remains are files to open.
+    QString recordFileName, replayFileName;
+    bool replayRealTime = false;
+    QStringList arg;
+    const QStringList allArgs = QApplication::arguments();
+    for (int i = 0; i < allArgs.size(); i++) {
+        if (allArgs.at(i) == QLatin1String("--record") && i + 1 < allArgs.size())
+            recordFileName = allArgs.at(++i);
+        else if (allArgs.at(i) == QLatin1String("--replay") && i + 1 < allArgs.size())
+            replayFileName = allArgs.at(++i);
+        else if (allArgs.at(i) == QLatin1String("--replay-realtime"))
+            replayRealTime = true;
+        else if (allArgs.at(i) != QLatin1String("--startup-times"))
+            arg.append(allArgs.at(i));
+    }
 
     QCoreApplication::setOrganizationName("AriguanaboSoft");
     QCoreApplication::setOrganizationDomain("com.cu.ariguanabosoft");
@@ -57,34 +94,49 @@ int main (int argc, char *argv [])
 
     kpMainWindow *mainWindow = 0;
 
-    if (arg.size() >= 2) {
+    if (!replayFileName.isEmpty()) {
+        mainWindow = new kpMainWindow ();
+        mainWindow->show ();
+
+        kpInputReplayer *replayer = new kpInputReplayer (mainWindow,
+            replayFileName, replayRealTime);
+        if (!replayer->start ())
+            return 1;
+
+        return app.exec ();
+    }
+
+    if (arg.size() >= 2 && recordFileName.isEmpty()) {
+        // Decode all the files at once, opening their windows as they are
+        // ready.
+        app.openFiles(arg.mid(1));
+    }
+    else if (arg.size() >= 2) {
+        // (the recorder needs its window straight away)
         for (int i = 1; i < arg.size(); i++) {
             mainWindow = new kpMainWindow (arg.at(i));
             mainWindow->show ();
         }
-	}
-    else {
-
-        // I dont know why but when I call processEvent without mainWindow->show()
-        // OS X shows : "No document could be open ..."
+    }
+    else if (!recordFileName.isEmpty()) {
+        // (something to record into straight away)
         mainWindow = new kpMainWindow ();
-        mainWindow->showMinimized ();
-
-        // process FileOpenEvent if exist
-        app.processEvents();
-
-        // check if some mainWindow was open
-        bool someOtherOpen = false;
-        foreach (QWidget *widget, app.topLevelWidgets()) {
-            kpMainWindow *otherMainWindow = dynamic_cast<kpMainWindow *>(widget);
-            if (otherMainWindow && !otherMainWindow->document()->isEmpty()) // it means some other file open
-                someOtherOpen = true;
-        }
+        mainWindow->show ();
+    }
+    else {
+        // On OS X, files opened from the Finder arrive as FileOpen events
+        // once the event loop runs (see kpApplication::event()).  Only open
+        // a new document if none did, rather than showing a window that
+        // might be thrown away.
+        QTimer::singleShot (0, &app, SLOT (openWindowIfNone ()));
+    }
 
-        if (someOtherOpen) mainWindow->deleteLater();
-        else mainWindow->showNormal();
+    if (!recordFileName.isEmpty()) {
+        kpInputRecorder *recorder = new kpInputRecorder (mainWindow,
+            QFileInfo (recordFileName).absoluteFilePath ());
+        if (!recorder->isOpen ())
+            return 1;
     }
 
     return app.exec ();
 }
-
@@ -0,0 +1,316 @@
+/*
+   Copyright (c) 2015-2018 Maikel Diaz <ariguanabosoft@gmail.com>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#define DEBUG_KP_INPUT_RECORDER 0
+
+
+#include <kpInputRecorder.h>
+
+#include <qapplication.h>
+#include <qbuffer.h>
+#include <qcryptographichash.h>
+#include <qevent.h>
+#include <qimage.h>
+#include <qurl.h>
+
+#include <qdebug.h>
+
+#include <kpColor.h>
+#include <kpColorToolBar.h>
+#include <kpDocument.h>
+#include <kpMainWindow.h>
+#include <kpTool.h>
+#include <kpToolToolBar.h>
+#include <kpToolWidgetBase.h>
+#include <kpView.h>
+
+
+static QString ColorRecord (const QString &kind, const kpColor &color)
+{
+    return kind + QLatin1Char (' ') +
+        QString::number (color.toQRgb (), 16);
+}
+
+//---------------------------------------------------------------------
+
+static QString OptionRecord (const kpToolWidgetBase *toolWidget)
+{
+    return QLatin1String ("option ") +
+        QString::fromLatin1 (QUrl::toPercentEncoding (toolWidget->objectName ())) +
+        QLatin1Char (' ') + QString::number (toolWidget->selectedRow ()) +
+        QLatin1Char (' ') + QString::number (toolWidget->selectedCol ());
+}
+
+//---------------------------------------------------------------------
+
+
+kpInputRecorder::kpInputRecorder (kpMainWindow *mainWindow,
+                                  const QString &fileName)
+    : QObject (mainWindow),
+      m_mainWindow (mainWindow),
+      m_file (fileName)
+{
+    if (!m_file.open (QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+    {
+        qCritical () << "kpInputRecorder could not create" << fileName
+                     << m_file.errorString ();
+        return;
+    }
+
+    m_stream.setDevice (&m_file);
+    m_clock.start ();
+
+    writeStartingState ();
+
+    kpToolToolBar *toolToolBar = mainWindow->toolToolBar ();
+    connect (toolToolBar, SIGNAL (sigToolSelected (kpTool *)),
+             this, SLOT (slotToolSelected (kpTool *)));
+    connect (toolToolBar, SIGNAL (toolWidgetOptionSelected ()),
+             this, SLOT (slotOptionSelected ()));
+
+    kpColorToolBar *colorToolBar = mainWindow->colorToolBar ();
+    connect (colorToolBar, SIGNAL (foregroundColorChanged (const kpColor &)),
+             this, SLOT (slotForegroundColorChanged (const kpColor &)));
+    connect (colorToolBar, SIGNAL (backgroundColorChanged (const kpColor &)),
+             this, SLOT (slotBackgroundColorChanged (const kpColor &)));
+
+    // The views' events, wherever they are delivered.
+    qApp->installEventFilter (this);
+}
+
+//---------------------------------------------------------------------
+
+kpInputRecorder::~kpInputRecorder ()
+{
+    if (qApp)
+        qApp->removeEventFilter (this);
+
+    m_stream.flush ();
+}
+
+//---------------------------------------------------------------------
+
+// public
+bool kpInputRecorder::isOpen () const
+{
+    return m_file.isOpen ();
+}
+
+//---------------------------------------------------------------------
+
+// public static
+QByteArray kpInputRecorder::ImageHash (const QImage &image)
+{
+    QCryptographicHash hash (QCryptographicHash::Sha1);
+
+    const int size [2] = {image.width (), image.height ()};
+    hash.addData (reinterpret_cast <const char *> (size), sizeof (size));
+
+    // (not bytesPerLine(), which includes padding)
+    const int rowBytes = (image.width () * image.depth () + 7) / 8;
+    for (int y = 0; y < image.height (); y++)
+        hash.addData (reinterpret_cast <const char *> (image.constScanLine (y)), rowBytes);
+
+    return hash.result ().toHex ();
+}
+
+//---------------------------------------------------------------------
+
+// protected virtual [base QObject]
+bool kpInputRecorder::eventFilter (QObject *watched, QEvent *e)
+{
+    switch (e->type ())
+    {
+    case QEvent::MouseButtonPress:
+    case QEvent::MouseButtonRelease:
+    case QEvent::MouseMove:
+    {
+        kpView *view = qobject_cast <kpView *> (watched);
+        if (!view)
+            break;
+
+        const QMouseEvent *me = static_cast <const QMouseEvent *> (e);
+        const QPoint docPoint = view->transformViewToDoc (me->pos ());
+
+        QString record;
+        if (e->type () == QEvent::MouseMove)
+        {
+            record = QString::fromLatin1 ("move %1 %2 %3 %4")
+                .arg (docPoint.x ()).arg (docPoint.y ())
+                .arg (int (me->buttons ())).arg (int (me->modifiers ()));
+        }
+        else
+        {
+            record = QString::fromLatin1 ("%1 %2 %3 %4 %5 %6")
+                .arg (QLatin1String (e->type () == QEvent::MouseButtonPress ?
+                                         "press" : "release"))
+                .arg (docPoint.x ()).arg (docPoint.y ())
+                .arg (int (me->button ())).arg (int (me->buttons ()))
+                .arg (int (me->modifiers ()));
+        }
+        write (record);
+        break;
+    }
+
+    case QEvent::KeyPress:
+    case QEvent::KeyRelease:
+    {
+        if (!qobject_cast <kpView *> (watched))
+            break;
+
+        const QKeyEvent *ke = static_cast <const QKeyEvent *> (e);
+        const QByteArray text = ke->text ().toUtf8 ().toHex ();
+        write (QString::fromLatin1 ("%1 %2 %3 %4")
+            .arg (QLatin1String (e->type () == QEvent::KeyPress ?
+                                     "keypress" : "keyrelease"))
+            .arg (ke->key ()).arg (int (ke->modifiers ()))
+            .arg (text.isEmpty () ?
+                      QString::fromLatin1 ("-") : QString::fromLatin1 (text)));
+        break;
+    }
+
+    case QEvent::Close:
+        // Checkpoint what the user ended up with.
+        if (watched == m_mainWindow && m_mainWindow->document ())
+        {
+            // (include the mouse moves that the tool is still coalescing,
+            //  as kpInputReplayer does)
+            if (m_mainWindow->tool ())
+                m_mainWindow->tool ()->flushStrokeSamples ();
+
+            write (QLatin1String ("hash ") + QString::fromLatin1 (
+                ImageHash (m_mainWindow->document ()->imageWithSelection ())));
+            m_stream.flush ();
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    return QObject::eventFilter (watched, e);
+}
+
+//---------------------------------------------------------------------
+
+// private slot
+void kpInputRecorder::slotToolSelected (kpTool *tool)
+{
+    if (!tool)
+        return;
+
+    const qint64 msecs = m_clock.elapsed ();
+    write (msecs, QLatin1String ("tool ") + tool->objectName ());
+    writeToolOptions (msecs);
+}
+
+//---------------------------------------------------------------------
+
+// private slot
+void kpInputRecorder::slotOptionSelected ()
+{
+    // (whichever shown tool widget it was)
+    writeToolOptions (m_clock.elapsed ());
+}
+
+//---------------------------------------------------------------------
+
+// private slot
+void kpInputRecorder::slotForegroundColorChanged (const kpColor &color)
+{
+    write (::ColorRecord (QLatin1String ("foreground"), color));
+}
+
+//---------------------------------------------------------------------
+
+// private slot
+void kpInputRecorder::slotBackgroundColorChanged (const kpColor &color)
+{
+    write (::ColorRecord (QLatin1String ("background"), color));
+}
+
+//---------------------------------------------------------------------
+
+// private
+void kpInputRecorder::writeStartingState ()
+{
+    write (0, QLatin1String ("version 1"));
+
+    QByteArray png;
+    QBuffer buffer (&png);
+    buffer.open (QIODevice::WriteOnly);
+    if (m_mainWindow->document ())
+        m_mainWindow->document ()->imageWithSelection ().save (&buffer, "PNG");
+    write (0, QLatin1String ("image ") + QString::fromLatin1 (png.toBase64 ()));
+
+    const kpColorToolBar *colorToolBar = m_mainWindow->colorToolBar ();
+    write (0, ::ColorRecord (QLatin1String ("foreground"),
+                             colorToolBar->foregroundColor ()));
+    write (0, ::ColorRecord (QLatin1String ("background"),
+                             colorToolBar->backgroundColor ()));
+
+    const kpToolToolBar *toolToolBar = m_mainWindow->toolToolBar ();
+    if (toolToolBar->tool ())
+        write (0, QLatin1String ("tool ") + toolToolBar->tool ()->objectName ());
+
+    writeToolOptions (0);
+}
+
+//---------------------------------------------------------------------
+
+// private
+void kpInputRecorder::writeToolOptions (qint64 msecs)
+{
+    const kpToolToolBar *toolToolBar = m_mainWindow->toolToolBar ();
+    for (int i = 0; toolToolBar->shownToolWidget (i); i++)
+        write (msecs, ::OptionRecord (toolToolBar->shownToolWidget (i)));
+}
+
+//---------------------------------------------------------------------
+
+// private
+void kpInputRecorder::write (qint64 msecs, const QString &record)
+{
+    if (!m_file.isOpen ())
+        return;
+
+#if DEBUG_KP_INPUT_RECORDER
+    qDebug () << "kpInputRecorder:" << msecs << record.left (80);
+#endif
+
+    m_stream << msecs << ' ' << record << '\n';
+}
+
+//---------------------------------------------------------------------
+
+// private
+void kpInputRecorder::write (const QString &record)
+{
+    write (m_clock.elapsed (), record);
+}
+
+//---------------------------------------------------------------------
@@ -0,0 +1,119 @@
+/*
+   Copyright (c) 2015-2018 Maikel Diaz <ariguanabosoft@gmail.com>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef kpInputRecorder_H
+#define kpInputRecorder_H
+
+
+#include <qelapsedtimer.h>
+#include <qfile.h>
+#include <qobject.h>
+#include <qtextstream.h>
+
+
+class QByteArray;
+class QImage;
+
+class kpColor;
+class kpMainWindow;
+class kpTool;
+
+
+//
+// Records the input delivered to the views of a kpMainWindow, so that
+// kpInputReplayer can play it back for repeatable performance runs.
+//
+// Recordings are text files with one record per line:
+//
+//     <msecs since start> <kind> <arguments...>
+//
+// The first records (at time 0) describe the starting state, so that the
+// replay does not depend on the settings of the machine it runs on:
+//
+//     0 version 1
+//     0 image <base64 PNG of the document>
+//     0 foreground <ARGB hex>
+//     0 background <ARGB hex>
+//     0 tool <tool object name>
+//     0 option <percent-encoded tool widget object name> <row> <col>
+//
+// (with an option record for each tool widget shown for the tool, here
+// and whenever the tool changes, since tool widgets are created on demand
+// and start with the settings of the machine they run on)
+//
+// followed by the input:
+//
+//     <ms> press|release <doc x> <doc y> <button> <buttons> <modifiers>
+//     <ms> move <doc x> <doc y> <buttons> <modifiers>
+//     <ms> keypress|keyrelease <key> <modifiers> <hex UTF-8 text or ->
+//     <ms> tool|option|foreground|background ... (as above)
+//
+// and checkpoints, written whenever the main window is asked to close:
+//
+//     <ms> hash <ImageHash() of the document>
+//
+// Mouse positions are in document coordinates so that the replay does
+// not depend on the zoom level.
+//
+class kpInputRecorder : public QObject
+{
+Q_OBJECT
+
+public:
+    kpInputRecorder (kpMainWindow *mainWindow, const QString &fileName);
+    virtual ~kpInputRecorder ();
+
+    // Returns whether the recording file could be created.
+    bool isOpen () const;
+
+    // Returns the hash of the pixels of <image> used for checkpoints.
+    static QByteArray ImageHash (const QImage &image);
+
+protected:
+    // protected virtual [base QObject]
+    virtual bool eventFilter (QObject *watched, QEvent *e);
+
+private slots:
+    void slotToolSelected (kpTool *tool);
+    void slotOptionSelected ();
+    void slotForegroundColorChanged (const kpColor &color);
+    void slotBackgroundColorChanged (const kpColor &color);
+
+private:
+    void writeStartingState ();
+    void writeToolOptions (qint64 msecs);
+    void write (qint64 msecs, const QString &record);
+    void write (const QString &record);
+
+    kpMainWindow *m_mainWindow;
+    QFile m_file;
+    QTextStream m_stream;
+    QElapsedTimer m_clock;
+};
+
+
+#endif  // kpInputRecorder_H
@@ -0,0 +1,338 @@
+/*
+   Copyright (c) 2015-2018 Maikel Diaz <ariguanabosoft@gmail.com>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#define DEBUG_KP_INPUT_REPLAYER 0
+
+
+#include <kpInputReplayer.h>
+
+#include <qapplication.h>
+#include <qevent.h>
+#include <qfile.h>
+#include <qimage.h>
+#include <qtextstream.h>
+#include <qtimer.h>
+#include <qurl.h>
+
+#include <qdebug.h>
+
+#include <kpColor.h>
+#include <kpColorToolBar.h>
+#include <kpDocument.h>
+#include <kpInputRecorder.h>
+#include <kpLatencyStats.h>
+#include <kpMainWindow.h>
+#include <kpTool.h>
+#include <kpToolToolBar.h>
+#include <kpToolWidgetBase.h>
+#include <kpView.h>
+
+
+kpInputReplayer::kpInputReplayer (kpMainWindow *mainWindow,
+                                  const QString &fileName,
+                                  bool realTime)
+    : QObject (mainWindow),
+      m_mainWindow (mainWindow),
+      m_fileName (fileName),
+      m_realTime (realTime),
+      m_nextRecord (0),
+      m_checkpointsMatched (0),
+      m_checkpointsMismatched (0)
+{
+}
+
+//---------------------------------------------------------------------
+
+kpInputReplayer::~kpInputReplayer ()
+{
+    kpLatencyStats::SetEnabled (false);
+}
+
+//---------------------------------------------------------------------
+
+// public
+bool kpInputReplayer::start ()
+{
+    QFile file (m_fileName);
+    if (!file.open (QIODevice::ReadOnly | QIODevice::Text))
+    {
+        qCritical () << "kpInputReplayer could not open" << m_fileName
+                     << file.errorString ();
+        return false;
+    }
+
+    QTextStream stream (&file);
+    while (!stream.atEnd ())
+    {
+        const QString line = stream.readLine ().trimmed ();
+        if (line.isEmpty ())
+            continue;
+
+        m_records.append (line.split (QLatin1Char (' ')));
+    }
+
+    if (m_records.isEmpty () ||
+        m_records.first ().value (1) != QLatin1String ("version") ||
+        m_records.first ().value (2) != QLatin1String ("1"))
+    {
+        qCritical () << "kpInputReplayer:" << m_fileName
+                     << "is not a version 1 recording";
+        return false;
+    }
+
+    kpLatencyStats::Clear ();
+    kpLatencyStats::SetEnabled (true);
+
+    m_nextRecord = 0;
+    m_clock.start ();
+    scheduleNext ();
+
+    return true;
+}
+
+//---------------------------------------------------------------------
+
+// private slot
+void kpInputReplayer::slotPlayNext ()
+{
+    // Play everything that is due.  At full speed, play one record at a
+    // time, so that the event loop gets to paint in between, as it would
+    // for a user.
+    do
+    {
+        if (m_nextRecord >= m_records.size ())
+        {
+            finish ();
+            return;
+        }
+
+        const QStringList &record = m_records [m_nextRecord++];
+        if (!play (record))
+        {
+            qCritical () << "kpInputReplayer: malformed record"
+                         << record.join (QLatin1String (" "));
+        }
+    }
+    while (m_realTime && m_nextRecord < m_records.size () &&
+           m_records [m_nextRecord].value (0).toLongLong () <= m_clock.elapsed ());
+
+    scheduleNext ();
+}
+
+//---------------------------------------------------------------------
+
+// private
+kpView *kpInputReplayer::mainView () const
+{
+    return m_mainWindow->findChild <kpView *> (QLatin1String ("mainView"));
+}
+
+//---------------------------------------------------------------------
+
+// private
+void kpInputReplayer::scheduleNext ()
+{
+    int delay = 0;
+    if (m_realTime && m_nextRecord < m_records.size ())
+    {
+        const qint64 due = m_records [m_nextRecord].value (0).toLongLong ();
+        delay = int (qMax (qint64 (0), due - m_clock.elapsed ()));
+    }
+
+    QTimer::singleShot (delay, this, SLOT (slotPlayNext ()));
+}
+
+//---------------------------------------------------------------------
+
+// private
+bool kpInputReplayer::play (const QStringList &record)
+{
+#if DEBUG_KP_INPUT_REPLAYER
+    qDebug () << "kpInputReplayer::play" << record.join (QLatin1String (" ")).left (80);
+#endif
+
+    if (record.size () < 2)
+        return false;
+
+    const QString kind = record [1];
+    bool ok = true;
+
+    if (kind == QLatin1String ("version"))
+    {
+    }
+    else if (kind == QLatin1String ("image"))
+    {
+        QImage image;
+        if (!image.loadFromData (QByteArray::fromBase64 (record.value (2).toLatin1 ()), "PNG") ||
+            !m_mainWindow->document ())
+        {
+            return false;
+        }
+
+        m_mainWindow->document ()->setImage (
+            image.convertToFormat (QImage::Format_ARGB32_Premultiplied));
+    }
+    else if (kind == QLatin1String ("foreground") ||
+             kind == QLatin1String ("background"))
+    {
+        const kpColor color (QRgb (record.value (2).toUInt (&ok, 16)));
+        if (!ok)
+            return false;
+
+        if (kind == QLatin1String ("foreground"))
+            m_mainWindow->colorToolBar ()->setForegroundColor (color);
+        else
+            m_mainWindow->colorToolBar ()->setBackgroundColor (color);
+    }
+    else if (kind == QLatin1String ("tool"))
+    {
+        const kpTool *tool = m_mainWindow->findChild <kpTool *> (record.value (2));
+        if (!tool)
+            return false;
+
+        m_mainWindow->toolToolBar ()->selectTool (tool);
+    }
+    else if (kind == QLatin1String ("option"))
+    {
+        const QString name = QUrl::fromPercentEncoding (record.value (2).toLatin1 ());
+        kpToolWidgetBase *toolWidget =
+            m_mainWindow->toolToolBar ()->findChild <kpToolWidgetBase *> (name);
+        const int row = record.value (3).toInt (&ok);
+        const int col = ok ? record.value (4).toInt (&ok) : 0;
+        if (!toolWidget || !ok)
+            return false;
+
+        toolWidget->setSelected (row, col, false/*don't save as default*/);
+    }
+    else if (kind == QLatin1String ("press") ||
+             kind == QLatin1String ("release") ||
+             kind == QLatin1String ("move"))
+    {
+        kpView *view = mainView ();
+        if (!view || record.size () < (kind == QLatin1String ("move") ? 6 : 7))
+            return false;
+
+        const QPoint viewPoint = view->transformDocToView (
+            QPoint (record [2].toInt (), record [3].toInt ()));
+
+        int field = 4;
+        const Qt::MouseButton button = kind == QLatin1String ("move") ?
+            Qt::NoButton : Qt::MouseButton (record [field++].toInt ());
+        const Qt::MouseButtons buttons = Qt::MouseButtons (record [field++].toInt ());
+        const Qt::KeyboardModifiers modifiers =
+            Qt::KeyboardModifiers (record [field++].toInt ());
+
+        const QEvent::Type type =
+            kind == QLatin1String ("press") ? QEvent::MouseButtonPress :
+            kind == QLatin1String ("release") ? QEvent::MouseButtonRelease :
+                                                 QEvent::MouseMove;
+        QMouseEvent e (type, viewPoint, view->mapToGlobal (viewPoint),
+                       button, buttons, modifiers);
+        QApplication::sendEvent (view, &e);
+    }
+    else if (kind == QLatin1String ("keypress") ||
+             kind == QLatin1String ("keyrelease"))
+    {
+        kpView *view = mainView ();
+        if (!view || record.size () < 5)
+            return false;
+
+        const QString text = record [4] == QLatin1String ("-") ?
+            QString () :
+            QString::fromUtf8 (QByteArray::fromHex (record [4].toLatin1 ()));
+
+        QKeyEvent e (kind == QLatin1String ("keypress") ?
+                         QEvent::KeyPress : QEvent::KeyRelease,
+                     record [2].toInt (),
+                     Qt::KeyboardModifiers (record [3].toInt ()),
+                     text);
+        QApplication::sendEvent (view, &e);
+    }
+    else if (kind == QLatin1String ("hash"))
+    {
+        if (!m_mainWindow->document ())
+            return false;
+
+        // Draw the mouse moves that the tool is still coalescing, rather
+        // than hoping that their timer has fired, and let the drawing land.
+        if (m_mainWindow->tool ())
+            m_mainWindow->tool ()->flushStrokeSamples ();
+        QApplication::processEvents ();
+
+        const QByteArray hash = kpInputRecorder::ImageHash (
+            m_mainWindow->document ()->imageWithSelection ());
+        if (hash == record.value (2).toLatin1 ())
+            m_checkpointsMatched++;
+        else
+        {
+            qCritical () << "kpInputReplayer: checkpoint at" << record [0]
+                         << "ms mismatched:" << hash;
+            m_checkpointsMismatched++;
+        }
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+//---------------------------------------------------------------------
+
+// private
+void kpInputReplayer::finish ()
+{
+    kpLatencyStats::SetEnabled (false);
+
+    QTextStream out (stdout);
+    out << "Replayed " << m_records.size () << " records from " << m_fileName
+        << " in " << m_clock.elapsed () << " ms\n";
+
+    out << qSetFieldWidth (12) << left << "phase" << right
+        << "count" << "p50 (us)" << "p90 (us)" << "p99 (us)" << "max (us)"
+        << qSetFieldWidth (0) << "\n";
+    for (int i = 0; i < kpLatencyStats::NumPhases; i++)
+    {
+        const kpLatencyStats::Phase phase = kpLatencyStats::Phase (i);
+        out << qSetFieldWidth (12) << left << kpLatencyStats::PhaseName (phase)
+            << right << kpLatencyStats::SampleCount (phase)
+            << kpLatencyStats::Percentile (phase, 50) / 1000
+            << kpLatencyStats::Percentile (phase, 90) / 1000
+            << kpLatencyStats::Percentile (phase, 99) / 1000
+            << kpLatencyStats::Percentile (phase, 100) / 1000
+            << qSetFieldWidth (0) << "\n";
+    }
+
+    out << "Checkpoints: " << m_checkpointsMatched << " matched, "
+        << m_checkpointsMismatched << " mismatched\n";
+    out.flush ();
+
+    QCoreApplication::exit (m_checkpointsMismatched ? 1 : 0);
+}
+
+//---------------------------------------------------------------------
@@ -0,0 +1,92 @@
+/*
+   Copyright (c) 2015-2018 Maikel Diaz <ariguanabosoft@gmail.com>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef kpInputReplayer_H
+#define kpInputReplayer_H
+
+
+#include <qelapsedtimer.h>
+#include <qobject.h>
+#include <qstringlist.h>
+
+
+class kpMainWindow;
+class kpView;
+
+
+//
+// Plays a recording made by kpInputRecorder back into a kpMainWindow and
+// reports the latency of drawing, view updates and painting
+// (see kpLatencyStats), as well as whether the document matched each
+// hash checkpoint.
+//
+// When <realTime> is false, the records are played as fast as the event
+// loop allows (still returning to the event loop between records, so that
+// the resulting paints are measured); otherwise, they are played at the
+// times they were recorded at.
+//
+// Once done, the report is printed to standard output and the
+// application exits with status 0 if every checkpoint matched, or 1
+// otherwise.
+//
+class kpInputReplayer : public QObject
+{
+Q_OBJECT
+
+public:
+    kpInputReplayer (kpMainWindow *mainWindow, const QString &fileName,
+                     bool realTime);
+    virtual ~kpInputReplayer ();
+
+    // Loads the recording and starts playing it back.
+    // Returns false (having printed why) if the recording cannot be read.
+    bool start ();
+
+private slots:
+    void slotPlayNext ();
+
+private:
+    kpView *mainView () const;
+
+    void scheduleNext ();
+    // Returns false if <record> is malformed.
+    bool play (const QStringList &record);
+    void finish ();
+
+    kpMainWindow *m_mainWindow;
+    QString m_fileName;
+    bool m_realTime;
+
+    QList <QStringList> m_records;
+    int m_nextRecord;
+    QElapsedTimer m_clock;
+
+    int m_checkpointsMatched, m_checkpointsMismatched;
+};
+
+
+#endif  // kpInputReplayer_H
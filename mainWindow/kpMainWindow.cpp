@@ -53,6 +53,7 @@
 #include <kpDocument.h>
 #include <kpDocumentEnvironment.h>
 #include <kpSelectionDrag.h>
+#include <kpStartupTimes.h>
 #include <kpTool.h>
 #include <kpToolToolBar.h>
 #include <kpViewManager.h>
@@ -72,6 +73,7 @@ kpMainWindow::kpMainWindow ()
 {
     init ();
     open (QString (), true/*create an empty doc*/);
+    kpStartupTimes::Mark (QLatin1String ("window: new document"));
 
     d->isFullyConstructed = true;
 }
@@ -83,6 +85,7 @@ kpMainWindow::kpMainWindow (const QString &url)
 {
     init ();
     open (url, true/*create an empty doc with the same url if url !exist*/);
+    kpStartupTimes::Mark (QLatin1String ("window: opened ") + url);
 
     d->isFullyConstructed = true;
 }
@@ -94,6 +97,7 @@ kpMainWindow::kpMainWindow (kpDocument *newDoc)
 {
     init ();
     setDocument (newDoc);
+    kpStartupTimes::Mark (QLatin1String ("window: document"));
 
     d->isFullyConstructed = true;
 }
@@ -181,6 +185,8 @@ void kpMainWindow::init ()
 
     d->scrollView = 0;
     d->mainView = 0;
+    d->thumbnail = 0;
+    d->thumbnailView = 0;
     d->document = 0;
     d->viewManager = 0;
     d->colorToolBar = 0;
@@ -212,6 +218,7 @@ void kpMainWindow::init ()
     //
 
     readGeneralSettings ();
+    kpStartupTimes::Mark (QLatin1String ("window: settings"));
 
     //
     // create action collection
@@ -223,10 +230,14 @@ void kpMainWindow::init ()
     // create GUI
     //
     setupActions ();
+    kpStartupTimes::Mark (QLatin1String ("window: actions and tools"));
     createStatusBar ();
     createToolBox ();
+    kpStartupTimes::Mark (QLatin1String ("window: tool box"));
     createColorBox ();
+    kpStartupTimes::Mark (QLatin1String ("window: color box"));
     createGUI ();
+    kpStartupTimes::Mark (QLatin1String ("window: menus and toolbars"));
 
     // Let the Tool Box take all the vertical space, since it can be quite
     // tall with all its tool option widgets.  This also avoids occasional
@@ -277,6 +288,8 @@ void kpMainWindow::init ()
 
     setAttribute(Qt::WA_DeleteOnClose);
 
+    kpStartupTimes::Mark (QLatin1String ("window: scroll view"));
+
 #if DEBUG_KP_MAIN_WINDOW
     kDebug () << "\tall done in " << totalTime.elapsed () << "msec";
 #endif
@@ -366,6 +379,12 @@ void kpMainWindow::createGUI () {
 
 	menu->addSeparator();
 
+	menu->addAction(d->ac->action("view_show_thumbnail"));
+	menu->addAction(d->ac->action("view_zoomed_thumbnail"));
+	menu->addAction(d->ac->action("view_show_thumbnail_rectangle"));
+
+	menu->addSeparator();
+
 	menu->addAction(d->ac->action("settings_fullscreen"));
 
     menu->addSeparator();
@@ -464,24 +483,7 @@ void kpMainWindow::createGUI () {
 	bar->addAction(d->ac->action("view_zoom_to"));
 	bar->addAction(d->ac->action("view_zoom_in"));
 
-	//
-	// Font
-	//
-
-	bar = d->toolBarText = addToolBar(tr("Text Toolbar"));
-
-	bar->setOrientation(Qt::Horizontal);
-	bar->setAllowedAreas(Qt::TopToolBarArea);
-
-	bar->addAction(d->ac->action("text_font_family"));
-	bar->addAction(d->ac->action("text_font_size"));
-
-	bar->addSeparator();
-
-	bar->addAction(d->ac->action("text_bold"));
-	bar->addAction(d->ac->action("text_italic"));
-	bar->addAction(d->ac->action("text_underline"));
-	bar->addAction(d->ac->action("text_strike_thru"));
+	// (the Text Toolbar is created on demand - see createTextToolBar())
 }
 
 
@@ -605,7 +607,7 @@ void kpMainWindow::setupActions ()
     setupColorsMenuActions ();
     setupSettingsMenuActions ();
 
-    setupTextToolBarActions ();
+    // (the Text Toolbar's actions are created with it)
     setupToolActions ();
 }
 
@@ -668,6 +670,9 @@ void kpMainWindow::setDocument (kpDocument *newDoc)
     kDebug () << "\tdestroying views";
 #endif
 
+    // (before its buddy view)
+    destroyThumbnailView ();
+
     delete d->mainView; d->mainView = 0;
 
 #if DEBUG_KP_MAIN_WINDOW
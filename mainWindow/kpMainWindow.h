@@ -73,6 +73,7 @@ class kpCommandHistory;
 class kpDocument;
 class kpDocumentEnvironment;
 class kpDocumentMetaInfo;
+class kpDocumentSaveSettings;
 
 class kpViewManager;
 class kpViewScrollableContainer;
@@ -365,6 +366,13 @@ private:
                         bool *allowOverwritePrompt,
                         bool *allowLossyPrompt);
 
+    // Asks for the depth, quality and compression to save <imageToBeSaved>
+    // in the <saveOptions> format with, starting from <saveSettings>.
+    // Returns false if the user cancelled.
+    bool askForSaveSettings (const kpImage &imageToBeSaved,
+                             const QString &saveOptions,
+                             kpDocumentSaveSettings *saveSettings);
+
 private slots:
     bool saveAs (bool localOnly = false);
     bool slotSaveAs ();
@@ -493,6 +501,35 @@ private:
 private slots:
     void slotZoom ();
 
+//
+// View Menu - Thumbnail
+//
+
+private:
+    void setupViewMenuThumbnailActions ();
+    void enableViewMenuThumbnailDocumentActions (bool enable);
+    void enableThumbnailOptionActions (bool enable);
+
+    // Shows or destroys the thumbnail window, according to the
+    // configuration and whether there is a document.
+    void updateThumbnail ();
+
+    void createThumbnailView ();
+    void destroyThumbnailView ();
+
+private slots:
+    void slotShowThumbnailToggled ();
+    void slotThumbnailClosedByUser ();
+    void slotZoomedThumbnailToggled ();
+    void slotThumbnailShowRectangleToggled ();
+
+public:
+    // (called by kpThumbnail)
+    void notifyThumbnailGeometryChanged ();
+
+private slots:
+    void slotSaveThumbnailGeometry ();
+
 //
 // Image Menu
 //
@@ -595,7 +632,8 @@ private:
         StatusBarItemDocSize,
         StatusBarItemDocDepth,
         StatusBarItemZoom,
-        StatusBarItemColor
+        StatusBarItemColor,
+        StatusBarItemUndoMemory
     };
 
     void createStatusBar ();
@@ -613,6 +651,7 @@ private slots:
 
     void recalculateStatusBarMessage ();
     void recalculateStatusBarShape ();
+    void recalculateStatusBarUndoMemory ();
 
     void recalculateStatusBar ();
 
@@ -628,6 +667,7 @@ private:
 
 private:
     void setupTextToolBarActions ();
+    void createTextToolBar ();
     void readAndApplyTextSettings ();
 
 public:
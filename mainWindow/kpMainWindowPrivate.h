@@ -35,6 +35,9 @@
 #define DEBUG_KP_MAIN_WINDOW 0
 
 
+#include <kpDocumentSaveSettings.h>
+
+
 class QAction;
 class QActionGroup;
 class QLabel;
@@ -71,6 +74,7 @@ struct kpMainWindowPrivate
     bool configThumbnailShown;
     QRect configThumbnailGeometry;
     bool configZoomedThumbnail;
+    bool configThumbnailShowRectangle;
 
     kpDocumentEnvironment *documentEnvironment;
     kpCommandEnvironment *commandEnvironment;
@@ -128,6 +132,7 @@ struct kpMainWindowPrivate
 
     QString lastExportURL;
     QString lastExportSaveOptions;
+    kpDocumentSaveSettings lastExportSaveSettings;
     bool exportFirstTime;
 
 
@@ -163,6 +168,12 @@ struct kpMainWindowPrivate
 
     QList <int> zoomList;
 
+    kpThumbnail *thumbnail;
+    kpThumbnailView *thumbnailView;
+
+    QAction *actionShowThumbnail,
+            *actionZoomedThumbnail, *actionShowThumbnailRectangle;
+
     QTimer *thumbnailSaveConfigTimer;
 
     //
@@ -37,7 +37,6 @@
 #include <qlist.h>
 #include <qmenu.h>
 #include <QDesktopWidget>
-#include <QScrollBar>
 
 #include <qaction.h>
 #include <qdebug.h>
@@ -84,6 +83,8 @@ void kpMainWindow::setupEditMenuActions ()
     // Undo/Redo
     // CONFIG: Need GUI for config history size.
     d->commandHistory = new kpCommandHistory (true/*read config*/, this);
+    connect (d->commandHistory, SIGNAL (memoryUsageChanged ()),
+             this, SLOT (recalculateStatusBarUndoMemory ()));
 
     if (d->configFirstTime)
     {
@@ -335,8 +336,8 @@ QRect kpMainWindow::calcUsefulPasteRect (int imageWidth, int imageHeight)
 
     if (d->mainView && d->scrollView)
     {
-        const QPoint viewTopLeft (d->scrollView->horizontalScrollBar()->value (),
-                                  d->scrollView->verticalScrollBar()->value ());
+        // (the main view only covers the visible part of the document)
+        const QPoint viewTopLeft (0, 0);
 
         const QPoint docTopLeft = d->mainView->transformViewToDoc (viewTopLeft);
 
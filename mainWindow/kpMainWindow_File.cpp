@@ -74,11 +74,14 @@
 #include <qevent.h>
 
 #include <kpCommandHistory.h>
+#include <kpCompositedImageSource.h>
 #include <kpDefs.h>
 #include <kpDocument.h>
 #include <kpDocumentMetaInfo.h>
 #include <kpDocumentMetaInfoCommand.h>
 #include <kpDocumentMetaInfoDialog.h>
+#include <kpDocumentSaveSettings.h>
+#include <kpDocumentSaveSettingsDialog.h>
 
 #include <kpPixmapFX.h>
 #include <kpPrintDialogPage.h>
@@ -400,9 +403,12 @@ kpDocument *kpMainWindow::openInternal (const QString &url,
         return 0;
 
     // Create/open doc.
-    kpDocument *newDoc = new kpDocument (fallbackDocSize.width (),
-                                         fallbackDocSize.height (),
-                                         documentEnvironment ());
+    //
+    // (a file's image replaces the document's, so don't allocate and clear
+    //  a <fallbackDocSize> one unless there is no file)
+    kpDocument *newDoc = kpDocument::NewForOpen (fallbackDocSize.width (),
+                                                 fallbackDocSize.height (),
+                                                 documentEnvironment ());
     if (!newDoc->open (url, newDocSameNameIfNotExist))
     {
     #if DEBUG_KP_MAIN_WINDOW
@@ -793,31 +799,58 @@ QString kpMainWindow::askForSaveURL (const QString &caption,
 
 //---------------------------------------------------------------------
 
+// private
+bool kpMainWindow::askForSaveSettings (const kpImage &imageToBeSaved,
+                                       const QString &saveOptions,
+                                       kpDocumentSaveSettings *saveSettings)
+{
+    kpDocumentSaveSettingsDialog dialog (imageToBeSaved, saveOptions,
+                                         *saveSettings, this);
+    if (dialog.exec () != QDialog::Accepted)
+        return false;
+
+    *saveSettings = dialog.saveSettings ();
+    return true;
+}
+
+//---------------------------------------------------------------------
+
 // private slot
 bool kpMainWindow::saveAs (bool localOnly)
 {
-	QString chosenSaveOptions;
+	QString chosenURL, chosenSaveOptions;
     bool allowOverwritePrompt, allowLossyPrompt;
-    QString chosenURL = askForSaveURL (i18n ("Save Image As"),
-                                    d->document->url(),
-                                    d->document->imageWithSelection (),
-                                    *d->document->saveOptions (),
-                                    *d->document->metaInfo (),
-                                    kpSettingsGroupFileSaveAs,
-                                    localOnly,
-                                    &chosenSaveOptions,
-                                    !d->document->savedAtLeastOnceBefore (),
-                                    &allowOverwritePrompt,
-                                    &allowLossyPrompt);
-
-
-    if (chosenURL.isEmpty ())
-        return false;
+    kpDocumentSaveSettings saveSettings = d->document->saveSettings ();
+    {
+        // Only for the dialogs' previews.  Let go of it before saving,
+        // which does not need the document composited in one piece.
+        const kpImage imageToBeSaved = d->document->imageWithSelection ();
+
+        chosenURL = askForSaveURL (i18n ("Save Image As"),
+                                   d->document->url(),
+                                   imageToBeSaved,
+                                   *d->document->saveOptions (),
+                                   *d->document->metaInfo (),
+                                   kpSettingsGroupFileSaveAs,
+                                   localOnly,
+                                   &chosenSaveOptions,
+                                   !d->document->savedAtLeastOnceBefore (),
+                                   &allowOverwritePrompt,
+                                   &allowLossyPrompt);
+
+
+        if (chosenURL.isEmpty ())
+            return false;
+
+        if (!askForSaveSettings (imageToBeSaved, chosenSaveOptions, &saveSettings))
+            return false;
+    }
 
 
     if (!d->document->saveAs (chosenURL, chosenSaveOptions,
                              allowOverwritePrompt,
-                             allowLossyPrompt))
+                             allowLossyPrompt,
+                             saveSettings))
     {
         return false;
     }
@@ -845,30 +878,40 @@ bool kpMainWindow::slotExport ()
 {
     toolEndShape ();
 
-    QString chosenSaveOptions;
+    QString chosenURL, chosenSaveOptions;
     bool allowOverwritePrompt, allowLossyPrompt;
-    QString chosenURL = askForSaveURL (i18n ("Export"),
-                                    d->lastExportURL,
-                                    d->document->imageWithSelection (),
-                                    d->lastExportSaveOptions,
-                                    *d->document->metaInfo (),
-                                    kpSettingsGroupFileExport,
-                                    false/*allow remote files*/,
-                                    &chosenSaveOptions,
-                                    d->exportFirstTime,
-                                    &allowOverwritePrompt,
-                                    &allowLossyPrompt);
-
-
-    if (chosenURL.isEmpty ())
-        return false;
+    kpDocumentSaveSettings saveSettings = d->lastExportSaveSettings;
+    {
+        // (see saveAs())
+        const kpImage imageToBeSaved = d->document->imageWithSelection ();
+
+        chosenURL = askForSaveURL (i18n ("Export"),
+                                   d->lastExportURL,
+                                   imageToBeSaved,
+                                   d->lastExportSaveOptions,
+                                   *d->document->metaInfo (),
+                                   kpSettingsGroupFileExport,
+                                   false/*allow remote files*/,
+                                   &chosenSaveOptions,
+                                   d->exportFirstTime,
+                                   &allowOverwritePrompt,
+                                   &allowLossyPrompt);
+
+
+        if (chosenURL.isEmpty ())
+            return false;
+
+        if (!askForSaveSettings (imageToBeSaved, chosenSaveOptions, &saveSettings))
+            return false;
+    }
 
-    if (!kpDocument::savePixmapToFile (d->document->imageWithSelection (),
+    if (!kpDocument::savePixmapToFile (kpCompositedImageSource (d->document),
                                        chosenURL,
                                        chosenSaveOptions, *d->document->metaInfo (),
                                        allowOverwritePrompt,
                                        allowLossyPrompt,
-                                       this))
+                                       this,
+                                       saveSettings))
     {
         return false;
     }
@@ -878,6 +921,7 @@ bool kpMainWindow::slotExport ()
 
     d->lastExportURL = chosenURL;
     d->lastExportSaveOptions = chosenSaveOptions;
+    d->lastExportSaveSettings = saveSettings;
 
     d->exportFirstTime = false;
 
@@ -1001,8 +1045,12 @@ void kpMainWindow::sendDocumentNameToPrinter (QPrinter *printer)
 void kpMainWindow::sendImageToPrinter (QPrinter *printer,
         bool showPrinterSetupDialog)
 {
-    // Get image to be printed.
-    kpImage image = d->document->imageWithSelection ();
+    // Get image to be printed.  It is drawn a band at a time below, so
+    // that printing does not need a composited copy of the document.
+    const kpCompositedImageSource source (d->document);
+
+    // The size to print it at, in printer dots.
+    int printWidth = source.width (), printHeight = source.height ();
 
 
     // Get image DPI.
@@ -1012,8 +1060,8 @@ void kpMainWindow::sendImageToPrinter (QPrinter *printer,
         double (d->document->metaInfo ()->dotsPerMeterY ());
 #if DEBUG_KP_MAIN_WINDOW
     kDebug () << "kpMainWindow::sendImageToPrinter() image:"
-               << " width=" << image.width ()
-               << " height=" << image.height ()
+               << " width=" << source.width ()
+               << " height=" << source.height ()
                << " dotsPerMeterX=" << imageDotsPerMeterX
                << " dotsPerMeterY=" << imageDotsPerMeterY
                << endl;
@@ -1085,10 +1133,10 @@ void kpMainWindow::sendImageToPrinter (QPrinter *printer,
     //
 
     const double scaleDpiX =
-        (image.width () / (printerWidthMM / KP_MILLIMETERS_PER_INCH))
+        (source.width () / (printerWidthMM / KP_MILLIMETERS_PER_INCH))
             / dpiX;
     const double scaleDpiY =
-        (image.height () / (printerHeightMM / KP_MILLIMETERS_PER_INCH))
+        (source.height () / (printerHeightMM / KP_MILLIMETERS_PER_INCH))
             / dpiY;
     const double scaleDpi = qMax (scaleDpiX, scaleDpiY);
 #if DEBUG_KP_MAIN_WINDOW
@@ -1120,10 +1168,7 @@ void kpMainWindow::sendImageToPrinter (QPrinter *printer,
         kDebug () << "\tdpiX > dpiY; stretching image height to equalise DPIs to dpiX="
                    << dpiX << endl;
     #endif
-        kpPixmapFX::scale (&image,
-             image.width (),
-             qMax (1, qRound (image.height () * dpiX / dpiY)),
-             false/*don't antialias*/);
+        printHeight = qMax (1, qRound (source.height () * dpiX / dpiY));
 
         dpiY = dpiX;
     }
@@ -1133,10 +1178,7 @@ void kpMainWindow::sendImageToPrinter (QPrinter *printer,
         kDebug () << "\tdpiY > dpiX; stretching image width to equalise DPIs to dpiY="
                    << dpiY << endl;
     #endif
-        kpPixmapFX::scale (&image,
-             qMax (1, qRound (image.width () * dpiY / dpiX)),
-             image.height (),
-             false/*don't antialias*/);
+        printWidth = qMax (1, qRound (source.width () * dpiY / dpiX));
 
         dpiX = dpiY;
     }
@@ -1188,10 +1230,10 @@ void kpMainWindow::sendImageToPrinter (QPrinter *printer,
     if (d->configPrintImageCenteredOnPage)
     {
         originX =
-            (printerWidthMM * dpiX / KP_MILLIMETERS_PER_INCH - image.width ())
+            (printerWidthMM * dpiX / KP_MILLIMETERS_PER_INCH - printWidth)
                 / 2;
         originY =
-            (printerHeightMM * dpiY / KP_MILLIMETERS_PER_INCH - image.height ())
+            (printerHeightMM * dpiY / KP_MILLIMETERS_PER_INCH - printHeight)
                 / 2;
     }
 
@@ -1200,10 +1242,29 @@ void kpMainWindow::sendImageToPrinter (QPrinter *printer,
 #endif
 
 
-    // Send image to printer.
+    // Send image to printer, stretched (without antialiasing) to the
+    // print size.
     QPainter painter;
     painter.begin (printer);
-    painter.drawImage (qRound (originX), qRound (originY), image);
+    painter.translate (qRound (originX), qRound (originY));
+
+    // Each band goes to whole printer dots, with its top where the band
+    // above ended, so that bands neither overlap nor leave gaps.
+    const int bandHeight = source.bandHeight ();
+    for (int top = 0; top < source.height (); top += bandHeight)
+    {
+        const QImage band = source.band (top, bandHeight);
+
+        const int printTop = qRound (double (top) * printHeight /
+                                     source.height ());
+        const int printBottom = qRound (double (top + band.height ()) *
+                                        printHeight / source.height ());
+
+        painter.drawImage (QRect (0, printTop,
+                                  printWidth, printBottom - printTop),
+                           band);
+    }
+
     painter.end ();
 }
 
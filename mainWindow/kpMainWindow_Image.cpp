@@ -391,6 +391,7 @@ void kpMainWindow::slotResizeScale ()
             dialog.imageWidth (), dialog.imageHeight (),
             dialog.type (),
             commandEnvironment ());
+        cmd->setSmoothScaleFilter (dialog.smoothScaleFilter ());
 
         bool addSelCreateCommand = (dialog.actOnSelection () ||
                                     cmd->scaleSelectionWithImage ());
@@ -42,6 +42,7 @@
 #include <qfontmetrics.h>
 #include <tools.h>
 
+#include <kpCommandHistory.h>
 #include <kpDefs.h>
 #include <kpDocument.h>
 #include <kpTool.h>
@@ -85,6 +86,9 @@ void kpMainWindow::createStatusBar ()
     numSample = QString(" 1600% ");
     d->statusLabels->addLabel (StatusBarItemZoom,fm.width(numSample));
 
+    numSample = i18n (" Undo: %1 ", QString ("888.8 MB"));
+    d->statusLabels->addLabel (StatusBarItemUndoMemory, fm.width(numSample));
+
     sb->addPermanentWidget(d->statusLabels);
 
     d->statusBarShapeLastPointsInitialised = false;
@@ -297,6 +301,43 @@ void kpMainWindow::setStatusBarPixelColor (const QColor &color) {
 
 //---------------------------------------------------------------------
 
+static QString ByteSizeString (kpCommandSize::SizeType size)
+{
+    if (size < 1024)
+        return i18n ("%1 B", QString::number (size));
+    else if (size < 1048576)
+        return i18n ("%1 KB", QString::number (size / 1024.0, 'f', 1));
+    else if (size < 1073741824)
+        return i18n ("%1 MB", QString::number (size / 1048576.0, 'f', 1));
+    else
+        return i18n ("%1 GB", QString::number (size / 1073741824.0, 'f', 1));
+}
+
+// private slot
+void kpMainWindow::recalculateStatusBarUndoMemory ()
+{
+    if (!d->statusBarCreated)
+        return;
+
+    if (!d->commandHistory)
+    {
+        d->statusLabels->setText (StatusBarItemUndoMemory, QString ());
+        d->statusLabels->setToolTip (StatusBarItemUndoMemory, QString ());
+        return;
+    }
+
+    const kpCommandSize::SizeType memorySize = d->commandHistory->memorySize ();
+    const kpCommandSize::SizeType diskSize = d->commandHistory->diskSize ();
+
+    d->statusLabels->setText (StatusBarItemUndoMemory,
+        i18n ("Undo: %1", ::ByteSizeString (memorySize)));
+    d->statusLabels->setToolTip (StatusBarItemUndoMemory,
+        i18n ("Undo history: %1 in memory, %2 on disk",
+              ::ByteSizeString (memorySize), ::ByteSizeString (diskSize)));
+}
+
+//---------------------------------------------------------------------
+
 void kpMainWindow::recalculateStatusBarMessage ()
 {
 #if DEBUG_STATUS_BAR && 1
@@ -454,6 +495,8 @@ void kpMainWindow::recalculateStatusBar ()
     {
         setStatusBarZoom ();
     }
+
+    recalculateStatusBarUndoMemory ();
 }
 
 //---------------------------------------------------------------------
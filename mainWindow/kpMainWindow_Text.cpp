@@ -98,7 +98,32 @@ void kpMainWindow::setupTextToolBarActions ()
 
 
     readAndApplyTextSettings ();
+}
+
+// private
+void kpMainWindow::createTextToolBar ()
+{
+    Q_ASSERT (!d->toolBarText);
+
+    // Creating the Font Family action reads the whole font database, so
+    // this waits until text is first worked with, rather than slowing down
+    // startup.
+    setupTextToolBarActions ();
+
+    QToolBar *bar = d->toolBarText = addToolBar (tr ("Text Toolbar"));
+
+    bar->setOrientation (Qt::Horizontal);
+    bar->setAllowedAreas (Qt::TopToolBarArea);
+
+    bar->addAction (d->actionTextFontFamily);
+    bar->addAction (d->actionTextFontSize);
+
+    bar->addSeparator ();
 
+    bar->addAction (d->actionTextBold);
+    bar->addAction (d->actionTextItalic);
+    bar->addAction (d->actionTextUnderline);
+    bar->addAction (d->actionTextStrikeThru);
 
     enableTextToolBarActions (false);
 }
@@ -135,6 +160,15 @@ void kpMainWindow::enableTextToolBarActions (bool enable)
     kDebug () << "kpMainWindow::enableTextToolBarActions(" << enable << ")";
 #endif
 
+    if (!d->toolBarText)
+    {
+        // Not created yet: already as good as disabled.
+        if (!enable)
+            return;
+
+        createTextToolBar ();
+    }
+
     d->actionTextFontFamily->setEnabled (enable);
     d->actionTextFontSize->setEnabled (enable);
     d->actionTextBold->setEnabled (enable);
@@ -356,6 +390,23 @@ bool kpMainWindow::isTextStyleBackgroundOpaque () const
 // public
 kpTextStyle kpMainWindow::textStyle () const
 {
+    if (!d->toolBarText)
+    {
+        // What createTextToolBar() will start with.
+        QSettings settings;
+        settings.beginGroup(kpSettingsGroupText);
+
+        return kpTextStyle (settings.value (kpSettingFontFamily, QString::fromLatin1 ("Times")).toString (),
+                            settings.value (kpSettingFontSize, 14).toInt (),
+                            settings.value (kpSettingBold, false).toBool (),
+                            settings.value (kpSettingItalic, false).toBool (),
+                            settings.value (kpSettingUnderline, false).toBool (),
+                            settings.value (kpSettingStrikeThru, false).toBool (),
+                            d->colorToolBar ? d->colorToolBar->foregroundColor () : kpColor::Invalid,
+                            d->colorToolBar ? d->colorToolBar->backgroundColor () : kpColor::Invalid,
+                            isTextStyleBackgroundOpaque ());
+    }
+
     return kpTextStyle (d->actionTextFontFamily->font(),
                         d->actionTextFontSize->fontSize (),
                         d->actionTextBold->isChecked (),
@@ -376,6 +427,9 @@ void kpMainWindow::setTextStyle (const kpTextStyle &textStyle_)
 
     d->settingTextStyle++;
 
+    if (!d->toolBarText)
+        createTextToolBar ();
+
 
     if (textStyle_.fontFamily () != d->actionTextFontFamily->font ())
     {
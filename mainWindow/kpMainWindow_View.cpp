@@ -58,6 +58,7 @@ void kpMainWindow::setupViewMenuActions ()
     d->viewMenuDocumentActionsEnabled = false;
 
     setupViewMenuZoomActions ();
+    setupViewMenuThumbnailActions ();
 
     enableViewMenuDocumentActions (false);
 }
@@ -79,6 +80,7 @@ void kpMainWindow::enableViewMenuDocumentActions (bool enable)
 
 
     enableViewMenuZoomDocumentActions (enable);
+    enableViewMenuThumbnailDocumentActions (enable);
 }
 
 //---------------------------------------------------------------------
@@ -0,0 +1,326 @@
+/*
+   Copyright (c) 2015-2018 Maikel Diaz <ariguanabosoft@gmail.com>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <kpMainWindow.h>
+#include <kpMainWindowPrivate.h>
+
+#include <qsettings.h>
+#include <qtimer.h>
+
+#include <qdebug.h>
+#include <kactioncollection.h>
+#include <tools.h>
+
+#include <kpDefs.h>
+#include <kpDocument.h>
+#include <kpThumbnail.h>
+#include <kpThumbnailView.h>
+#include <kpToolToolBar.h>
+#include <kpViewManager.h>
+#include <kpViewScrollableContainer.h>
+#include <kpZoomedView.h>
+
+//---------------------------------------------------------------------
+
+// private
+void kpMainWindow::setupViewMenuThumbnailActions ()
+{
+    d->thumbnailSaveConfigTimer = 0;
+
+    QSettings settings;
+    settings.beginGroup (kpSettingsGroupThumbnail);
+    d->configThumbnailShown = settings.value (kpSettingThumbnailShown, false).toBool ();
+    d->configThumbnailGeometry = settings.value (kpSettingThumbnailGeometry).toRect ();
+    d->configZoomedThumbnail = settings.value (kpSettingThumbnailZoomed, true).toBool ();
+    d->configThumbnailShowRectangle = settings.value (kpSettingThumbnailShowRectangle, true).toBool ();
+    settings.endGroup ();
+
+#if DEBUG_KP_MAIN_WINDOW
+    kDebug () << "\t\tThumbnail Settings: shown=" << d->configThumbnailShown
+              << " geometry=" << d->configThumbnailGeometry
+              << " zoomed=" << d->configZoomedThumbnail
+              << " showRectangle=" << d->configThumbnailShowRectangle;
+#endif
+
+
+    KActionCollection *ac = actionCollection ();
+
+    d->actionShowThumbnail = ac->addAction ("view_show_thumbnail");
+    d->actionShowThumbnail->setCheckable (true);
+    d->actionShowThumbnail->setText (i18n ("Show T&humbnail"));
+    d->actionShowThumbnail->setShortcut (Qt::CTRL + Qt::Key_H);
+    connect (d->actionShowThumbnail, SIGNAL (triggered (bool)),
+             SLOT (slotShowThumbnailToggled ()));
+
+    d->actionZoomedThumbnail = ac->addAction ("view_zoomed_thumbnail");
+    d->actionZoomedThumbnail->setCheckable (true);
+    d->actionZoomedThumbnail->setText (i18n ("Zoo&med Thumbnail Mode"));
+    connect (d->actionZoomedThumbnail, SIGNAL (triggered (bool)),
+             SLOT (slotZoomedThumbnailToggled ()));
+
+    d->actionShowThumbnailRectangle = ac->addAction ("view_show_thumbnail_rectangle");
+    d->actionShowThumbnailRectangle->setCheckable (true);
+    d->actionShowThumbnailRectangle->setText (i18n ("Enable Thumbnail &Rectangle"));
+    connect (d->actionShowThumbnailRectangle, SIGNAL (triggered (bool)),
+             SLOT (slotThumbnailShowRectangleToggled ()));
+
+    enableViewMenuThumbnailDocumentActions (false);
+}
+
+//---------------------------------------------------------------------
+
+// private
+void kpMainWindow::enableViewMenuThumbnailDocumentActions (bool enable)
+{
+    d->actionShowThumbnail->setEnabled (enable);
+    d->actionShowThumbnail->setChecked (d->configThumbnailShown);
+
+    updateThumbnail ();
+}
+
+//---------------------------------------------------------------------
+
+// private
+void kpMainWindow::enableThumbnailOptionActions (bool enable)
+{
+    d->actionZoomedThumbnail->setEnabled (enable);
+    d->actionZoomedThumbnail->setChecked (d->configZoomedThumbnail);
+
+    d->actionShowThumbnailRectangle->setEnabled (enable);
+    d->actionShowThumbnailRectangle->setChecked (d->configThumbnailShowRectangle);
+}
+
+//---------------------------------------------------------------------
+
+// private
+void kpMainWindow::updateThumbnail ()
+{
+    const bool show = (d->configThumbnailShown &&
+                       d->actionShowThumbnail->isEnabled () &&
+                       d->document && d->mainView);
+
+#if DEBUG_KP_MAIN_WINDOW
+    kDebug () << "kpMainWindow::updateThumbnail() show=" << show
+              << " thumbnail=" << d->thumbnail
+              << " thumbnailView=" << d->thumbnailView;
+#endif
+
+    if (show)
+    {
+        if (!d->thumbnail)
+        {
+            d->thumbnail = new kpThumbnail (this);
+            d->thumbnail->setObjectName (QLatin1String ("thumbnail"));
+
+            if (d->configThumbnailGeometry.isValid ())
+            {
+                d->thumbnail->setGeometry (mapToGlobal (d->configThumbnailGeometry));
+            }
+            else
+            {
+                // Top-right corner of the document area.
+                const int margin = 16;
+                const QRect scrollViewRect = d->scrollView->geometry ();
+                const QSize size (qMax (160, scrollViewRect.width () / 4),
+                                  qMax (120, scrollViewRect.height () / 4));
+                d->thumbnail->setGeometry (mapToGlobal (QRect (
+                    scrollViewRect.right () - margin - size.width (),
+                    scrollViewRect.top () + margin,
+                    size.width (), size.height ())));
+            }
+
+            connect (d->thumbnail, SIGNAL (windowClosed ()),
+                     this, SLOT (slotThumbnailClosedByUser ()));
+        }
+
+        if (!d->thumbnailView)
+            createThumbnailView ();
+
+        d->thumbnail->show ();
+    }
+    else
+    {
+        destroyThumbnailView ();
+
+        if (d->thumbnail)
+        {
+            // (we may be called from a signal of <d->thumbnail>)
+            d->thumbnail->hide ();
+            d->thumbnail->deleteLater ();
+            d->thumbnail = 0;
+        }
+    }
+
+    enableThumbnailOptionActions (show);
+}
+
+//---------------------------------------------------------------------
+
+// private
+void kpMainWindow::createThumbnailView ()
+{
+    Q_ASSERT (d->thumbnail && !d->thumbnailView);
+    Q_ASSERT (d->document && d->viewManager && d->mainView);
+
+    d->thumbnailView = new kpThumbnailView (d->document, d->toolToolBar,
+        d->viewManager,
+        d->mainView/*buddyView*/,
+        d->configZoomedThumbnail,
+        d->thumbnail);
+    d->thumbnailView->setObjectName (QLatin1String ("thumbnailView"));
+
+    d->thumbnail->setView (d->thumbnailView);
+    d->viewManager->registerView (d->thumbnailView);
+
+    d->thumbnailView->showBuddyViewScrollableContainerRectangle (
+        d->configThumbnailShowRectangle);
+}
+
+//---------------------------------------------------------------------
+
+// private
+void kpMainWindow::destroyThumbnailView ()
+{
+    if (!d->thumbnailView)
+        return;
+
+    if (d->viewManager)
+        d->viewManager->unregisterView (d->thumbnailView);
+
+    if (d->thumbnail)
+        d->thumbnail->setView (0);
+
+    delete d->thumbnailView; d->thumbnailView = 0;
+}
+
+//---------------------------------------------------------------------
+
+// private slot
+void kpMainWindow::slotShowThumbnailToggled ()
+{
+#if DEBUG_KP_MAIN_WINDOW
+    kDebug () << "kpMainWindow::slotShowThumbnailToggled()";
+#endif
+
+    d->configThumbnailShown = d->actionShowThumbnail->isChecked ();
+
+    QSettings settings;
+    settings.beginGroup (kpSettingsGroupThumbnail);
+    settings.setValue (kpSettingThumbnailShown, d->configThumbnailShown);
+    settings.endGroup ();
+
+    updateThumbnail ();
+}
+
+//---------------------------------------------------------------------
+
+// private slot
+void kpMainWindow::slotThumbnailClosedByUser ()
+{
+    d->actionShowThumbnail->setChecked (false);
+    slotShowThumbnailToggled ();
+}
+
+//---------------------------------------------------------------------
+
+// private slot
+void kpMainWindow::slotZoomedThumbnailToggled ()
+{
+    d->configZoomedThumbnail = d->actionZoomedThumbnail->isChecked ();
+
+    QSettings settings;
+    settings.beginGroup (kpSettingsGroupThumbnail);
+    settings.setValue (kpSettingThumbnailZoomed, d->configZoomedThumbnail);
+    settings.endGroup ();
+
+    // The mode is fixed for the lifetime of a view.
+    if (d->thumbnailView)
+    {
+        destroyThumbnailView ();
+        createThumbnailView ();
+    }
+}
+
+//---------------------------------------------------------------------
+
+// private slot
+void kpMainWindow::slotThumbnailShowRectangleToggled ()
+{
+    d->configThumbnailShowRectangle = d->actionShowThumbnailRectangle->isChecked ();
+
+    QSettings settings;
+    settings.beginGroup (kpSettingsGroupThumbnail);
+    settings.setValue (kpSettingThumbnailShowRectangle, d->configThumbnailShowRectangle);
+    settings.endGroup ();
+
+    if (d->thumbnailView)
+    {
+        d->thumbnailView->showBuddyViewScrollableContainerRectangle (
+            d->configThumbnailShowRectangle);
+    }
+}
+
+//---------------------------------------------------------------------
+
+// public
+void kpMainWindow::notifyThumbnailGeometryChanged ()
+{
+    // Save once the user has finished moving or resizing the thumbnail.
+    if (!d->thumbnailSaveConfigTimer)
+    {
+        d->thumbnailSaveConfigTimer = new QTimer (this);
+        d->thumbnailSaveConfigTimer->setSingleShot (true);
+        connect (d->thumbnailSaveConfigTimer, SIGNAL (timeout ()),
+                 this, SLOT (slotSaveThumbnailGeometry ()));
+    }
+
+    d->thumbnailSaveConfigTimer->start (500/*msec*/);
+}
+
+//---------------------------------------------------------------------
+
+// private slot
+void kpMainWindow::slotSaveThumbnailGeometry ()
+{
+    if (!d->thumbnail)
+        return;
+
+    // (relative to us, so that it follows us around)
+    d->configThumbnailGeometry = mapFromGlobal (d->thumbnail->geometry ());
+
+#if DEBUG_KP_MAIN_WINDOW
+    kDebug () << "kpMainWindow::slotSaveThumbnailGeometry()"
+              << d->configThumbnailGeometry;
+#endif
+
+    QSettings settings;
+    settings.beginGroup (kpSettingsGroupThumbnail);
+    settings.setValue (kpSettingThumbnailGeometry, d->configThumbnailGeometry);
+    settings.endGroup ();
+}
+
+//---------------------------------------------------------------------
@@ -327,8 +327,8 @@ void kpMainWindow::zoomTo (int zoomLevel, bool centerUnderCursor)
     #if DEBUG_KP_MAIN_WINDOW && 1
         kDebug () << "\tscrollView   contentsX=" << d->scrollView->horizontalScrollBar()->value ()
                    << " contentsY=" << d->scrollView->verticalScrollBar()->value ()
-                   << " contentsWidth=" << d->scrollView->widget()->width ()
-                   << " contentsHeight=" << d->scrollView->widget()->height ()
+                   << " zoomedDocWidth=" << d->mainView->zoomedDocWidth ()
+                   << " zoomedDocHeight=" << d->mainView->zoomedDocHeight ()
                    << " visibleWidth=" << d->scrollView->viewport()->width ()
                    << " visibleHeight=" << d->scrollView->viewport()->height ()
                    << " oldZoomX=" << d->mainView->zoomLevelX ()
@@ -367,8 +367,10 @@ void kpMainWindow::zoomTo (int zoomLevel, bool centerUnderCursor)
             if (vuc != d->mainView)
                 viewPoint = vuc->transformViewToOtherView (viewPoint, d->mainView);
 
-            viewX = viewPoint.x ();
-            viewY = viewPoint.y ();
+            // (view coordinates are relative to the scrolled origin; the
+            //  centering below is in terms of the scrolled contents)
+            viewX = viewPoint.x () - d->mainView->origin ().x ();
+            viewY = viewPoint.y () - d->mainView->origin ().y ();
         }
         else
         {
@@ -552,7 +554,8 @@ void kpMainWindow::zoomToRect (const QRect &normalizedDocRect,
         d->mainView->setZoomLevel (zoomLevel, zoomLevel);
 
         const QPoint viewPoint =
-            d->mainView->transformDocToView (normalizedDocRect.topLeft ());
+            d->mainView->transformDocToView (normalizedDocRect.topLeft ()) -
+            d->mainView->origin ();
 
         d->scrollView->horizontalScrollBar()->setValue(viewPoint.x());
         d->scrollView->verticalScrollBar()->setValue(viewPoint.y());
@@ -591,7 +594,7 @@ void kpMainWindow::slotFitToWidth ()
   {
     const QRect docRect (
         0/*x*/,
-        (int) d->mainView->transformViewToDocY (d->scrollView->verticalScrollBar()->value ())/*maintain y*/,
+        (int) d->mainView->transformViewToDocY (0)/*maintain y*/,
         d->document->width (),
         1/*don't care about height*/);
     zoomToRect (
@@ -609,7 +612,7 @@ void kpMainWindow::slotFitToHeight ()
   if ( d->document )
   {
     const QRect docRect (
-        (int) d->mainView->transformViewToDocX (d->scrollView->horizontalScrollBar()->value ())/*maintain x*/,
+        (int) d->mainView->transformViewToDocX (0)/*maintain x*/,
         0/*y*/,
         1/*don't care about width*/,
         d->document->height ());
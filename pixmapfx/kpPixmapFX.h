@@ -40,6 +40,7 @@
 #include <kpColor.h>
 
 
+class QAtomicInt;
 class QBitmap;
 class QColor;
 class QImage;
@@ -79,6 +80,20 @@ public:
     //
     static QImage getPixmapAt (const QImage &pm, const QRect &rect);
 
+    //
+    // Same as getPixmapAt() but, if <rect> lies inside <pm>, returns an
+    // image that reads <pm>'s pixels in place instead of copying them.
+    // Writing to the returned image makes it take its own copy first.
+    //
+    // If <keepAlive> is set, the returned image holds a reference to <pm>'s
+    // data, so it stays valid whatever happens to <pm> -- but writing to
+    // <pm> while it exists will then detach (copy all of) <pm>.  Pass false
+    // only if <pm> is not shared and outlives the returned image, in which
+    // case the returned image sees any later writes to <pm>.
+    //
+    static QImage getPixmapViewAt (const QImage &pm, const QRect &rect,
+                                   bool keepAlive = true);
+
     //
     // Sets the pixel and mask data at <destRect> in <*destPixmapPtr>
     // to <srcPixmap>.  Neither <destRect>'s width nor height are allowed
@@ -152,13 +167,41 @@ public:
     static QImage resize (const QImage &pm, int w, int h,
                            const kpColor &backgroundColor);
 
+    //
+    // Filters for scale().  All but NearestFilter blend neighboring pixels
+    // and, when shrinking, average over the whole area that each new pixel
+    // covers.
+    //
+    enum ScaleFilter
+    {
+        NearestFilter,   // duplicates or drops pixels
+        BoxFilter,       // area average - good for large reductions
+        BilinearFilter,
+        Lanczos3Filter   // sharpest - may ring slightly at hard edges
+    };
+
     //
     // Scales an image to the given width and height.
-    // If <pretty> is true, a smooth scale will be used.
+    // If <pretty> is true, a smooth scale (BilinearFilter) will be used.
     //
     static void scale (QImage *destPtr, int w, int h, bool pretty = false);
     static QImage scale (const QImage &pm, int w, int h, bool pretty = false);
 
+    //
+    // Scales an image to the given width and height with <filter>, in
+    // separate horizontal and vertical passes on worker threads.
+    //
+    // With NearestFilter, integer scales duplicate or pick pixels exactly
+    // so scaling an enlarged image back to its old size restores it.
+    //
+    // If <cancelled> is given and becomes non-zero, e.g. from another
+    // thread, the scale stops part way through and a null image is
+    // returned.
+    //
+    static void scale (QImage *destPtr, int w, int h, ScaleFilter filter);
+    static QImage scale (const QImage &pm, int w, int h, ScaleFilter filter,
+                         const QAtomicInt *cancelled = 0);
+
 
     // The minimum difference between 2 angles (in degrees) such that they are
     // considered different.  This gives you at least enough precision to
@@ -202,6 +245,9 @@ public:
     // Using <targetWidth> & <targetHeight> to generate preview pixmaps is
     // significantly more efficient than rotating and then scaling yourself.
     //
+    // If isLosslessRotation(<angle>) and no target size is given, the pixels
+    // are moved exactly, on multiple threads, instead of being drawn.
+    //
     static QMatrix rotateMatrix (int width, int height, double angle);
     static QMatrix rotateMatrix (const QImage &pixmap, double angle);
 
@@ -216,7 +262,8 @@ public:
 
 
     //
-    // Flips an image in the given directions.
+    // Flips an image in the given directions (exactly and, for 32-bit
+    // images, on multiple threads).
     //
     static QMatrix flipMatrix (int width, int height, bool horz, bool vert);
     static QMatrix flipMatrix (const QImage &pixmap, bool horz, bool vert);
@@ -34,22 +34,153 @@
 #include <kpPixmapFX.h>
 
 #include <math.h>
+#include <string.h>
 
 #include <qimage.h>
 #include <qpainter.h>
 #include <qpoint.h>
 #include <qrect.h>
+#include <QtConcurrentMap>
 
 #include <qdebug.h>
 
 #include <kpColor.h>
+#include <kpRowBands.h>
+
+//---------------------------------------------------------------------
+
+// Copies the rows of a kpRowBand from one image's bits to another's.
+struct CopyRowsWorker
+{
+    typedef void result_type;
+
+    const uchar *srcBits;
+    int srcBytesPerLine;
+    uchar *destBits;
+    int destBytesPerLine;
+    int rowBytes;
+
+    void operator() (const kpRowBand &band) const
+    {
+        for (int y = band.top; y < band.bottom; y++)
+        {
+            memcpy (destBits + y * destBytesPerLine,
+                    srcBits + y * srcBytesPerLine,
+                    rowBytes);
+        }
+    }
+};
+
+//---------------------------------------------------------------------
+
+// Returns whether CopyRows() can copy between images of <srcFormat> and
+// <destFormat> and get the same result as QPainter::CompositionMode_Source.
+static bool CanCopyRows (QImage::Format srcFormat, QImage::Format destFormat)
+{
+    return (srcFormat == destFormat &&
+            (destFormat == QImage::Format_ARGB32_Premultiplied ||
+             destFormat == QImage::Format_RGB32));
+}
+
+//---------------------------------------------------------------------
+
+// Copies <numRows> rows of <rowBytes> bytes.  Copies of more than a few
+// megabytes are split between threads.
+static void CopyRows (const uchar *srcBits, int srcBytesPerLine,
+                      uchar *destBits, int destBytesPerLine,
+                      int rowBytes, int numRows)
+{
+    CopyRowsWorker worker;
+    worker.srcBits = srcBits;
+    worker.srcBytesPerLine = srcBytesPerLine;
+    worker.destBits = destBits;
+    worker.destBytesPerLine = destBytesPerLine;
+    worker.rowBytes = rowBytes;
+
+    // Memory bandwidth, not CPU, is the limit so only bother with threads
+    // once each has a decent amount to copy.
+    const int minBandBytes = 1024 * 1024;
+    QList <kpRowBand> bands = kpRowBands::Split (numRows,
+        qMax (1, minBandBytes / qMax (1, rowBytes)));
+
+    if (bands.size () == 1)
+        worker (bands.first ());
+    else
+        QtConcurrent::blockingMap (bands, worker);
+}
 
 //---------------------------------------------------------------------
 
 // public static
 QImage kpPixmapFX::getPixmapAt (const QImage &image, const QRect &rect)
 {
-  return image.copy(rect);
+    // QImage::copy() is a single-threaded memcpy() already -- only big
+    // copies gain from CopyRows().
+    if (!::CanCopyRows (image.format (), image.format ()) ||
+        !image.rect ().contains (rect) ||
+        qint64 (rect.width ()) * rect.height () < 1024 * 1024)
+    {
+        return image.copy (rect);
+    }
+
+    QImage destImage (rect.size (), image.format ());
+    if (destImage.isNull ())
+        return image.copy (rect);
+
+    ::CopyRows (image.constBits () + rect.y () * image.bytesPerLine () +
+                    rect.x () * 4,
+                image.bytesPerLine (),
+                destImage.bits (), destImage.bytesPerLine (),
+                rect.width () * 4, rect.height ());
+
+    // Keep the metadata that QImage::copy() would have.
+    destImage.setDotsPerMeterX (image.dotsPerMeterX ());
+    destImage.setDotsPerMeterY (image.dotsPerMeterY ());
+    destImage.setOffset (image.offset ());
+    foreach (const QString &key, image.textKeys ())
+        destImage.setText (key, image.text (key));
+
+    return destImage;
+}
+
+//---------------------------------------------------------------------
+
+#if QT_VERSION >= 0x050000
+// Cleanup function for the images returned by getPixmapViewAt().
+static void ReleaseViewedImage (void *info)
+{
+    delete static_cast <QImage *> (info);
+}
+#endif
+
+// public static
+QImage kpPixmapFX::getPixmapViewAt (const QImage &image, const QRect &rect,
+                                    bool keepAlive)
+{
+#if QT_VERSION >= 0x050000
+    // Bit-packed formats can't start a view at an arbitrary x and setting
+    // a color table on a view would copy it anyway.
+    if (image.isNull () || image.depth () < 8 ||
+        !image.colorTable ().isEmpty () ||
+        rect.isEmpty () || !image.rect ().contains (rect))
+    {
+        return kpPixmapFX::getPixmapAt (image, rect);
+    }
+
+    // (constBits() does not detach <image>)
+    const uchar *bits = image.constBits () +
+        rect.y () * image.bytesPerLine () + rect.x () * (image.depth () / 8);
+
+    // The const constructor never writes to <bits> -- modifying the view
+    // detaches it instead.  (So don't call any setter on it here.)
+    return QImage (bits, rect.width (), rect.height (), image.bytesPerLine (),
+        image.format (),
+        keepAlive ? &::ReleaseViewedImage : 0,
+        keepAlive ? new QImage (image) : 0);
+#else
+    Q_UNUSED (keepAlive);
+    return kpPixmapFX::getPixmapAt (image, rect);
+#endif
 }
 
 //---------------------------------------------------------------------
@@ -75,6 +206,28 @@ void kpPixmapFX::setPixmapAt(QImage *destPtr, const QRect &destRect,
     Q_ASSERT (destRect.width () <= src.width () &&
               destRect.height () <= src.height ());
 
+    // Copying pixels as they are doesn't need a painter.
+    if (mode == QPainter::CompositionMode_Source &&
+        ::CanCopyRows (src.format (), destPtr->format ()))
+    {
+        const QRect clippedRect = destRect & destPtr->rect ();
+        if (clippedRect.isEmpty ())
+            return;
+
+        const QPoint srcAt = clippedRect.topLeft () - destRect.topLeft ();
+
+        // (bits() detaches, on this thread, before any workers start)
+        uchar *destBits = destPtr->bits ();
+        ::CopyRows (src.constBits () + srcAt.y () * src.bytesPerLine () +
+                        srcAt.x () * 4,
+                    src.bytesPerLine (),
+                    destBits + clippedRect.y () * destPtr->bytesPerLine () +
+                        clippedRect.x () * 4,
+                    destPtr->bytesPerLine (),
+                    clippedRect.width () * 4, clippedRect.height ());
+        return;
+    }
+
     QPainter painter(destPtr);
     // destination shall be source only
     painter.setCompositionMode(mode); // ikPaint change: QPainter::CompositionMode_Source;
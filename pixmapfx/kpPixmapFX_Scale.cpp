@@ -0,0 +1,564 @@
+/*
+   Copyright (c) 2015-2018 Maikel Diaz <ariguanabosoft@gmail.com>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#define DEBUG_KP_PIXMAP_FX 0
+
+
+#include <kpPixmapFX.h>
+
+#include <math.h>
+#include <string.h>
+
+#include <QAtomicInt>
+#include <QImage>
+#include <QVector>
+#include <QtConcurrentMap>
+
+#include <qdebug.h>
+
+#include <kpDefs.h>
+#include <kpRowBands.h>
+
+//---------------------------------------------------------------------
+
+// Fixed point precision of the filter weights.  The weights of each
+// destination pixel add up to exactly 1 << WeightBits.
+static const int WeightBits = 14;
+static const int WeightHalf = 1 << (WeightBits - 1);
+
+//---------------------------------------------------------------------
+
+static double BoxKernel (double x)
+{
+    return (x >= -0.5 && x < 0.5) ? 1.0 : 0.0;
+}
+
+static double BilinearKernel (double x)
+{
+    x = fabs (x);
+    return (x < 1.0) ? 1.0 - x : 0.0;
+}
+
+static double Sinc (double x)
+{
+    if (x == 0.0)
+        return 1.0;
+
+    x *= KP_PI;
+    return sin (x) / x;
+}
+
+static double Lanczos3Kernel (double x)
+{
+    return (x > -3.0 && x < 3.0) ? Sinc (x) * Sinc (x / 3.0) : 0.0;
+}
+
+//---------------------------------------------------------------------
+
+// For each destination pixel along one axis, the run of source pixels that
+// it is blended from and their fixed point weights.
+struct ScaleWeights
+{
+    int maxTaps;
+    QVector <int> firstTap;  // [destSize]
+    QVector <int> numTaps;   // [destSize]
+    QVector <int> weights;   // [destSize * maxTaps]
+};
+
+static ScaleWeights CalculateScaleWeights (int srcSize, int destSize,
+        kpPixmapFX::ScaleFilter filter)
+{
+    double (*kernel) (double) = BilinearKernel;
+    double kernelSupport = 1.0;
+
+    switch (filter)
+    {
+    case kpPixmapFX::BoxFilter:
+        kernel = BoxKernel;
+        kernelSupport = 0.5;
+        break;
+
+    case kpPixmapFX::Lanczos3Filter:
+        kernel = Lanczos3Kernel;
+        kernelSupport = 3.0;
+        break;
+
+    default:
+        break;
+    }
+
+    const double scale = double (srcSize) / double (destSize);
+
+    // When shrinking, stretch the kernel over the whole area that each
+    // destination pixel covers so that no source pixel is skipped.
+    const double filterScale = qMax (1.0, scale);
+    const double support = kernelSupport * filterScale;
+
+    ScaleWeights ret;
+    ret.maxTaps = int (ceil (support)) * 2 + 1;
+    ret.firstTap.resize (destSize);
+    ret.numTaps.resize (destSize);
+    ret.weights.fill (0, destSize * ret.maxTaps);
+
+    QVector <double> tapWeights (ret.maxTaps);
+
+    for (int d = 0; d < destSize; d++)
+    {
+        const double center = (d + 0.5) * scale;
+
+        int first = qMax (0, int (center - support + 0.5));
+        int count = qMin (qMin (srcSize, int (center + support + 0.5)) - first,
+                          ret.maxTaps);
+
+        double total = 0;
+        for (int i = 0; i < count; i++)
+        {
+            tapWeights [i] = kernel ((first + i - center + 0.5) / filterScale);
+            total += tapWeights [i];
+        }
+
+        int *w = ret.weights.data () + d * ret.maxTaps;
+
+        int sum = 0, largest = 0;
+        for (int i = 0; i < count; i++)
+        {
+            w [i] = (total != 0) ?
+                qRound (tapWeights [i] / total * (1 << WeightBits)) :
+                0;
+            sum += w [i];
+
+            if (w [i] > w [largest])
+                largest = i;
+        }
+
+        // Put the rounding error on the largest weight so that areas of a
+        // single color keep exactly that color.
+        w [largest] += (1 << WeightBits) - sum;
+
+        // Don't visit source pixels that do not contribute.
+        int leading = 0;
+        while (leading < count - 1 && w [leading] == 0)
+            leading++;
+        if (leading > 0)
+        {
+            memmove (w, w + leading, (count - leading) * sizeof (int));
+            memset (w + count - leading, 0, leading * sizeof (int));
+            first += leading;
+            count -= leading;
+        }
+        while (count > 1 && w [count - 1] == 0)
+            count--;
+
+        ret.firstTap [d] = first;
+        ret.numTaps [d] = count;
+    }
+
+    return ret;
+}
+
+//---------------------------------------------------------------------
+
+// Packs filtered channels into a premultiplied pixel.  Negative filter
+// lobes can overshoot so the channels are clamped, the color ones to alpha.
+static inline QRgb PackPixel (int a, int r, int g, int b, bool opaque)
+{
+    a = opaque ? 255 : qBound (0, a >> WeightBits, 255);
+
+    return qRgba (qBound (0, r >> WeightBits, a),
+                  qBound (0, g >> WeightBits, a),
+                  qBound (0, b >> WeightBits, a),
+                  a);
+}
+
+//---------------------------------------------------------------------
+
+// Raw access to the 32-bit images of a scaling pass, so that the passes
+// can run on worker threads.
+struct ScalePass
+{
+    const uchar *srcBits;
+    int srcBytesPerLine;
+    int srcWidth;
+
+    uchar *destBits;
+    int destBytesPerLine;
+    int destWidth;
+
+    // (the image is Format_RGB32)
+    bool opaque;
+
+    // Set to stop part way through (may be 0).
+    const QAtomicInt *cancelled;
+
+    bool isCancelled () const
+    {
+        return (cancelled && cancelled->loadAcquire ());
+    }
+
+    const QRgb *srcLine (int y) const
+    {
+        return reinterpret_cast <const QRgb *> (srcBits + y * srcBytesPerLine);
+    }
+
+    QRgb *destLine (int y) const
+    {
+        return reinterpret_cast <QRgb *> (destBits + y * destBytesPerLine);
+    }
+};
+
+//---------------------------------------------------------------------
+
+// Filters the rows of a kpRowBand horizontally.
+struct HorizontalScaleWorker : public ScalePass
+{
+    typedef void result_type;
+
+    const int *firstTap, *numTaps, *weights;
+    int maxTaps;
+
+    void operator() (const kpRowBand &band) const
+    {
+        for (int y = band.top; y < band.bottom && !isCancelled (); y++)
+        {
+            const QRgb *src = srcLine (y);
+            QRgb *dest = destLine (y);
+
+            for (int x = 0; x < destWidth; x++)
+            {
+                const QRgb *s = src + firstTap [x];
+                const int *w = weights + x * maxTaps;
+                const int n = numTaps [x];
+
+                int a = WeightHalf, r = WeightHalf, g = WeightHalf, b = WeightHalf;
+                for (int i = 0; i < n; i++)
+                {
+                    const QRgb p = s [i];
+                    a += w [i] * int (qAlpha (p));
+                    r += w [i] * int (qRed (p));
+                    g += w [i] * int (qGreen (p));
+                    b += w [i] * int (qBlue (p));
+                }
+
+                dest [x] = PackPixel (a, r, g, b, opaque);
+            }
+        }
+    }
+};
+
+//---------------------------------------------------------------------
+
+// Filters the destination rows of a kpRowBand vertically.  Whole source
+// rows are accumulated at a time, with a single weight, so that the inner
+// loop is a straight run over memory that the compiler can vectorize.
+struct VerticalScaleWorker : public ScalePass
+{
+    typedef void result_type;
+
+    const int *firstTap, *numTaps, *weights;
+    int maxTaps;
+
+    void operator() (const kpRowBand &band) const
+    {
+        QVector <int> sums (destWidth * 4);
+
+        for (int y = band.top; y < band.bottom && !isCancelled (); y++)
+        {
+            int *sum = sums.data ();
+            for (int i = 0; i < destWidth * 4; i++)
+                sum [i] = WeightHalf;
+
+            const int *w = weights + y * maxTaps;
+            for (int t = 0; t < numTaps [y]; t++)
+            {
+                const QRgb *src = srcLine (firstTap [y] + t);
+                const int weight = w [t];
+
+                for (int x = 0; x < destWidth; x++)
+                {
+                    const QRgb p = src [x];
+                    sum [x * 4 + 0] += weight * int (qAlpha (p));
+                    sum [x * 4 + 1] += weight * int (qRed (p));
+                    sum [x * 4 + 2] += weight * int (qGreen (p));
+                    sum [x * 4 + 3] += weight * int (qBlue (p));
+                }
+            }
+
+            QRgb *dest = destLine (y);
+            for (int x = 0; x < destWidth; x++)
+            {
+                dest [x] = PackPixel (sum [x * 4 + 0], sum [x * 4 + 1],
+                                      sum [x * 4 + 2], sum [x * 4 + 3],
+                                      opaque);
+            }
+        }
+    }
+};
+
+//---------------------------------------------------------------------
+
+// Picks the source pixel under the centre of each destination pixel in the
+// destination rows of a kpRowBand.
+//
+// This is exact for integer scales: enlarging by n duplicates every pixel
+// n times and shrinking by n picks one pixel out of each n, which restores
+// the enlarged image.
+struct NearestScaleWorker : public ScalePass
+{
+    typedef void result_type;
+
+    const int *srcX;  // [destWidth]
+    const int *srcY;  // [destHeight]
+
+    // > 0 if destWidth is this whole multiple of srcWidth
+    int replicateX;
+
+    void operator() (const kpRowBand &band) const
+    {
+        for (int y = band.top; y < band.bottom && !isCancelled (); y++)
+        {
+            QRgb *dest = destLine (y);
+
+            if (y > band.top && srcY [y] == srcY [y - 1])
+            {
+                // Duplicated row - copy the one we have just made.
+                memcpy (dest, destLine (y - 1), destWidth * sizeof (QRgb));
+                continue;
+            }
+
+            const QRgb *src = srcLine (srcY [y]);
+
+            if (replicateX > 0)
+            {
+                for (int x = 0; x < srcWidth; x++)
+                {
+                    const QRgb p = src [x];
+                    for (int i = 0; i < replicateX; i++)
+                        *dest++ = p;
+                }
+            }
+            else
+            {
+                for (int x = 0; x < destWidth; x++)
+                    dest [x] = src [srcX [x]];
+            }
+        }
+    }
+};
+
+//---------------------------------------------------------------------
+
+// Returns the index of the source pixel under the centre of each of
+// <destSize> destination pixels.
+static QVector <int> NearestIndexes (int srcSize, int destSize)
+{
+    QVector <int> ret (destSize);
+    for (int d = 0; d < destSize; d++)
+        ret [d] = int ((qint64 (2 * d + 1) * srcSize) / (2 * qint64 (destSize)));
+    return ret;
+}
+
+//---------------------------------------------------------------------
+
+static void InitScalePass (ScalePass *pass, const QImage &srcImage,
+        QImage *destImage, const QAtomicInt *cancelled)
+{
+    pass->srcBits = srcImage.constBits ();
+    pass->srcBytesPerLine = srcImage.bytesPerLine ();
+    pass->srcWidth = srcImage.width ();
+    // (detaches here, on this thread, before the workers start)
+    pass->destBits = destImage->bits ();
+    pass->destBytesPerLine = destImage->bytesPerLine ();
+    pass->destWidth = destImage->width ();
+    pass->opaque = (srcImage.format () == QImage::Format_RGB32);
+    pass->cancelled = cancelled;
+}
+
+//---------------------------------------------------------------------
+
+static QImage ScaleNearest (const QImage &srcImage, int w, int h,
+        const QAtomicInt *cancelled)
+{
+    QImage destImage (w, h, srcImage.format ());
+    if (destImage.isNull ())
+        return destImage;
+
+    const QVector <int> srcX = NearestIndexes (srcImage.width (), w);
+    const QVector <int> srcY = NearestIndexes (srcImage.height (), h);
+
+    NearestScaleWorker worker;
+    InitScalePass (&worker, srcImage, &destImage, cancelled);
+    worker.srcX = srcX.constData ();
+    worker.srcY = srcY.constData ();
+    worker.replicateX = (w % srcImage.width () == 0) ? w / srcImage.width () : 0;
+
+    QList <kpRowBand> bands = kpRowBands::Split (h);
+    QtConcurrent::blockingMap (bands, worker);
+
+    return destImage;
+}
+
+//---------------------------------------------------------------------
+
+static QImage ScaleHorizontally (const QImage &srcImage, int w,
+        kpPixmapFX::ScaleFilter filter, const QAtomicInt *cancelled)
+{
+    QImage destImage (w, srcImage.height (), srcImage.format ());
+    if (destImage.isNull ())
+        return destImage;
+
+    const ScaleWeights weights = CalculateScaleWeights (srcImage.width (), w, filter);
+
+    HorizontalScaleWorker worker;
+    InitScalePass (&worker, srcImage, &destImage, cancelled);
+    worker.firstTap = weights.firstTap.constData ();
+    worker.numTaps = weights.numTaps.constData ();
+    worker.weights = weights.weights.constData ();
+    worker.maxTaps = weights.maxTaps;
+
+    QList <kpRowBand> bands = kpRowBands::Split (srcImage.height ());
+    QtConcurrent::blockingMap (bands, worker);
+
+    return destImage;
+}
+
+//---------------------------------------------------------------------
+
+static QImage ScaleVertically (const QImage &srcImage, int h,
+        kpPixmapFX::ScaleFilter filter, const QAtomicInt *cancelled)
+{
+    QImage destImage (srcImage.width (), h, srcImage.format ());
+    if (destImage.isNull ())
+        return destImage;
+
+    const ScaleWeights weights = CalculateScaleWeights (srcImage.height (), h, filter);
+
+    VerticalScaleWorker worker;
+    InitScalePass (&worker, srcImage, &destImage, cancelled);
+    worker.firstTap = weights.firstTap.constData ();
+    worker.numTaps = weights.numTaps.constData ();
+    worker.weights = weights.weights.constData ();
+    worker.maxTaps = weights.maxTaps;
+
+    QList <kpRowBand> bands = kpRowBands::Split (h);
+    QtConcurrent::blockingMap (bands, worker);
+
+    return destImage;
+}
+
+//---------------------------------------------------------------------
+
+// public static
+QImage kpPixmapFX::scale (const QImage &image, int w, int h,
+                          ScaleFilter filter, const QAtomicInt *cancelled)
+{
+#if DEBUG_KP_PIXMAP_FX && 0
+    kDebug () << "kpPixmapFX::scale(oldRect=" << image.rect ()
+               << ",w=" << w
+               << ",h=" << h
+               << ",filter=" << filter
+               << ")"
+               << endl;
+#endif
+
+    if (w == image.width () && h == image.height ())
+        return image;
+
+    if (image.isNull () || w <= 0 || h <= 0)
+        return QImage ();
+
+    QImage srcImage = image;
+    QImage destImage;
+
+    if (filter == NearestFilter)
+    {
+        // Pixels are only copied so any 32-bit format will do.
+        if (srcImage.depth () != 32)
+            srcImage = srcImage.convertToFormat (QImage::Format_ARGB32_Premultiplied);
+
+        destImage = ::ScaleNearest (srcImage, w, h, cancelled);
+    }
+    else
+    {
+        // Filter in premultiplied space so that the colors of transparent
+        // pixels do not bleed into their neighbours.
+        if (srcImage.format () != QImage::Format_RGB32 &&
+            srcImage.format () != QImage::Format_ARGB32_Premultiplied)
+        {
+            srcImage = srcImage.convertToFormat (QImage::Format_ARGB32_Premultiplied);
+        }
+
+        // Do the pass that leaves the smaller intermediate image first.
+        const bool horizontalFirst =
+            qint64 (w) * srcImage.height () <= qint64 (srcImage.width ()) * h;
+
+        destImage = srcImage;
+        for (int pass = 0;
+             pass < 2 && !destImage.isNull () &&
+                !(cancelled && cancelled->loadAcquire ());
+             pass++)
+        {
+            if ((pass == 0) == horizontalFirst)
+            {
+                if (w != destImage.width ())
+                    destImage = ::ScaleHorizontally (destImage, w, filter, cancelled);
+            }
+            else
+            {
+                if (h != destImage.height ())
+                    destImage = ::ScaleVertically (destImage, h, filter, cancelled);
+            }
+        }
+    }
+
+    if (cancelled && cancelled->loadAcquire ())
+        return QImage ();
+
+    if (destImage.isNull ())
+    {
+        qCritical () << "kpPixmapFX::scale() could not allocate"
+                     << w << "x" << h << "image";
+        return destImage;
+    }
+
+    destImage.setDotsPerMeterX (image.dotsPerMeterX ());
+    destImage.setDotsPerMeterY (image.dotsPerMeterY ());
+
+    return destImage;
+}
+
+//---------------------------------------------------------------------
+
+// public static
+void kpPixmapFX::scale (QImage *destPtr, int w, int h, ScaleFilter filter)
+{
+    if (!destPtr)
+        return;
+
+    *destPtr = kpPixmapFX::scale (*destPtr, w, h, filter);
+}
+
+//---------------------------------------------------------------------
@@ -34,17 +34,20 @@
 #include <kpPixmapFX.h>
 
 #include <math.h>
+#include <string.h>
 
 #include <qpainter.h>
 #include <QImage>
 #include <qpoint.h>
 #include <qrect.h>
+#include <QtConcurrentMap>
 
 #include <qdebug.h>
 
 #include <kpAbstractSelection.h>
 #include <kpColor.h>
 #include <kpDefs.h>
+#include <kpRowBands.h>
 
 //---------------------------------------------------------------------
 
@@ -122,11 +125,8 @@ QImage kpPixmapFX::scale (const QImage &image, int w, int h, bool pretty)
                << endl;
 #endif
 
-    if (w == image.width () && h == image.height ())
-        return image;
-
-    return image.scaled(w, h, Qt::IgnoreAspectRatio,
-                        pretty ? Qt::SmoothTransformation : Qt::FastTransformation);
+    return kpPixmapFX::scale (image, w, h,
+        pretty ? kpPixmapFX::BilinearFilter : kpPixmapFX::NearestFilter);
 }
 
 //---------------------------------------------------------------------
@@ -230,56 +230,93 @@ static QMatrix MatrixWithZeroOrigin (const QMatrix &matrix, int width, int heigh
 
 //---------------------------------------------------------------------
 
-static double TrueMatrixEpsilon = 0.000001;
-
-// An attempt to reverse tiny rounding errors introduced by QPixmap::trueMatrix()
-// when skewing tests/transforms.png by 45% horizontally (with TransformPixmap()
-// using a QPixmap painter, prior to the 2007-10-09 change -- did not test after
-// the change).
-// Unfortunately, this does not work enough to stop the rendering errors
-// that follow.  But it was worth a try and might still help us given the
-// sometimes excessive aliasing QPainter::draw{Pixmap,Image}() gives us, when
-// QPainter::SmoothPixmapTransform is disabled.
-static double TrueMatrixFixInts (double x)
+// Fills the destination rows of a kpRowBand by nearest-neighbor sampling
+// of the source at the inverse-mapped centre of each destination pixel.
+//
+// Note: Do _not_ be tempted to interpolate here, as the user does not want
+//       their image to get blurier every time they e.g. rotate it.  Being a
+//       pixel-based program, we generally like to preserve RGB values and
+//       avoid unnecessary blurs -- in the worst case, we'd rather drop
+//       pixels, than blur.
+struct NearestNeighborTransformWorker
 {
-    if (fabs (x - qRound (x)) < TrueMatrixEpsilon)
-        return qRound (x);
-    else
-        return x;
-}
+    typedef void result_type;
 
-//---------------------------------------------------------------------
+    const uchar *srcBits;
+    int srcBytesPerLine;
+    int srcWidth, srcHeight;
 
-static QMatrix TrueMatrix (const QMatrix &matrix, int srcPixmapWidth, int srcPixmapHeight)
-{
-    ::MatrixDebug ("TrueMatrix(): org", matrix);
-    
-    const QMatrix truMat = QPixmap::trueMatrix (matrix, srcPixmapWidth, srcPixmapHeight);
-    ::MatrixDebug ("TrueMatrix(): passed through QPixmap::trueMatrix()", truMat);
-
-    const QMatrix retMat (
-        ::TrueMatrixFixInts (truMat.m11 ()),
-        ::TrueMatrixFixInts (truMat.m12 ()),
-        ::TrueMatrixFixInts (truMat.m21 ()),
-        ::TrueMatrixFixInts (truMat.m22 ()),
-        ::TrueMatrixFixInts (truMat.dx ()),
-        ::TrueMatrixFixInts (truMat.dy ()));
-    ::MatrixDebug ("TrueMatrix(): fixed ints", retMat);
-
-    return retMat;
-}
+    uchar *destBits;
+    int destBytesPerLine;
+    int destWidth;
+    // Where the destination's (0,0) lies in the transformed coordinate space.
+    QPoint destOrigin;
+
+    // Maps the transformed coordinate space back to the source.
+    QMatrix inverseMatrix;
+
+    QRgb background;
+
+    void operator() (const kpRowBand &band) const
+    {
+        // Source coordinates are stepped along each destination row in 32.32
+        // fixed point, so that no floating point error can accumulate or
+        // differ between pixels of the same row.
+        const double FixedPointOne = 4294967296.0;
+
+        const qint64 stepX = qRound64 (inverseMatrix.m11 () * FixedPointOne);
+        const qint64 stepY = qRound64 (inverseMatrix.m12 () * FixedPointOne);
+
+        for (int y = band.top; y < band.bottom; y++)
+        {
+            const double mappedX = destOrigin.x () + 0.5;
+            const double mappedY = destOrigin.y () + y + 0.5;
+
+            qint64 fixedX = qint64 (floor ((inverseMatrix.m11 () * mappedX +
+                                            inverseMatrix.m21 () * mappedY +
+                                            inverseMatrix.dx ()) * FixedPointOne));
+            qint64 fixedY = qint64 (floor ((inverseMatrix.m12 () * mappedX +
+                                            inverseMatrix.m22 () * mappedY +
+                                            inverseMatrix.dy ()) * FixedPointOne));
+
+            QRgb *dest = reinterpret_cast <QRgb *> (destBits + y * destBytesPerLine);
+
+            for (int x = 0; x < destWidth; x++)
+            {
+                // (arithmetic shift: floors negative coordinates)
+                const qint64 srcX = fixedX >> 32;
+                const qint64 srcY = fixedY >> 32;
+
+                if (quint64 (srcX) < quint64 (srcWidth) &&
+                    quint64 (srcY) < quint64 (srcHeight))
+                {
+                    dest [x] = reinterpret_cast <const QRgb *> (
+                        srcBits + srcY * srcBytesPerLine) [srcX];
+                }
+                else
+                    dest [x] = background;
+
+                fixedX += stepX;
+                fixedY += stepY;
+            }
+        }
+    }
+};
 
 //---------------------------------------------------------------------
 
 // Like QPixmap::transformed() but fills new areas with <backgroundColor>
-// (unless <backgroundColor> is invalid) and works around internal QMatrix
-// floating point -> integer oddities, that would otherwise give fatally
-// incorrect results.  If you don't believe me on this latter point, compare
+// (unless <backgroundColor> is invalid, in which case they are transparent),
+// never blurs and does not suffer from QMatrix floating point -> integer
+// oddities.  If you don't believe me on this latter point, compare
 // QPixmap::transformed() to us using a flip matrix or a rotate-by-multiple-of-90
 // matrix on tests/transforms.png -- QPixmap::transformed()'s output is 1
 // pixel too high or low depending on whether the matrix is passed through
 // QPixmap::trueMatrix().
 //
+// The source is sampled by NearestNeighborTransformWorker, on multiple
+// threads.
+//
 // Use <targetWidth> and <targetHeight> to specify the intended output size
 // of the pixmap.  -1 if don't care.
 static QImage TransformPixmap (const QImage &pm, const QMatrix &transformMatrix_,
@@ -377,44 +414,8 @@ static QImage TransformPixmap (const QImage &pm, const QMatrix &transformMatrix_
     }
 
 
-    ::MatrixDebug ("TransformPixmap(): before trueMatrix", transformMatrix,
-                   pm.width (), pm.height ());
-#if DEBUG_KP_PIXMAP_FX && 1
-    QMatrix oldMatrix = transformMatrix;
-#endif
-
-    // Translate the matrix to account for Qt rounding errors,
-    // so that flipping (if it used this method) and rotating by a multiple
-    // of 90 degrees actually work as expected (try tests/transforms.png).
-    //
-    // SYNC: This was not required with Qt3 so we are actually working
-    //       around a Qt4 bug/feature.
-    //
-    // COMPAT: Qt4's rendering with a matrix enabled is low quality anyway
-    //         but does this reduce quality even further?
-    //
-    //         With or without it, skews by 45 degrees with the QImage
-    //         painter below look bad (with it, you get an extra transparent
-    //         line on the right; without, you get only about 1/4 of a source
-    //         line on the left).  In Qt3, with TrueMatrix(), the source
-    //         image is translated 1 pixel off the destination image.
-    //
-    //         Also, if you skew a rectangular selection, the skewed selection
-    //         border does not line up with the skewed image data. 
-    // TODO: do we need to pass <newRect> through this new matrix?
-    transformMatrix = ::TrueMatrix (transformMatrix,
-        pm.width (), pm.height ());
-
-#if DEBUG_KP_PIXMAP_FX && 1
-    kDebug () << "trueMatrix changed matrix?" << (oldMatrix == transformMatrix);
-#endif
-    ::MatrixDebug ("TransformPixmap(): after trueMatrix", transformMatrix,
-                   pm.width (), pm.height ());
-
-
-    QImage newQImage (targetWidth > 0 ? targetWidth : newRect.width (),
-                      targetHeight > 0 ? targetHeight : newRect.height (),
-                      QImage::Format_ARGB32_Premultiplied);
+    const int destWidth = targetWidth > 0 ? targetWidth : newRect.width ();
+    const int destHeight = targetHeight > 0 ? targetHeight : newRect.height ();
 
     if ((targetWidth > 0 && targetWidth != newRect.width ()) ||
         (targetHeight > 0 && targetHeight != newRect.height ()))
@@ -429,47 +430,199 @@ static QImage TransformPixmap (const QImage &pm, const QMatrix &transformMatrix_
     #endif
     }
 
+    ::MatrixDebug ("TransformPixmap(): sampling with", transformMatrix,
+                   pm.width (), pm.height ());
 
-#if DEBUG_KP_PIXMAP_FX && 0
-    kDebug () << "\ttranslate top=" << painter.xForm (QPoint (0, 0));
-    kDebug () << "\tmatrix: m11=" << painter.worldMatrix ().m11 ()
-               << " m12=" << painter.worldMatrix ().m12 ()
-               << " m21=" << painter.worldMatrix ().m21 ()
-               << " m22=" << painter.worldMatrix ().m22 ()
-               << " dx=" << painter.worldMatrix ().dx ()
-               << " dy=" << painter.worldMatrix ().dy ()
-               << endl;
+    // Map every destination pixel back to the source instead of drawing
+    // the source with QPainter::setMatrix(): the latter is single-threaded
+    // and, even after QImage::trueMatrix(), shifts or drops lines at some
+    // angles.
+    bool invertible = false;
+    const QMatrix inverseMatrix = transformMatrix.inverted (&invertible);
+    if (!invertible)
+    {
+        qCritical () << "kpPixmapFX.cpp:TransformPixmap() matrix not invertible"
+                     << endl;
+        return pm;
+    }
+
+    QImage srcImage = pm;
+    if (srcImage.format () != QImage::Format_ARGB32_Premultiplied)
+        srcImage = srcImage.convertToFormat (QImage::Format_ARGB32_Premultiplied);
+
+    QImage newQImage (destWidth, destHeight, QImage::Format_ARGB32_Premultiplied);
+    if (newQImage.isNull ())
+        return newQImage;
+
+    NearestNeighborTransformWorker worker;
+    worker.srcBits = srcImage.constBits ();
+    worker.srcBytesPerLine = srcImage.bytesPerLine ();
+    worker.srcWidth = srcImage.width ();
+    worker.srcHeight = srcImage.height ();
+    // (detaches here, on this thread, before the workers start)
+    worker.destBits = newQImage.bits ();
+    worker.destBytesPerLine = newQImage.bytesPerLine ();
+    worker.destWidth = newQImage.width ();
+    worker.destOrigin = newRect.topLeft ();
+    worker.inverseMatrix = inverseMatrix;
+    // Areas that do not come from the source are transparent if there is
+    // no background color.
+    worker.background = backgroundColor.isValid () ?
+        qPremultiply (backgroundColor.toQRgb ()) : 0;
+
+    QList <kpRowBand> bands = kpRowBands::Split (destHeight, 16);
+    QtConcurrent::blockingMap (bands, worker);
+
+#if DEBUG_KP_PIXMAP_FX && 1
+    kDebug () << "Done" << endl << endl;
 #endif
 
+    return newQImage;
+}
+
+//---------------------------------------------------------------------
+
+// Lossless transforms, that only move pixels around.
+enum LosslessTransform
+{
+    LosslessRotate90,
+    LosslessRotate180,
+    LosslessRotate270,
+    LosslessFlipHorz,
+    LosslessFlipVert
+};
+
+// Side length, in pixels, of the square tiles that the rotate by 90/270
+// kernels transpose.  64 * 64 * 4 bytes = 16K, which keeps both the source
+// and destination tiles in the L1 cache.
+static const int LosslessTileSize = 64;
+
+// Applies a LosslessTransform to the destination rows of a kpRowBand.
+// Works on raw 32-bit pixels so that it can be run on worker threads.
+struct LosslessTransformWorker
+{
+    typedef void result_type;
 
-    // Note: Do _not_ use "p.setRenderHints (QPainter::SmoothPixmapTransform);"
-    //       as the user does not want their image to get blurier every
-    //       time they e.g. rotate it (especially important for multiples
-    //       of 90 degrees but also true for every other angle).  Being a
-    //       pixel-based program, we generally like to preserve RGB values
-    //       and avoid unnecessary blurs -- in the worst case, we'd rather
-    //       drop pixels, than blur.
-    QPainter p (&newQImage);
+    LosslessTransform transform;
+
+    const uchar *srcBits;
+    int srcBytesPerLine;
+    int srcWidth, srcHeight;
+
+    uchar *destBits;
+    int destBytesPerLine;
+    int destWidth;
+
+    const quint32 *srcLine (int y) const
+    {
+        return reinterpret_cast <const quint32 *> (srcBits + y * srcBytesPerLine);
+    }
+
+    quint32 *destLine (int y) const
     {
-        // Make sure transparent pixels are drawn into the destination image.
-        p.setCompositionMode (QPainter::CompositionMode_Source);
-    
-        // Fill the entire new image with the background color.
-        if (backgroundColor.isValid ())
+        return reinterpret_cast <quint32 *> (destBits + y * destBytesPerLine);
+    }
+
+    void operator() (const kpRowBand &band) const
+    {
+        switch (transform)
         {
-            p.fillRect (newQImage.rect (), backgroundColor.toQColor ());
+        case LosslessRotate90:
+        case LosslessRotate270:
+            // Transpose tile by tile.  Each destination row is a source
+            // column.
+            for (int by = band.top; by < band.bottom; by += LosslessTileSize)
+            {
+                const int byEnd = qMin (band.bottom, by + LosslessTileSize);
+
+                for (int bx = 0; bx < destWidth; bx += LosslessTileSize)
+                {
+                    const int bxEnd = qMin (destWidth, bx + LosslessTileSize);
+
+                    for (int y = by; y < byEnd; y++)
+                    {
+                        quint32 *dest = destLine (y);
+
+                        if (transform == LosslessRotate90)
+                        {
+                            // dest(x,y) = src(y, srcHeight - 1 - x)
+                            for (int x = bx; x < bxEnd; x++)
+                                dest [x] = srcLine (srcHeight - 1 - x) [y];
+                        }
+                        else
+                        {
+                            // dest(x,y) = src(srcWidth - 1 - y, x)
+                            const int srcX = srcWidth - 1 - y;
+                            for (int x = bx; x < bxEnd; x++)
+                                dest [x] = srcLine (x) [srcX];
+                        }
+                    }
+                }
+            }
+            break;
+
+        case LosslessRotate180:
+        case LosslessFlipHorz:
+            for (int y = band.top; y < band.bottom; y++)
+            {
+                const quint32 *src = srcLine (
+                    transform == LosslessRotate180 ? srcHeight - 1 - y : y);
+                quint32 *dest = destLine (y);
+
+                for (int x = 0; x < destWidth; x++)
+                    dest [x] = src [destWidth - 1 - x];
+            }
+            break;
+
+        case LosslessFlipVert:
+            for (int y = band.top; y < band.bottom; y++)
+            {
+                memcpy (destLine (y), srcLine (srcHeight - 1 - y),
+                        destWidth * sizeof (quint32));
+            }
+            break;
         }
-
-        p.setMatrix (transformMatrix);
-        p.drawImage (QPoint (0, 0), pm);
     }
-    p.end ();
+};
 
-#if DEBUG_KP_PIXMAP_FX && 1
-    kDebug () << "Done" << endl << endl;
-#endif
+//---------------------------------------------------------------------
 
-    return newQImage;
+// Returns <image> with the <transform> applied, without any resampling,
+// or a null image if <image> is not of a 32-bit format.
+static QImage LosslessTransformImage (const QImage &image,
+        LosslessTransform transform)
+{
+    if (image.depth () != 32)
+        return QImage ();
+
+    const bool swapsDimensions = (transform == LosslessRotate90 ||
+                                  transform == LosslessRotate270);
+
+    QImage destImage (swapsDimensions ? image.height () : image.width (),
+                      swapsDimensions ? image.width () : image.height (),
+                      image.format ());
+    if (destImage.isNull ())
+        return QImage ();
+
+    destImage.setDotsPerMeterX (swapsDimensions ? image.dotsPerMeterY () : image.dotsPerMeterX ());
+    destImage.setDotsPerMeterY (swapsDimensions ? image.dotsPerMeterX () : image.dotsPerMeterY ());
+
+    LosslessTransformWorker worker;
+    worker.transform = transform;
+    worker.srcBits = image.constBits ();
+    worker.srcBytesPerLine = image.bytesPerLine ();
+    worker.srcWidth = image.width ();
+    worker.srcHeight = image.height ();
+    // (detaches here, on this thread, before the workers start)
+    worker.destBits = destImage.bits ();
+    worker.destBytesPerLine = destImage.bytesPerLine ();
+    worker.destWidth = destImage.width ();
+
+    QList <kpRowBand> bands = kpRowBands::Split (destImage.height (),
+                                                 LosslessTileSize);
+    QtConcurrent::blockingMap (bands, worker);
+
+    return destImage;
 }
 
 //---------------------------------------------------------------------
@@ -672,6 +825,32 @@ QImage kpPixmapFX::rotate (const QImage &pm, double angle,
         return pm;
     }
 
+    // Multiples of 90 degrees only move pixels around so don't go through
+    // QPainter, which is slow and might be off by a pixel.
+    if (targetWidth <= 0 && targetHeight <= 0 &&
+        kpPixmapFX::isLosslessRotation (angle))
+    {
+        int quarterTurns = qRound (angle / 90.0) % 4;
+        if (quarterTurns < 0)
+            quarterTurns += 4;
+
+        if (quarterTurns == 0)
+            return pm;
+
+        const LosslessTransform transform =
+            (quarterTurns == 1) ? LosslessRotate90 :
+            (quarterTurns == 2) ? LosslessRotate180 :
+                                  LosslessRotate270;
+
+        QImage src = pm;
+        if (src.depth () != 32)
+            src = src.convertToFormat (QImage::Format_ARGB32_Premultiplied);
+
+        const QImage ret = ::LosslessTransformImage (src, transform);
+        if (!ret.isNull ())
+            return ret;
+    }
+
 
     QMatrix matrix = rotateMatrix (pm, angle);
 
@@ -727,6 +906,13 @@ QImage kpPixmapFX::flip (const QImage &img, bool horz, bool vert)
     if (!horz && !vert)
         return img;
 
+    const QImage ret = ::LosslessTransformImage (img,
+        (horz && vert) ? LosslessRotate180 :
+        horz ? LosslessFlipHorz :
+               LosslessFlipVert);
+    if (!ret.isNull ())
+        return ret;
+
     return img.mirrored (horz, vert);
 }
 
@@ -36,6 +36,7 @@
 
 #include <qimage.h>
 #include <qpainter.h>
+#include <qpolygon.h>
 
 #include <qdebug.h>
 #include <qlocale.h>
@@ -291,6 +292,43 @@ void kpToolFlowBase::draw (const QPoint &thisPoint, const QPoint &lastPoint, con
 
 //---------------------------------------------------------------------
 
+// virtual
+bool kpToolFlowBase::drawLines (const QPolygon &, QRect *)
+{
+    return false;
+}
+
+//---------------------------------------------------------------------
+
+// virtual [base kpTool]
+void kpToolFlowBase::drawPolyline (const QPolygon &points)
+{
+    if (!/*virtual*/drawShouldProceed (points.last (), points [points.size () - 2],
+                                       normalizedRect ()))
+    {
+        return;
+    }
+
+    // sync: remember to restoreFastUpdates() in all exit paths
+    viewManager ()->setFastUpdates ();
+
+    QRect dirtyRect;
+    const bool drewLines = drawLines (points, &dirtyRect);
+
+    viewManager ()->restoreFastUpdates ();
+
+    if (!drewLines)
+    {
+        kpTool::drawPolyline (points);
+        return;
+    }
+
+    d->currentCommand->updateBoundingRect (dirtyRect);
+    setUserShapePoints (points.last ());
+}
+
+//---------------------------------------------------------------------
+
 // virtual
 void kpToolFlowBase::cancelShape ()
 {
@@ -37,6 +37,7 @@
 
 
 class QPoint;
+class QPolygon;
 class QString;
 
 class kpColor;
@@ -73,8 +74,15 @@ class kpToolFlowBase : public kpTool
     virtual QRect drawPoint(const QPoint &point);
     virtual QRect drawLine(const QPoint &thisPoint, const QPoint &lastPoint) = 0;
 
+    // Draws the polyline <points> in one go and returns true, setting
+    // <dirtyRect>.  Override if you can do this more efficiently than a
+    // drawLine() per segment (e.g. with a single read and write of the
+    // document).  The default returns false, to draw segment by segment.
+    virtual bool drawLines(const QPolygon &points, QRect *dirtyRect);
+
     virtual bool drawShouldProceed(const QPoint & /*thisPoint*/, const QPoint & /*lastPoint*/, const QRect & /*normalizedRect*/) { return true; }
     virtual void draw(const QPoint &thisPoint, const QPoint &lastPoint, const QRect &normalizedRect);
+    virtual void drawPolyline(const QPolygon &points);
     virtual void cancelShape();
     virtual void releasedAllButtons();
     virtual void endDraw(const QPoint &, const QRect &);
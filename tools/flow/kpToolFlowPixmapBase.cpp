@@ -31,6 +31,7 @@
 #include <kpToolFlowPixmapBase.h>
 
 #include <qbitmap.h>
+#include <qpolygon.h>
 
 #include <kpColor.h>
 #include <kpDocument.h>
@@ -55,7 +56,38 @@ QRect kpToolFlowPixmapBase::drawLine (const QPoint &thisPoint, const QPoint &las
     docRect = neededRect (docRect, qMax (brushWidth (), brushHeight ()));
     kpImage image = document ()->getImageAt (docRect);
 
+    stampLine (&image, docRect.topLeft (), thisPoint, lastPoint);
 
+    document ()->setImageAt (image, docRect.topLeft ());
+    return docRect;
+}
+
+//---------------------------------------------------------------------
+
+// protected virtual [base kpToolFlowBase]
+bool kpToolFlowPixmapBase::drawLines (const QPolygon &points, QRect *dirtyRect)
+{
+    // Read and write the document once for the whole polyline, instead of
+    // once per segment.
+    QRect docRect = points.boundingRect ();
+    docRect = neededRect (docRect, qMax (brushWidth (), brushHeight ()));
+    kpImage image = document ()->getImageAt (docRect);
+
+    for (int i = 1; i < points.size (); i++)
+        stampLine (&image, docRect.topLeft (), points [i], points [i - 1]);
+
+    document ()->setImageAt (image, docRect.topLeft ());
+
+    *dirtyRect = docRect;
+    return true;
+}
+
+//---------------------------------------------------------------------
+
+// private
+void kpToolFlowPixmapBase::stampLine (kpImage *image, const QPoint &imageTopLeft,
+                                      const QPoint &thisPoint, const QPoint &lastPoint)
+{
     QList <QPoint> points = kpPainter::interpolatePoints (lastPoint, thisPoint,
         brushIsDiagonalLine ());
 
@@ -66,7 +98,7 @@ QRect kpToolFlowPixmapBase::drawLine (const QPoint &thisPoint, const QPoint &las
         const QPoint point =
             hotRectForMousePointAndBrushWidthHeight (
                 (*pit), brushWidth (), brushHeight ())
-                    .topLeft () - docRect.topLeft ();
+                    .topLeft () - imageTopLeft;
 
         // OPT: This may be redrawing pixels that were drawn on a previous
         //      iteration, since the brush is usually bigger than 1 pixel.
@@ -76,12 +108,8 @@ QRect kpToolFlowPixmapBase::drawLine (const QPoint &thisPoint, const QPoint &las
         //      Try this at least for the easy case of the Eraser, which has
         //      square, simply-filled brushes.  Profiling needs to be done as
         //      QRegion is known to be a CPU hog.
-        brushDrawFunction () (&image, point, brushDrawFunctionData ());
+        brushDrawFunction () (image, point, brushDrawFunctionData ());
     }
-
-
-    document ()->setImageAt (image, docRect.topLeft ());
-    return docRect;
 }
 
 //---------------------------------------------------------------------
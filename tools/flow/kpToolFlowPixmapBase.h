@@ -52,6 +52,13 @@ public:
 
 protected:
     virtual QRect drawLine (const QPoint &thisPoint, const QPoint &lastPoint);
+    virtual bool drawLines (const QPolygon &points, QRect *dirtyRect);
+
+private:
+    // Stamps the brush along the line from <lastPoint> to <thisPoint> onto
+    // <image>, which holds the document at <imageTopLeft>.
+    void stampLine (kpImage *image, const QPoint &imageTopLeft,
+                    const QPoint &thisPoint, const QPoint &lastPoint);
 };
 
 
@@ -33,6 +33,7 @@
 #include <qapplication.h>
 #include <qbitmap.h>
 #include <qpainter.h>
+#include <qpolygon.h>
 
 #include <qlocale.h>
 #include <tools.h>
@@ -95,3 +96,31 @@ QRect kpToolPen::drawLine (const QPoint &thisPoint, const QPoint &lastPoint)
     return docRect;
 }
 
+//---------------------------------------------------------------------
+
+// protected virtual [base kpToolFlowBase]
+bool kpToolPen::drawLines (const QPolygon &points, QRect *dirtyRect)
+{
+    QRect docRect = points.boundingRect ();
+    docRect = neededRect (docRect, 1/*pen width*/);
+    kpImage image = document ()->getImageAt (docRect);
+
+    const kpColor penColor = color (mouseButton ());
+    for (int i = 1; i < points.size (); i++)
+    {
+        const QPoint sp = points [i - 1] - docRect.topLeft (),
+                     ep = points [i] - docRect.topLeft ();
+
+        kpPainter::drawLine (&image,
+            sp.x (), sp.y (),
+            ep.x (), ep.y (),
+            penColor,
+            1/*pen width*/);
+    }
+
+    document ()->setImageAt (image, docRect.topLeft ());
+
+    *dirtyRect = docRect;
+    return true;
+}
+
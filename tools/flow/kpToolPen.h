@@ -45,6 +45,7 @@ public:
 protected:
     virtual QString haventBegunDrawUserMessage () const;
     virtual QRect drawLine (const QPoint &thisPoint, const QPoint &lastPoint);
+    virtual bool drawLines (const QPolygon &points, QRect *dirtyRect);
 
 private:
     struct kpToolPenPrivate *d;
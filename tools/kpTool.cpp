@@ -41,6 +41,7 @@
 #include <qapplication.h>
 #include <qdebug.h>
 #include <qlocale.h>
+#include <qtimer.h>
 #include <tools.h>
 
 #include <kpColor.h>
@@ -76,6 +77,11 @@ kpTool::kpTool(const QString &text, const QString &description,
 
     d->environ = environ;
 
+    d->strokeFlushTimer = new QTimer(this);
+    d->strokeFlushTimer->setSingleShot(true);
+    d->strokeFlushTimer->setInterval(1000 / 60/*once per frame*/);
+    connect(d->strokeFlushTimer, SIGNAL(timeout()), this, SLOT(flushStrokeSamples()));
+
     setObjectName(name);
     initAction();
 }
@@ -51,6 +51,7 @@ class QInputMethodEvent;
 class QKeyEvent;
 class QMouseEvent;
 class QImage;
+class QPolygon;
 class QWheelEvent;
 class QKeySequence;
 
@@ -141,6 +142,10 @@ public slots:
     // line.  The statubar gets correct coordinates.  etc. etc.
     void somethingBelowTheCursorChanged ();
 
+    // Draws the mouse moves queued while drawing, if any, instead of
+    // waiting for the next frame e.g. before the document is read.
+    void flushStrokeSamples ();
+
 private:
     // Same as above except that you claim you know better than currentPoint()
     void somethingBelowTheCursorChanged (const QPoint &currentPoint_,
@@ -222,6 +227,11 @@ protected:
     virtual bool careAboutModifierState () const { return false; }
     virtual bool careAboutColorsSwapped () const { return false; }
 
+    // While drawing, mouse moves are normally queued and handed to
+    // drawPolyline() once per frame.  Return false if draw() must instead
+    // be called for every mouse move as it happens (e.g. selections).
+    virtual bool coalescesMouseMoves () const { return true; }
+
     virtual void beginDraw ();
 
     // mouse move without button pressed
@@ -232,9 +242,17 @@ protected:
     virtual void draw (const QPoint &thisPoint, const QPoint &lastPoint,
                         const QRect &normalizedRect);
 
+    // Called with the mouse moves queued since the last frame: <points>
+    // runs from the previous lastPoint() to currentPoint() and has at least
+    // 2 points.  The default implementation calls draw() for each segment
+    // in turn.  Reimplement to draw the whole stroke in one go.
+    virtual void drawPolyline (const QPolygon &points);
+
 private:
     void drawInternal ();
 
+    void queueStrokeSample (const QPoint &point, ulong timestamp);
+
 protected:
     // (m_mouseButton will not change from beginDraw())
     virtual void cancelShape ();
@@ -30,6 +30,7 @@
 #define kpToolPrivate_H
 
 
+#include <QList>
 #include <QPoint>
 #include <QPointer>
 
@@ -39,10 +40,20 @@
   #undef environ  // macro on win32
 #endif
 
+class QTimer;
+
 class kpToolAction;
 class kpToolEnvironment;
 
 
+// A mouse move while drawing, queued until the next frame.
+struct kpToolStrokeSample
+{
+    QPoint point;
+    ulong timestamp;  // of the mouse event, in milliseconds
+};
+
+
 struct kpToolPrivate
 {
     // Initialisation / properties.
@@ -63,6 +74,11 @@ struct kpToolPrivate
 
     kpView *viewUnderStartPoint;
 
+    // Mouse moves not yet passed to drawPolyline(), flushed by
+    // <strokeFlushTimer> once per frame.
+    QList <kpToolStrokeSample> strokeSamples;
+    QTimer *strokeFlushTimer;
+
 
     // Set to 2 when the user swaps the foreground and background color.
     //
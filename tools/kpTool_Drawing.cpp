@@ -39,9 +39,12 @@
 #include <kpToolPrivate.h>
 
 #include <qapplication.h>
+#include <qpolygon.h>
+#include <qtimer.h>
 
 #include <qdebug.h>
 
+#include <kpLatencyStats.h>
 #include <kpToolEnvironment.h>
 #include <kpView.h>
 #include <kpViewManager.h>
@@ -304,20 +307,105 @@ void kpTool::draw (const QPoint &, const QPoint &, const QRect &)
 
 //---------------------------------------------------------------------
 
+// virtual
+void kpTool::drawPolyline (const QPolygon &points)
+{
+    // Replay the mouse moves so that currentPoint(), lastPoint() and
+    // normalizedRect() are what draw() would have seen for each of them.
+    for (int i = 1; i < points.size (); i++)
+    {
+        d->lastPoint = points [i - 1];
+        d->currentPoint = points [i];
+
+        draw (d->currentPoint, d->lastPoint, normalizedRect ());
+    }
+}
+
+//---------------------------------------------------------------------
+
 // private
 void kpTool::drawInternal ()
 {
+    kpLatencyTimer latencyTimer (kpLatencyStats::Draw);
+
     draw (d->currentPoint, d->lastPoint, normalizedRect ());
 }
 
 //---------------------------------------------------------------------
 
+// private
+void kpTool::queueStrokeSample (const QPoint &point, ulong timestamp)
+{
+    // Not moving in terms of document pixels (e.g. when zoomed in)?
+    const QPoint previousPoint = d->strokeSamples.isEmpty () ?
+        d->lastPoint : d->strokeSamples.last ().point;
+    if (point == previousPoint)
+        return;
+
+    kpToolStrokeSample sample;
+    sample.point = point;
+    sample.timestamp = timestamp;
+    d->strokeSamples.append (sample);
+
+    if (!d->strokeFlushTimer->isActive ())
+        d->strokeFlushTimer->start ();
+}
+
+//---------------------------------------------------------------------
+
+// public slot
+void kpTool::flushStrokeSamples ()
+{
+    d->strokeFlushTimer->stop ();
+
+    if (d->strokeSamples.isEmpty ())
+        return;
+
+#if DEBUG_KP_TOOL && 1
+    kDebug () << "kpTool::flushStrokeSamples()" << d->strokeSamples.size ()
+              << "samples spanning"
+              << (d->strokeSamples.last ().timestamp - d->strokeSamples.first ().timestamp)
+              << "ms";
+#endif
+
+    QPolygon points;
+    points.reserve (1 + d->strokeSamples.size ());
+    points.append (d->lastPoint);
+    for (QList <kpToolStrokeSample>::const_iterator it = d->strokeSamples.constBegin ();
+         it != d->strokeSamples.constEnd ();
+         ++it)
+    {
+        points.append ((*it).point);
+    }
+
+    d->strokeSamples.clear ();
+
+    if (!d->beganDraw)
+        return;
+
+    // (the caller may have moved on to a later point already)
+    const QPoint currentPoint = d->currentPoint;
+
+    {
+        kpLatencyTimer latencyTimer (kpLatencyStats::Draw);
+        drawPolyline (points);
+    }
+
+    d->currentPoint = currentPoint;
+    d->lastPoint = points.last ();
+}
+
+//---------------------------------------------------------------------
+
 
 // also called by kpView
 void kpTool::cancelShapeInternal ()
 {
     if (hasBegunShape ())
     {
+        d->strokeSamples.clear ();
+        d->strokeFlushTimer->stop ();
+
         d->beganDraw = false;
         cancelShape ();
         d->viewUnderStartPoint = 0;
@@ -368,6 +456,8 @@ void kpTool::endDrawInternal (const QPoint &thisPoint, const QRect &normalizedRe
     else if (!wantEndShape && !hasBegunDraw ())
         return;
 
+    flushStrokeSamples ();
+
     d->beganDraw = false;
 
     if (wantEndShape)
@@ -366,7 +366,10 @@ void kpTool::notifyModifierStateChanged ()
     if (careAboutModifierState ())
     {
         if (d->beganDraw)
+        {
+            flushStrokeSamples ();
             draw (d->currentPoint, d->lastPoint, normalizedRect ());
+        }
         else
         {
             d->currentPoint = calculateCurrentPoint ();
@@ -38,6 +38,7 @@
 
 #include <qdebug.h>
 
+#include <kpLatencyStats.h>
 #include <kpToolEnvironment.h>
 #include <kpView.h>
 #include <kpViewManager.h>
@@ -154,7 +155,10 @@ void kpTool::mousePressEvent (QMouseEvent *e)
 
     beginDrawInternal ();
 
-    draw (d->currentPoint, d->lastPoint, QRect (d->currentPoint, d->currentPoint));
+    {
+        kpLatencyTimer latencyTimer (kpLatencyStats::Draw);
+        draw (d->currentPoint, d->lastPoint, QRect (d->currentPoint, d->currentPoint));
+    }
     d->lastPoint = d->currentPoint;
 }
 
@@ -204,6 +208,16 @@ void kpTool::mouseMoveEvent (QMouseEvent *e)
         bool dragScrolled = false;
         movedAndAboutToDraw (d->currentPoint, d->lastPoint, view->zoomLevelX (), &dragScrolled);
 
+        // Leave the drawing to flushStrokeSamples(), once per frame.
+        if (!dragScrolled && coalescesMouseMoves ())
+        {
+            queueStrokeSample (d->currentPoint, e->timestamp ());
+            return;
+        }
+
+        // Catch up before drawing at this point.
+        flushStrokeSamples ();
+
         if (dragScrolled)
         {
             d->currentPoint = calculateCurrentPoint ();
@@ -261,6 +275,8 @@ void kpTool::mouseReleaseEvent (QMouseEvent *e)
         kpView *view = viewUnderStartPoint ();
         Q_ASSERT (view);
 
+        flushStrokeSamples ();
+
         d->currentPoint = view->transformViewToDoc (e->pos ());
         d->currentViewPoint = e->pos ();
 
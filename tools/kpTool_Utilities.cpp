@@ -159,6 +159,9 @@ void kpTool::somethingBelowTheCursorChanged (const QPoint &currentPoint_,
     kDebug () << "\tbegan draw=" << d->beganDraw;
 #endif
 
+    if (d->beganDraw)
+        flushStrokeSamples ();
+
     d->currentPoint = currentPoint_;
     d->currentViewPoint = currentViewPoint_;
 
@@ -375,6 +375,14 @@ void kpToolPolygonalBase::draw (const QPoint &, const QPoint &, const QRect &)
     }
 }
 
+//---------------------------------------------------------------------
+
+// virtual [base kpTool]
+void kpToolPolygonalBase::drawPolyline (const QPolygon &points)
+{
+    draw (points.last (), points [points.size () - 2], normalizedRect ());
+}
+
 
 // TODO: code dup with kpToolRectangle
 // private
@@ -408,7 +416,7 @@ void kpToolPolygonalBase::updateShape ()
                << endl;
 #endif
 
-    kpImage image = document ()->getImageAt (boundingRect);
+    kpImage image = document ()->getImageViewAt (boundingRect);
 
     QPolygon pointsTranslated = d->points;
     pointsTranslated.translate (-boundingRect.x (), -boundingRect.y ());
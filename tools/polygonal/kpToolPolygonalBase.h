@@ -179,6 +179,9 @@ protected:
     virtual bool drawingALine () const { return true; }
 public:
     virtual void draw (const QPoint &, const QPoint &, const QRect &);
+    // The shape only follows the latest mouse position, so skip the ones
+    // in between.
+    virtual void drawPolyline (const QPolygon &points);
 private:
     kpColor drawingForegroundColor () const;
 protected:
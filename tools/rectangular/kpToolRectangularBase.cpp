@@ -38,6 +38,7 @@
 #include <qevent.h>
 #include <qpainter.h>
 #include <qpixmap.h>
+#include <qpolygon.h>
 
 #include <qdebug.h>
 #include <qlocale.h>
@@ -287,7 +288,7 @@ kpColor kpToolRectangularBase::drawingBackgroundColor () const
 // private
 void kpToolRectangularBase::updateShape ()
 {
-    kpImage image = document ()->getImageAt (d->toolRectangleRect);
+    kpImage image = document ()->getImageViewAt (d->toolRectangleRect);
 
     // Invoke shape drawing function passed in ctor.
     (*d->drawShapeFunc) (&image,
@@ -352,6 +353,14 @@ void kpToolRectangularBase::draw (const QPoint &, const QPoint &, const QRect &)
 
 //---------------------------------------------------------------------
 
+// virtual [base kpTool]
+void kpToolRectangularBase::drawPolyline (const QPolygon &points)
+{
+    draw (points.last (), points [points.size () - 2], normalizedRect ());
+}
+
+//---------------------------------------------------------------------
+
 void kpToolRectangularBase::cancelShape ()
 {
     viewManager ()->invalidateTempImage ();
@@ -35,6 +35,7 @@
 
 
 class QPoint;
+class QPolygon;
 class QRect;
 class QString;
 
@@ -86,6 +87,9 @@ private:
     void updateShape ();
 public:
     virtual void draw (const QPoint &, const QPoint &, const QRect &);
+    // The shape only follows the latest mouse position, so skip the ones
+    // in between.
+    virtual void drawPolyline (const QPolygon &points);
     virtual void cancelShape ();
     virtual void releasedAllButtons ();
     virtual void endDraw (const QPoint &, const QRect &);
@@ -84,45 +84,33 @@ bool kpToolFreeFormSelection::drawCreateMoreSelectionAndUpdateStatusBar (
     Q_ASSERT (accidentalDragAdjustedPoint == currentPoint ());
     Q_ASSERT (dragAccepted == (bool) document ()->selection ());
 
-    const kpFreeFormImageSelection *oldPointsSel = 0;
-    if (document ()->selection ())
-    {
-        kpAbstractSelection *sel = document ()->selection ();
-        Q_ASSERT (dynamic_cast <kpFreeFormImageSelection *> (sel));
-        oldPointsSel = static_cast <kpFreeFormImageSelection *> (sel);
-    }
-
-
-    QPolygon points;
-
     // First point in drag?
     if (!dragAccepted)
     {
+        QPolygon points;
         points.append (startPoint ());
+        points.append (accidentalDragAdjustedPoint);
+
+        document ()->setSelection (
+            kpFreeFormImageSelection (points, environ ()->imageSelectionTransparency ()));
     }
     // Not first point in drag.
     else
     {
-        // Get existing points in selection.
-        points = oldPointsSel->cardinallyAdjacentPoints ();
-    }
-
-
-#if DEBUG_KP_TOOL_FREE_FROM_SELECTION
-    kDebug () << "\tlast old point=" << points.last ();
-#endif
-
-    // TODO: There should be an upper limit on this before drawing the
-    //       polygon becomes too slow.
-    points.append (accidentalDragAdjustedPoint);
-
+        kpAbstractSelection *sel = document ()->selection ();
+        Q_ASSERT (dynamic_cast <kpFreeFormImageSelection *> (sel));
+        kpFreeFormImageSelection *pointsSel =
+            static_cast <kpFreeFormImageSelection *> (sel);
 
-    document ()->setSelection (
-        kpFreeFormImageSelection (points, environ ()->imageSelectionTransparency ()));
+    #if DEBUG_KP_TOOL_FREE_FROM_SELECTION
+        kDebug () << "\tlast old point=" << pointsSel->cardinallyAdjacentPoints ().last ();
+    #endif
 
-    // Prevent accidental usage of dangling pointer to old selection
-    // (deleted by kpDocument::setSelection()).
-    oldPointsSel = 0;
+        // Grow the selection in place, rather than rebuilding it from all
+        // of its points, so that each mouse move costs the same however
+        // long the lasso gets.
+        pointsSel->appendPoint (accidentalDragAdjustedPoint);
+    }
 
 #if DEBUG_KP_TOOL_FREE_FROM_SELECTION && 1
     kDebug () << "\t\tfreeform; #points="
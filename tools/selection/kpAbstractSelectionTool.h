@@ -126,6 +126,10 @@ public:
     // selection.  SHIFT is used for sweeping.
     virtual bool careAboutModifierState () const { return true; }
 
+    // Creating, moving and resizing selections all track every mouse move
+    // (see drawCreateMoreSelectionAndUpdateStatusBar()).
+    virtual bool coalescesMouseMoves () const { return false; }
+
 
 //
 // Drawing - Subclass Accessors
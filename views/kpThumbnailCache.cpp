@@ -0,0 +1,311 @@
+/*
+   Copyright (c) 2015-2018 Maikel Diaz <ariguanabosoft@gmail.com>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#define DEBUG_KP_THUMBNAIL_CACHE 0
+
+
+#include <kpThumbnailCache.h>
+
+#include <qpainter.h>
+#include <qtconcurrentrun.h>
+#include <qvector.h>
+
+#include <qdebug.h>
+
+#include <kpDocument.h>
+
+//---------------------------------------------------------------------
+
+// The most document pixels scaled down by one job.  This bounds both the
+// copy made on the GUI thread and how long a stale job can keep the
+// worker busy after a rebuild().
+static const int BandPixels = 1 << 20;
+
+//---------------------------------------------------------------------
+
+kpThumbnailCache::kpThumbnailCache (kpDocument *document, QObject *parent)
+    : QObject (parent),
+      m_document (document),
+      m_factor (1),
+      m_isComplete (false),
+      m_generation (0),
+      m_jobWatcher (new QFutureWatcher <QImage> (this)),
+      m_jobGeneration (0)
+{
+    connect (m_jobWatcher, SIGNAL (finished ()),
+             this, SLOT (slotJobFinished ()));
+}
+
+//---------------------------------------------------------------------
+
+kpThumbnailCache::~kpThumbnailCache ()
+{
+    // A running job only holds its own copy of the band, so it can
+    // safely finish after we are gone.
+}
+
+//---------------------------------------------------------------------
+
+// public
+kpDocument *kpThumbnailCache::document () const
+{
+    return m_document;
+}
+
+//---------------------------------------------------------------------
+
+// public
+int kpThumbnailCache::factor () const
+{
+    return m_factor;
+}
+
+//---------------------------------------------------------------------
+
+// public
+void kpThumbnailCache::setFactor (int factor)
+{
+    factor = qMax (1, factor);
+    if (factor == m_factor)
+        return;
+
+#if DEBUG_KP_THUMBNAIL_CACHE
+    qDebug () << "kpThumbnailCache::setFactor(" << factor << ")";
+#endif
+
+    m_factor = factor;
+    rebuild ();
+}
+
+//---------------------------------------------------------------------
+
+// public
+bool kpThumbnailCache::isComplete () const
+{
+    return m_isComplete;
+}
+
+//---------------------------------------------------------------------
+
+// public
+const QImage &kpThumbnailCache::image () const
+{
+    return m_image;
+}
+
+//---------------------------------------------------------------------
+
+// public
+QRect kpThumbnailCache::cacheRect (const QRect &docRect) const
+{
+    if (docRect.isEmpty ())
+        return QRect ();
+
+    return QRect (QPoint (docRect.left () / m_factor, docRect.top () / m_factor),
+                  QPoint (docRect.right () / m_factor, docRect.bottom () / m_factor));
+}
+
+//---------------------------------------------------------------------
+
+// public
+QRect kpThumbnailCache::docRect (const QRect &cacheRect) const
+{
+    const QRect rect (cacheRect.x () * m_factor, cacheRect.y () * m_factor,
+                      cacheRect.width () * m_factor, cacheRect.height () * m_factor);
+    return m_document ? rect.intersected (m_document->rect ()) : rect;
+}
+
+//---------------------------------------------------------------------
+
+// public static
+QImage kpThumbnailCache::Downscale (const QImage &imageIn, int factor)
+{
+    QImage image = imageIn;
+    if (image.format () != QImage::Format_ARGB32_Premultiplied)
+        image = image.convertToFormat (QImage::Format_ARGB32_Premultiplied);
+
+    const int srcWidth = image.width (), srcHeight = image.height ();
+    const int width = (srcWidth + factor - 1) / factor,
+              height = (srcHeight + factor - 1) / factor;
+
+    QImage ret (width, height, QImage::Format_ARGB32_Premultiplied);
+    if (ret.isNull ())
+        return ret;
+
+    // Per-channel sums for one row of the result.  Since the channels are
+    // premultiplied, averaging them independently is correct.
+    QVector <quint32> sums (width * 4);
+
+    for (int y = 0; y < height; y++)
+    {
+        sums.fill (0);
+
+        const int srcTop = y * factor,
+                  srcBottom = qMin (srcTop + factor, srcHeight);
+        for (int srcY = srcTop; srcY < srcBottom; srcY++)
+        {
+            const QRgb *src =
+                reinterpret_cast <const QRgb *> (image.constScanLine (srcY));
+            quint32 *sum = sums.data ();
+
+            for (int srcX = 0; srcX < srcWidth; srcX++)
+            {
+                const QRgb pixel = src [srcX];
+                quint32 *s = sum + (srcX / factor) * 4;
+
+                s [0] += qAlpha (pixel);
+                s [1] += qRed (pixel);
+                s [2] += qGreen (pixel);
+                s [3] += qBlue (pixel);
+            }
+        }
+
+        QRgb *dest = reinterpret_cast <QRgb *> (ret.scanLine (y));
+        const quint32 *sum = sums.constData ();
+        for (int x = 0; x < width; x++)
+        {
+            const quint32 count =
+                (qMin ((x + 1) * factor, srcWidth) - x * factor) *
+                (srcBottom - srcTop);
+            const quint32 *s = sum + x * 4;
+
+            dest [x] = qRgba ((s [1] + count / 2) / count,
+                              (s [2] + count / 2) / count,
+                              (s [3] + count / 2) / count,
+                              (s [0] + count / 2) / count);
+        }
+    }
+
+    return ret;
+}
+
+//---------------------------------------------------------------------
+
+// public slot
+void kpThumbnailCache::invalidate (const QRect &docRect)
+{
+    if (m_factor <= 1 || !m_document)
+        return;
+
+    m_dirtyRegion += docRect.intersected (m_document->rect ());
+    startNextJob ();
+}
+
+//---------------------------------------------------------------------
+
+// public slot
+void kpThumbnailCache::rebuild ()
+{
+#if DEBUG_KP_THUMBNAIL_CACHE
+    qDebug () << "kpThumbnailCache::rebuild() factor=" << m_factor;
+#endif
+
+    // Drop the results of any job that is still running.
+    m_generation++;
+
+    m_dirtyRegion = QRegion ();
+    m_isComplete = false;
+
+    if (m_factor <= 1 || !m_document || m_document->rect ().isEmpty ())
+    {
+        m_image = QImage ();
+        return;
+    }
+
+    m_image = QImage (cacheRect (m_document->rect ()).size (),
+                      QImage::Format_ARGB32_Premultiplied);
+    m_dirtyRegion = m_document->rect ();
+
+    startNextJob ();
+}
+
+//---------------------------------------------------------------------
+
+// private
+void kpThumbnailCache::startNextJob ()
+{
+    // One job at a time.
+    if (!m_jobDocRect.isEmpty () || m_dirtyRegion.isEmpty ())
+        return;
+
+    // Scale down whole blocks, so that each cache pixel is averaged from
+    // all of its document pixels, in bands of at most BandPixels.
+    QRect rect = docRect (cacheRect (m_dirtyRegion.rects ().first ()));
+
+    const int bandHeight =
+        qMax (1, BandPixels / (rect.width () * m_factor)) * m_factor;
+    if (rect.height () > bandHeight)
+        rect.setHeight (bandHeight);
+
+    m_dirtyRegion -= rect;
+
+#if DEBUG_KP_THUMBNAIL_CACHE
+    qDebug () << "kpThumbnailCache::startNextJob() rect=" << rect
+              << " dirty left=" << m_dirtyRegion.boundingRect ();
+#endif
+
+    m_jobDocRect = rect;
+    m_jobGeneration = m_generation;
+
+    // (copy the band here, since the document may change while the worker
+    //  runs)
+    m_jobWatcher->setFuture (QtConcurrent::run (&kpThumbnailCache::Downscale,
+        m_document->getImageAt (rect), m_factor));
+}
+
+//---------------------------------------------------------------------
+
+// private slot
+void kpThumbnailCache::slotJobFinished ()
+{
+    const QRect rect = m_jobDocRect;
+    m_jobDocRect = QRect ();
+
+    if (m_jobGeneration == m_generation && !m_image.isNull ())
+    {
+        const QImage band = m_jobWatcher->result ();
+
+        QPainter painter (&m_image);
+        painter.setCompositionMode (QPainter::CompositionMode_Source);
+        painter.drawImage (rect.topLeft () / m_factor, band);
+        painter.end ();
+
+        if (m_isComplete)
+        {
+            emit updated (rect);
+        }
+        else if (m_dirtyRegion.isEmpty ())
+        {
+            m_isComplete = true;
+            emit updated (m_document->rect ());
+        }
+    }
+
+    startNextJob ();
+}
+
+//---------------------------------------------------------------------
@@ -0,0 +1,121 @@
+/*
+   Copyright (c) 2015-2018 Maikel Diaz <ariguanabosoft@gmail.com>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef kpThumbnailCache_H
+#define kpThumbnailCache_H
+
+
+#include <qfuturewatcher.h>
+#include <qimage.h>
+#include <qobject.h>
+#include <qrect.h>
+#include <qregion.h>
+
+
+class kpDocument;
+
+
+//
+// A persistent copy of a document, downscaled by an integer <factor()>,
+// for views that show the whole of a large document (e.g. kpThumbnailView).
+//
+// Each pixel of image() is the average of a <factor()> x <factor()> block
+// of document pixels.  Changes to the document are passed to invalidate()
+// and only the blocks they touch are scaled down again, on a worker
+// thread and in bands of limited size, so that neither the GUI thread nor
+// the memory use ever depend on the size of the whole document.
+//
+// Until every band of a rebuild (see rebuild()) has been scaled,
+// isComplete() returns false and the cache should not be drawn.  After
+// that, image() can be a little behind the document but never blank --
+// updated() is emitted as each band catches up.
+//
+class kpThumbnailCache : public QObject
+{
+Q_OBJECT
+
+public:
+    kpThumbnailCache (kpDocument *document, QObject *parent = 0);
+    virtual ~kpThumbnailCache ();
+
+    kpDocument *document () const;
+
+    int factor () const;
+    // A <factor> of 1 (or less) empties the cache, since it would be no
+    // smaller than the document.
+    void setFactor (int factor);
+
+    bool isComplete () const;
+    const QImage &image () const;
+
+    // Returns the pixels of image() covering <docRect>.
+    QRect cacheRect (const QRect &docRect) const;
+    // Returns the part of the document covered by <cacheRect>.
+    QRect docRect (const QRect &cacheRect) const;
+
+    // Returns <image> scaled down by <factor> using a box filter.
+    // The last row and column average only the pixels that exist.
+    //
+    // This is thread-safe.
+    static QImage Downscale (const QImage &image, int factor);
+
+signals:
+    // Emitted when <docRect> has been brought up to date in image().
+    void updated (const QRect &docRect);
+
+public slots:
+    // Schedules <docRect> to be scaled down again.
+    void invalidate (const QRect &docRect);
+    // Throws away image() and scales down the whole document again
+    // e.g. because its size changed.
+    void rebuild ();
+
+private slots:
+    void slotJobFinished ();
+
+private:
+    void startNextJob ();
+
+    kpDocument *m_document;
+    int m_factor;
+
+    QImage m_image;
+    bool m_isComplete;
+
+    // Document areas still to be scaled down.
+    QRegion m_dirtyRegion;
+
+    // Incremented by rebuild() so that bands scaled before it are dropped.
+    int m_generation;
+
+    QFutureWatcher <QImage> *m_jobWatcher;
+    QRect m_jobDocRect;
+    int m_jobGeneration;
+};
+
+
+#endif  // kpThumbnailCache_H
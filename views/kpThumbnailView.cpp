@@ -0,0 +1,314 @@
+/*
+   Copyright (c) 2015-2018 Maikel Diaz <ariguanabosoft@gmail.com>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#define DEBUG_KP_THUMBNAIL_VIEW 0
+
+
+#include <kpThumbnailView.h>
+
+#include <qpainter.h>
+#include <qregion.h>
+
+#include <qdebug.h>
+#include <tools.h>
+
+#include <kpAbstractSelection.h>
+#include <kpDocument.h>
+#include <kpTempImage.h>
+#include <kpThumbnailCache.h>
+#include <kpViewManager.h>
+#include <kpViewScrollableContainer.h>
+
+//---------------------------------------------------------------------
+
+kpThumbnailView::kpThumbnailView (kpDocument *document,
+        kpToolToolBar *toolToolBar,
+        kpViewManager *viewManager,
+        kpView *buddyView,
+        bool zoomed,
+        QWidget *parent)
+
+    : kpView (document, toolToolBar, viewManager,
+              buddyView,
+              0/*scrollableContainer*/,
+              parent),
+      m_zoomed (zoomed),
+      m_cache (0)
+{
+    if (m_zoomed && document)
+    {
+        m_cache = new kpThumbnailCache (document, this);
+
+        connect (document, SIGNAL (contentsChanged (const QRect &)),
+                 m_cache, SLOT (invalidate (const QRect &)));
+        connect (document, SIGNAL (sizeChanged (int, int)),
+                 m_cache, SLOT (rebuild ()));
+
+        connect (m_cache, SIGNAL (updated (const QRect &)),
+                 this, SLOT (slotCacheUpdated (const QRect &)));
+    }
+
+    if (!m_zoomed && buddyView)
+    {
+        // Follow what the buddy view shows.
+        connect (buddyView, SIGNAL (zoomLevelChanged (int, int)),
+                 this, SLOT (adjustToEnvironment ()));
+        connect (buddyView, SIGNAL (originChanged (const QPoint &)),
+                 this, SLOT (adjustToEnvironment ()));
+        connect (buddyView, SIGNAL (sizeChanged (int, int)),
+                 this, SLOT (adjustToEnvironment ()));
+    }
+
+    adjustToEnvironment ();
+}
+
+//---------------------------------------------------------------------
+
+kpThumbnailView::~kpThumbnailView ()
+{
+}
+
+//---------------------------------------------------------------------
+
+// public
+bool kpThumbnailView::isZoomed () const
+{
+    return m_zoomed;
+}
+
+//---------------------------------------------------------------------
+
+// public
+QString kpThumbnailView::caption () const
+{
+    if (m_zoomed)
+        return i18n ("%1% - Thumbnail", QString::number (zoomLevelX ()));
+    else
+        return i18n ("Unzoomed Mode - Thumbnail");
+}
+
+//---------------------------------------------------------------------
+
+// public slot virtual [base kpView]
+void kpThumbnailView::adjustToEnvironment ()
+{
+    kpDocument *doc = document ();
+    if (!doc || doc->width () <= 0 || doc->height () <= 0)
+        return;
+
+#if DEBUG_KP_THUMBNAIL_VIEW
+    qDebug () << "kpThumbnailView(" << objectName () << ")::adjustToEnvironment()"
+              << " size=" << size ()
+              << " doc=" << doc->width () << "x" << doc->height ();
+#endif
+
+    if (viewManager ())
+        viewManager ()->setQueueUpdates ();
+
+    if (m_zoomed)
+    {
+        int zoomLevel = 100;
+        if (doc->width () > width () || doc->height () > height ())
+        {
+            zoomLevel = qMin (width () * 100 / doc->width (),
+                              height () * 100 / doc->height ());
+        }
+
+        setZoomLevel (zoomLevel, zoomLevel);
+
+        setOrigin (QPoint ((width () - zoomedDocWidth ()) / 2,
+                           (height () - zoomedDocHeight ()) / 2));
+
+        // Keep the cache between 1x and 2x the displayed size, so that it
+        // is only ever scaled down a little when drawn.
+        int factor = 1;
+        while (factor * 2 * zoomLevelX () <= 100)
+            factor *= 2;
+
+        if (m_cache)
+            m_cache->setFactor (factor);
+    }
+    else
+    {
+        setZoomLevel (100, 100);
+
+        QPoint docCenter = doc->rect ().center ();
+
+        if (buddyView () && buddyView ()->scrollableContainer ())
+        {
+            // (the buddy view only covers the visible part of its zoomed
+            //  document -- see updateBuddyViewScrollableContainerRectangle())
+            const QWidget *viewport = buddyView ()->scrollableContainer ()->viewport ();
+            docCenter = buddyView ()->transformViewToDoc (
+                QRect (0, 0,
+                       qMin (buddyView ()->width (), viewport->width ()),
+                       qMin (buddyView ()->height (), viewport->height ()))).center ();
+        }
+
+        int x = width () / 2 - docCenter.x (),
+            y = height () / 2 - docCenter.y ();
+
+        // Don't scroll past the edges of the document.
+        if (doc->width () <= width ())
+            x = (width () - doc->width ()) / 2;
+        else
+            x = qBound (width () - doc->width (), x, 0);
+
+        if (doc->height () <= height ())
+            y = (height () - doc->height ()) / 2;
+        else
+            y = qBound (height () - doc->height (), y, 0);
+
+        setOrigin (QPoint (x, y));
+    }
+
+    if (viewManager ())
+        viewManager ()->restoreQueueUpdates ();
+}
+
+//---------------------------------------------------------------------
+
+// protected virtual [base kpView]
+void kpThumbnailView::resizeEvent (QResizeEvent *e)
+{
+    kpView::resizeEvent (e);
+
+    adjustToEnvironment ();
+}
+
+//---------------------------------------------------------------------
+
+// protected virtual [base kpView]
+void kpThumbnailView::paintEventDrawDoc_Unclipped (const QRect &viewRect)
+{
+    kpViewManager *vm = viewManager ();
+    kpDocument *doc = document ();
+
+    Q_ASSERT (vm);
+    Q_ASSERT (doc);
+
+    const QRect docViewRect = transformDocToView (doc->rect ());
+
+
+    //
+    // Fill around the document, which we are usually bigger than
+    //
+
+    {
+        QPainter painter (this);
+
+        const QRegion around = QRegion (viewRect).subtracted (docViewRect);
+        foreach (const QRect &r, around.rects ())
+            painter.fillRect (r, palette ().color (backgroundRole ()));
+    }
+
+    const QRect clippedViewRect = viewRect.intersected (docViewRect);
+    if (clippedViewRect.isEmpty ())
+        return;
+
+    if (!m_cache || m_cache->factor () <= 1 || !m_cache->isComplete ())
+    {
+        kpView::paintEventDrawDoc_Unclipped (clippedViewRect);
+        return;
+    }
+
+    const QRect docRect = paintEventGetDocRect (clippedViewRect);
+    if (docRect.isEmpty ())
+        return;
+
+
+    QPainter painter (this);
+
+    // (the cache has an alpha channel like the full-resolution image)
+    paintEventDrawCheckerBoard (&painter, clippedViewRect);
+
+    painter.translate (origin ().x (), origin ().y ());
+    painter.scale (double (zoomLevelX ()) / 100.0,
+                   double (zoomLevelY ()) / 100.0);
+    painter.setRenderHint (QPainter::SmoothPixmapTransform, true);
+
+
+    //
+    // Draw the cached document
+    //
+
+    const int factor = m_cache->factor ();
+    const QRect cacheRect = m_cache->cacheRect (docRect);
+    const QRect cacheDocRect = m_cache->docRect (cacheRect);
+
+    // (the last cache pixels of the document may cover less than
+    //  <factor> document pixels)
+    painter.drawImage (QRectF (cacheDocRect),
+        m_cache->image (),
+        QRectF (cacheRect.x (), cacheRect.y (),
+                double (cacheDocRect.width ()) / factor,
+                double (cacheDocRect.height ()) / factor));
+
+
+    //
+    // Draw the selection or temp image, which are not in the cache,
+    // at full resolution
+    //
+
+    QRect overlayDocRect;
+    if (doc->selection ())
+    {
+        overlayDocRect = doc->selection ()->boundingRect ();
+    }
+    else if (vm->tempImage () && vm->tempImage ()->isVisible (vm))
+    {
+        overlayDocRect = vm->tempImage ()->rect ();
+    }
+
+    overlayDocRect = overlayDocRect.intersected (docRect);
+    if (!overlayDocRect.isEmpty ())
+    {
+        QImage overlay = doc->getImageAt (overlayDocRect);
+
+        if (doc->selection ())
+            paintEventDrawSelection (&overlay, overlayDocRect);
+        else
+            paintEventDrawTempImage (&overlay, overlayDocRect);
+
+        painter.drawImage (overlayDocRect, overlay);
+    }
+}
+
+//---------------------------------------------------------------------
+
+// private slot
+void kpThumbnailView::slotCacheUpdated (const QRect &docRect)
+{
+#if DEBUG_KP_THUMBNAIL_VIEW
+    qDebug () << "kpThumbnailView::slotCacheUpdated(" << docRect << ")";
+#endif
+
+    if (viewManager ())
+        viewManager ()->updateView (this, transformDocToView (docRect));
+}
+
+//---------------------------------------------------------------------
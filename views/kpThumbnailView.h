@@ -0,0 +1,102 @@
+/*
+   Copyright (c) 2015-2018 Maikel Diaz <ariguanabosoft@gmail.com>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef kpThumbnailView_H
+#define kpThumbnailView_H
+
+
+#include <kpView.h>
+
+
+class kpThumbnailCache;
+
+
+/**
+ * @short Thumbnail view of a document, watching over its buddy view.
+ *
+ * In zoomed mode, the whole document is zoomed out to fit the view and
+ * centered.  Below 50%, it is drawn from a kpThumbnailCache -- a
+ * persistent downscaled copy of the document that follows
+ * kpDocument::contentsChanged() incrementally -- instead of scaling the
+ * full-resolution document on every update.  Only the selection and the
+ * temporary image, which are not part of the document, are still scaled
+ * from full resolution, and only where they are.
+ *
+ * In unzoomed mode, the document is shown at 100% and the view follows
+ * the part of the document visible in the buddy view.
+ *
+ * Its size is set by its parent (e.g. kpThumbnail), not by the document.
+ */
+class kpThumbnailView : public kpView
+{
+Q_OBJECT
+
+public:
+    kpThumbnailView (kpDocument *document,
+                     kpToolToolBar *toolToolBar,
+                     kpViewManager *viewManager,
+                     kpView *buddyView,
+                     bool zoomed,
+                     QWidget *parent);
+    virtual ~kpThumbnailView ();
+
+
+    bool isZoomed () const;
+
+    /**
+     * @returns the caption to display in an enclosing thumbnail window.
+     */
+    QString caption () const;
+
+
+public slots:
+    /**
+     * Implements @ref kpView.
+     *
+     * Recalculates the zoom level and origin to suit the view size, the
+     * document and, in unzoomed mode, the buddy view.
+     */
+    virtual void adjustToEnvironment ();
+
+
+protected:
+    virtual void resizeEvent (QResizeEvent *e);
+
+    virtual void paintEventDrawDoc_Unclipped (const QRect &viewRect);
+
+
+private slots:
+    void slotCacheUpdated (const QRect &docRect);
+
+
+private:
+    bool m_zoomed;
+    kpThumbnailCache *m_cache;
+};
+
+
+#endif  // kpThumbnailView_H
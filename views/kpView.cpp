@@ -44,7 +44,6 @@
 #include <qpoint.h>
 #include <qrect.h>
 #include <qregion.h>
-#include <QScrollBar>
 
 #include <qdebug.h>
 #include <tools.h>
@@ -227,6 +226,36 @@ void kpView::setOrigin (const QPoint &origin)
     emit originChanged (origin);
 }
 
+// public
+void kpView::scrollOrigin (const QPoint &origin)
+{
+#if DEBUG_KP_VIEW
+    kDebug () << "kpView(" << objectName () << ")::scrollOrigin" << origin;
+#endif
+
+    const QPoint delta = origin - d->origin;
+    if (delta.isNull ())
+        return;
+
+    d->origin = origin;
+
+    kpViewManager *vm = viewManager ();
+
+    // Queued updates are in view coordinates and would be stale after a
+    // blit so just let the whole view be repainted when they are flushed.
+    const bool canBlit = !(vm && vm->queueUpdates ()) &&
+        qAbs (delta.x ()) < width () && qAbs (delta.y ()) < height ();
+
+    if (canBlit)
+        scroll (delta.x (), delta.y ());
+    else if (vm)
+        vm->updateView (this);
+    else
+        update ();
+
+    emit originChanged (origin);
+}
+
 
 // public
 bool kpView::canShowGrid () const
@@ -363,9 +392,10 @@ void kpView::updateBuddyViewScrollableContainerRectangle ()
         if (isBuddyViewScrollableContainerRectangleShown () &&
             buddyViewScrollableContainer () && buddyView ())
         {
+            // (the buddy view only covers the visible part of its zoomed
+            //  document, starting at the top-left of the viewport)
             QRect docRect = buddyView ()->transformViewToDoc (
-                QRect (buddyViewScrollableContainer ()->horizontalScrollBar()->value(),
-                       buddyViewScrollableContainer ()->verticalScrollBar()->value(),
+                QRect (0, 0,
                        qMin (buddyView ()->width (),
                              buddyViewScrollableContainer ()->viewport()->width ()),
                        qMin (buddyView ()->height (),
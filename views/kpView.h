@@ -192,6 +192,18 @@ public:
      */
     virtual void setOrigin (const QPoint &origin);
 
+    /**
+     * Sets the origin like setOrigin() but, instead of repainting the whole
+     * view, scrolls the pixels that are already rendered by the change in
+     * origin so that only the newly exposed strips get repainted.
+     *
+     * This is how kpViewScrollableContainer scrolls its view, which is only
+     * as big as the visible part of the zoomed document.
+     *
+     * @param origin New origin.
+     */
+    void scrollOrigin (const QPoint &origin);
+
 
     /**
      * @returns whether at this zoom level, the grid can be enabled.
@@ -589,7 +601,9 @@ protected:
     // <painter>.
     void paintEventDrawGridLines (QPainter *painter, const QRect &viewRect);
 
-    void paintEventDrawDoc_Unclipped (const QRect &viewRect);
+    // Reimplemented by views that can draw the document more cheaply
+    // (e.g. kpThumbnailView).
+    virtual void paintEventDrawDoc_Unclipped (const QRect &viewRect);
     virtual void paintEvent (QPaintEvent *e);
 
 
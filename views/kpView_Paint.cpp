@@ -38,17 +38,17 @@
 #include <QPainter>
 #include <QPaintEvent>
 #include <QTime>
-#include <QScrollBar>
 
 #include <qdebug.h>
 
 #include <kpAbstractSelection.h>
 #include <kpColor.h>
 #include <kpDocument.h>
+#include <kpLatencyStats.h>
+#include <kpStartupTimes.h>
 #include <kpTempImage.h>
 #include <kpTextSelection.h>
 #include <kpViewManager.h>
-#include <kpViewScrollableContainer.h>
 
 //---------------------------------------------------------------------
 
@@ -177,29 +177,9 @@ void kpView::paintEventDrawCheckerBoard (QPainter *painter, const QRect &viewRec
     if (!doc)
         return;
 
-    QPoint patternOrigin = origin ();
-
-    if (scrollableContainer ())
-    {
-    #if DEBUG_KP_VIEW_RENDERER && 1
-        kDebug () << "\tscrollableContainer: contents[XY]="
-                   << QPoint (scrollableContainer ()->horizontalScrollBar()->value (),
-                              scrollableContainer ()->verticalScrollBar()->value ())
-                   << endl;
-    #endif
-        // Make checkerboard appear static relative to the scroll view.
-        // This makes it more obvious that any visible bits of the
-        // checkboard represent transparent pixels and not gray and white
-        // squares.
-        patternOrigin = QPoint (scrollableContainer ()->horizontalScrollBar()->value(),
-                                scrollableContainer ()->verticalScrollBar()->value());
-    #if DEBUG_KP_VIEW_RENDERER && 1
-        kDebug () << "\t\tpatternOrigin=" << patternOrigin;
-    #endif
-    }
-
-    // TODO: this static business doesn't work yet
-    patternOrigin = QPoint (0, 0);
+    // The pattern moves with the document, since scrolling blits the
+    // already rendered pixels (see scrollOrigin()).
+    const QPoint patternOrigin = origin ();
 
     drawTransparentBackground (painter, patternOrigin, viewRect);
 }
@@ -412,10 +392,16 @@ void kpView::paintEventDrawGridLines (QPainter *painter, const QRect &viewRect)
 
     painter->setPen (ordinaryPen);
 
+    // (grid lines are aligned to document pixels, which start at origin())
+    const QPoint gridOrigin = origin ();
+
     // horizontal lines
     int starty = viewRect.top ();
-    if (starty % vzoomMultiple)
-        starty = (starty + vzoomMultiple) / vzoomMultiple * vzoomMultiple;
+    if ((starty - gridOrigin.y ()) % vzoomMultiple)
+    {
+        starty = gridOrigin.y () +
+            (starty - gridOrigin.y () + vzoomMultiple) / vzoomMultiple * vzoomMultiple;
+    }
 #if 0
     int tileHeight = 16 * vzoomMultiple;  // CONFIG
 #endif
@@ -442,8 +428,11 @@ void kpView::paintEventDrawGridLines (QPainter *painter, const QRect &viewRect)
 
     // vertical lines
     int startx = viewRect.left ();
-    if (startx % hzoomMultiple)
-        startx = (startx + hzoomMultiple) / hzoomMultiple * hzoomMultiple;
+    if ((startx - gridOrigin.x ()) % hzoomMultiple)
+    {
+        startx = gridOrigin.x () +
+            (startx - gridOrigin.x () + hzoomMultiple) / hzoomMultiple * hzoomMultiple;
+    }
 #if 0
     int tileWidth = 16 * hzoomMultiple;  // CONFIG
 #endif
@@ -500,6 +489,8 @@ void kpView::paintEventDrawGridLines (QPainter *painter, const QRect &viewRect)
 // This over-drawing is only safe from Qt's perspective since Qt
 // automatically clips all drawing in paintEvent() (which calls us) to
 // QPaintEvent::region().
+//
+// protected virtual
 void kpView::paintEventDrawDoc_Unclipped (const QRect &viewRect)
 {
 #if DEBUG_KP_VIEW_RENDERER
@@ -532,7 +523,8 @@ void kpView::paintEventDrawDoc_Unclipped (const QRect &viewRect)
     // LOTODO: I think <docRect> being empty would be a bug.
     if (!docRect.isEmpty ())
     {
-        docPixmap = doc->getImageAt (docRect);
+        // Only copied if the selection or temp image is drawn on it below.
+        docPixmap = doc->getImageViewAt (docRect);
 
     #if DEBUG_KP_VIEW_RENDERER && 1
         kDebug () << "\tdocPixmap.hasAlphaChannel()="
@@ -611,6 +603,8 @@ void kpView::paintEventDrawDoc_Unclipped (const QRect &viewRect)
 // protected virtual [base QWidget]
 void kpView::paintEvent (QPaintEvent *e)
 {
+    kpLatencyTimer latencyTimer (kpLatencyStats::Paint);
+
     // sync: kpViewPrivate
     // WARNING: document(), viewManager() and friends might be 0 in this method.
     // TODO: I'm not 100% convinced that we always check if their friends are 0.
@@ -709,6 +703,8 @@ void kpView::paintEvent (QPaintEvent *e)
         paintEventDrawSelectionResizeHandles (e->rect ());
     }
 
+    kpStartupTimes::MarkFirstPaint ();
+
 #if DEBUG_KP_VIEW_RENDERER && 1
     kDebug () << "\tall done in: " << timer.restart () << "ms";
 #endif
@@ -38,6 +38,7 @@
 #include <kpDocument.h>
 #include <kpView.h>
 #include <kpViewManager.h>
+#include <kpViewScrollableContainer.h>
 
 
 kpZoomedView::kpZoomedView (kpDocument *document,
@@ -95,9 +96,17 @@ void kpZoomedView::adjustToEnvironment ()
 
     if (document ())
     {
-        // TODO: use zoomedDocWidth() & zoomedDocHeight()?
-        resize ((int) transformDocToViewX (document ()->width ()),
-                (int) transformDocToViewY (document ()->height ()));
+        if (scrollableContainer () && scrollableContainer ()->view () == this)
+        {
+            // We only cover the visible part of the zoomed document.  The
+            // container sizes us to its viewport and scrolls by moving our
+            // origin(), so it only needs to know the new zoomed size.
+            scrollableContainer ()->updateScrollArea ();
+        }
+        else
+        {
+            resize (zoomedDocWidth (), zoomedDocHeight ());
+        }
     }
 }
 
@@ -40,6 +40,10 @@
  * of the document and the zoom level.  Do not manually call resize() for
  * this reason.
  *
+ * Inside its kpViewScrollableContainer, it is only as big as the visible
+ * part of the zoomed document and the container scrolls it by moving its
+ * origin() instead.
+ *
  * It is suitable as an ordinary editing view.
  *
  * Do not call setOrigin().  REFACTOR: this is bad class design - derived classes should only add functionality - not remove
@@ -78,7 +82,8 @@ public:
 public slots:
     /**
      * Resizes itself so that the entire document in the zoom level fits
-     * almost perfectly.
+     * almost perfectly (or, inside its scrollable container, so that the
+     * visible part of it does).
      *
      * Call this if the size of the document changes.
      * Already called by setZoomLevel().
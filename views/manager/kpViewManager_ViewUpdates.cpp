@@ -42,6 +42,7 @@
 
 #include <kpDefs.h>
 #include <kpDocument.h>
+#include <kpLatencyStats.h>
 #include <kpMainWindow.h>
 #include <kpTempImage.h>
 #include <kpTextSelection.h>
@@ -200,6 +201,8 @@ void kpViewManager::updateViews ()
 // public slot
 void kpViewManager::updateViews (const QRect &docRect)
 {
+    kpLatencyTimer latencyTimer (kpLatencyStats::ViewUpdate);
+
 #if DEBUG_KP_VIEW_MANAGER && 0
     kDebug () << "kpViewManager::updateViews (" << docRect << ")";
 #endif
@@ -213,12 +216,19 @@ void kpViewManager::updateViews (const QRect &docRect)
     #if DEBUG_KP_VIEW_MANAGER && 0
         kDebug () << "\tupdating view " << view->name ();
     #endif
+        // Views may only cover the scrolled-to part of the document so
+        // changes outside of it cost them nothing.
+        const QRect visibleViewRect (0, 0, view->width (), view->height ());
+
         if (view->zoomLevelX () % 100 == 0 && view->zoomLevelY () % 100 == 0)
         {
         #if DEBUG_KP_VIEW_MANAGER && 0
             kDebug () << "\t\tviewRect=" << view->transformDocToView (docRect);
         #endif
-            updateView (view, view->transformDocToView (docRect));
+            const QRect viewRect =
+                view->transformDocToView (docRect).intersected (visibleViewRect);
+            if (!viewRect.isEmpty ())
+                updateView (view, viewRect);
         }
         else
         {
@@ -231,15 +241,16 @@ void kpViewManager::updateViews (const QRect &docRect)
                                    viewRect.width () + 2 * diff,
                                    viewRect.height () + 2 * diff)
                                    #if QT_VERSION >= 0x050000
-                                   .intersected (QRect (0, 0, view->width (), view->height ()));
+                                   .intersected (visibleViewRect);
                                    #else
-                                   .intersect (QRect (0, 0, view->width (), view->height ()));
+                                   .intersect (visibleViewRect);
                                    #endif
 
         #if DEBUG_KP_VIEW_MANAGER && 0
             kDebug () << "\t\tviewRect (+compensate)=" << newRect;
         #endif
-            updateView (view, newRect);
+            if (!newRect.isEmpty ())
+                updateView (view, newRect);
         }
     }
 }
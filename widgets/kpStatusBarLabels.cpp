@@ -71,3 +71,11 @@ void kpStatusBarLabels::setText(int index, const QString & text) {
         l->setText(text);
     }
 }
+
+void kpStatusBarLabels::setToolTip(int index, const QString & text) {
+
+    QLabel *l = map.value(index);
+    if (l) {
+        l->setToolTip(text);
+    }
+}
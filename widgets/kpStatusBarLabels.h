@@ -46,6 +46,7 @@ class kpStatusBarLabels : public QWidget {
         void addLabel(int id, int width);
         //void insertLabel(int index, int id, int width);
         void setText(int index, const QString & text);
+        void setToolTip(int index, const QString & text);
 };
 
 #endif // KPSTATUSBARLABELS_H
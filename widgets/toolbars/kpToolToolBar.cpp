@@ -84,6 +84,12 @@ kpToolToolBar::kpToolToolBar(const QString &name, int colsOrRows, QMainWindow *p
       m_baseWidget (0),
       m_baseLayout (0),
       m_toolLayout (0),
+      m_toolWidgetBrush (0),
+      m_toolWidgetEraserSize (0),
+      m_toolWidgetFillStyle (0),
+      m_toolWidgetLineWidth (0),
+      m_toolWidgetOpaqueOrTransparent (0),
+      m_toolWidgetSpraycanSize (0),
       m_previousTool (0), m_currentTool (0)
 {
 	//setAllowedAreas(Qt::LeftToolBarArea);
@@ -91,26 +97,12 @@ kpToolToolBar::kpToolToolBar(const QString &name, int colsOrRows, QMainWindow *p
 
     m_baseWidget = new QWidget(this);
 
-    m_toolWidgets.append (m_toolWidgetBrush =
-        new kpToolWidgetBrush (m_baseWidget, "Tool Widget Brush"));
-    m_toolWidgets.append (m_toolWidgetEraserSize =
-        new kpToolWidgetEraserSize (m_baseWidget, "Tool Widget Eraser Size"));
-    m_toolWidgets.append (m_toolWidgetFillStyle =
-        new kpToolWidgetFillStyle (m_baseWidget, "Tool Widget Fill Style"));
-    m_toolWidgets.append (m_toolWidgetLineWidth =
-        new kpToolWidgetLineWidth (m_baseWidget, "Tool Widget Line Width"));
-    m_toolWidgets.append (m_toolWidgetOpaqueOrTransparent =
-        new kpToolWidgetOpaqueOrTransparent (m_baseWidget, "Tool Widget Opaque/Transparent"));
-    m_toolWidgets.append (m_toolWidgetSpraycanSize =
-        new kpToolWidgetSpraycanSize (m_baseWidget, "Tool Widget Spraycan Size"));
+    adjustToOrientation(orientation());
 
-    foreach(kpToolWidgetBase *w, m_toolWidgets)
-    {
-      connect(w, SIGNAL(optionSelected(int, int)),
-              this, SIGNAL(toolWidgetOptionSelected()));
-    }
+    // (the others are created on demand)
+    addToolWidget (m_toolWidgetOpaqueOrTransparent =
+        new kpToolWidgetOpaqueOrTransparent (m_baseWidget, "Tool Widget Opaque/Transparent"));
 
-    adjustToOrientation(orientation());
     connect(this, SIGNAL(orientationChanged(Qt::Orientation)),
             this, SLOT(adjustToOrientation(Qt::Orientation)));
 
@@ -264,6 +256,76 @@ void kpToolToolBar::hideAllToolWidgets ()
 
 //---------------------------------------------------------------------
 
+// public
+kpToolWidgetBrush *kpToolToolBar::toolWidgetBrush ()
+{
+    if (!m_toolWidgetBrush)
+    {
+        addToolWidget (m_toolWidgetBrush =
+            new kpToolWidgetBrush (m_baseWidget, "Tool Widget Brush"));
+    }
+
+    return m_toolWidgetBrush;
+}
+
+//---------------------------------------------------------------------
+
+// public
+kpToolWidgetEraserSize *kpToolToolBar::toolWidgetEraserSize ()
+{
+    if (!m_toolWidgetEraserSize)
+    {
+        addToolWidget (m_toolWidgetEraserSize =
+            new kpToolWidgetEraserSize (m_baseWidget, "Tool Widget Eraser Size"));
+    }
+
+    return m_toolWidgetEraserSize;
+}
+
+//---------------------------------------------------------------------
+
+// public
+kpToolWidgetFillStyle *kpToolToolBar::toolWidgetFillStyle ()
+{
+    if (!m_toolWidgetFillStyle)
+    {
+        addToolWidget (m_toolWidgetFillStyle =
+            new kpToolWidgetFillStyle (m_baseWidget, "Tool Widget Fill Style"));
+    }
+
+    return m_toolWidgetFillStyle;
+}
+
+//---------------------------------------------------------------------
+
+// public
+kpToolWidgetLineWidth *kpToolToolBar::toolWidgetLineWidth ()
+{
+    if (!m_toolWidgetLineWidth)
+    {
+        addToolWidget (m_toolWidgetLineWidth =
+            new kpToolWidgetLineWidth (m_baseWidget, "Tool Widget Line Width"));
+    }
+
+    return m_toolWidgetLineWidth;
+}
+
+//---------------------------------------------------------------------
+
+// public
+kpToolWidgetSpraycanSize *kpToolToolBar::toolWidgetSpraycanSize ()
+{
+    if (!m_toolWidgetSpraycanSize)
+    {
+        addToolWidget (m_toolWidgetSpraycanSize =
+            new kpToolWidgetSpraycanSize (m_baseWidget, "Tool Widget Spraycan Size"));
+    }
+
+    return m_toolWidgetSpraycanSize;
+}
+
+//---------------------------------------------------------------------
+
 // public
 kpToolWidgetBase *kpToolToolBar::shownToolWidget (int which) const
 {
@@ -425,6 +487,42 @@ void kpToolToolBar::adjustSizeConstraint()
 
 //---------------------------------------------------------------------
 
+// private
+void kpToolToolBar::addToolWidget (kpToolWidgetBase *toolWidget)
+{
+    // Keep the creation order from mattering: shownToolWidget(), and
+    // so the tool option group shortcuts, go by this order.
+    kpToolWidgetBase * const toolWidgets [] =
+    {
+        m_toolWidgetBrush,
+        m_toolWidgetEraserSize,
+        m_toolWidgetFillStyle,
+        m_toolWidgetLineWidth,
+        m_toolWidgetOpaqueOrTransparent,
+        m_toolWidgetSpraycanSize
+    };
+
+    m_toolWidgets.clear ();
+    for (int i = 0; i < int (sizeof (toolWidgets) / sizeof (toolWidgets [0])); i++)
+    {
+        if (toolWidgets [i])
+            m_toolWidgets.append (toolWidgets [i]);
+    }
+
+    connect (toolWidget, SIGNAL (optionSelected (int, int)),
+             this, SIGNAL (toolWidgetOptionSelected ()));
+
+    toolWidget->hide ();
+
+    // (after m_toolLayout)
+    m_baseLayout->insertWidget (1 + m_toolWidgets.indexOf (toolWidget),
+        toolWidget,
+        0/*stretch*/,
+        orientation () == Qt::Vertical ? Qt::AlignHCenter : Qt::AlignVCenter);
+}
+
+//---------------------------------------------------------------------
+
 // private
 void kpToolToolBar::addButton(QAbstractButton *button, Qt::Orientation o, int num)
 {
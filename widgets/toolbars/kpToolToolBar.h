@@ -74,12 +74,17 @@ public:
 
     void hideAllToolWidgets ();
     // could this be cleaner (the tools have to access them individually somehow)?
-    kpToolWidgetBrush *toolWidgetBrush () const { return m_toolWidgetBrush; }
-    kpToolWidgetEraserSize *toolWidgetEraserSize () const { return m_toolWidgetEraserSize; }
-    kpToolWidgetFillStyle *toolWidgetFillStyle () const { return m_toolWidgetFillStyle; }
-    kpToolWidgetLineWidth *toolWidgetLineWidth () const { return m_toolWidgetLineWidth; }
+    //
+    // Apart from the Opaque/Transparent widget, which the main window needs
+    // from the start, these are only created when first asked for (usually
+    // by kpTool::begin()), since rendering their option pixmaps is a
+    // noticeable part of startup.  They are created hidden.
+    kpToolWidgetBrush *toolWidgetBrush ();
+    kpToolWidgetEraserSize *toolWidgetEraserSize ();
+    kpToolWidgetFillStyle *toolWidgetFillStyle ();
+    kpToolWidgetLineWidth *toolWidgetLineWidth ();
     kpToolWidgetOpaqueOrTransparent *toolWidgetOpaqueOrTransparent () const { return m_toolWidgetOpaqueOrTransparent; }
-    kpToolWidgetSpraycanSize *toolWidgetSpraycanSize () const { return m_toolWidgetSpraycanSize; }
+    kpToolWidgetSpraycanSize *toolWidgetSpraycanSize ();
 
     kpToolWidgetBase *shownToolWidget (int which) const;
 
@@ -98,6 +103,7 @@ private slots:
 
 private:
     void addButton (QAbstractButton *button, Qt::Orientation o, int num);
+    void addToolWidget (kpToolWidgetBase *toolWidget);
     void adjustSizeConstraint();
 
     int m_vertCols;
@@ -114,6 +120,7 @@ private:
     kpToolWidgetOpaqueOrTransparent *m_toolWidgetOpaqueOrTransparent;
     kpToolWidgetSpraycanSize *m_toolWidgetSpraycanSize;
 
+    // The tool widgets created so far, in the order above.
     QList<kpToolWidgetBase *> m_toolWidgets;
 
     QList<kpToolButton *> m_toolButtons;